@@ -70,3 +70,54 @@
 #endif
 
 #include <GL/freeglut.h> // Free GLUT moderno
+
+#include "util.hpp"
+
+
+/* Clear Open GL Error codes stack. */
+inline void GLClearError()
+{
+	while (glGetError() != GL_NO_ERROR);
+}
+
+
+/* Logs every Open GL error code accumulated. */
+inline bool GLLogCall(const std::source_location location = std::source_location::current())
+{
+	bool out = true;
+	while (GLenum error = glGetError()) {
+		print_located<logging::Level::ERR>("OpenGL Error", location, "Error Code: %d", (int)error);
+		out = false;
+	}
+	return out;
+}
+
+
+#ifdef _DEBUG
+	class GLDebugScope {
+	public:
+		GLDebugScope(const std::source_location loc = std::source_location::current())
+			: location(loc) {
+			GLClearError();
+		}
+		~GLDebugScope() {
+			GLLogCall(location);
+		}
+
+		operator bool() { return true; }
+
+	private:
+		std::source_location location;
+	};
+
+	/* Macro de Debug para chamadas OpenGL */
+	#define GLdebug() if (GLDebugScope _gl_debug_scope = GLDebugScope())
+	// Usa o escopo temporário para realizar as chamadas no construtor/destrutor com RAII
+
+	// Prefira a versão escopada acima
+	//#define GLCall(GL) GLClearError(); GL; GLLogCall()
+#else
+	// Macro de Debug para chamadas OpenGL
+	#define GLdebug() if (false); else
+	//#define GLCall(GL) GL
+#endif // _DEBUG
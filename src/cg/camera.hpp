@@ -0,0 +1,109 @@
+﻿#pragma once
+/* Câmera 2D do Canvas: posição (centro da janela no mundo) e zoom.
+ * Substitui a projeção fixa do `gluOrtho2D`: a conversão tela <-> mundo e a área visível vêm daqui.
+ */
+
+#include <algorithm>
+
+#include "math.hpp"
+
+
+namespace cg {
+
+    class Camera {
+    public:
+        static constexpr float MIN_ZOOM = 1.0f / 1024.0f;
+        static constexpr float MAX_ZOOM = 1024.0f;
+        static constexpr float ZOOM_STEP = 1.125f; // por passo da roda do mouse
+
+        Camera() { update(); }
+
+        inline void setViewportSize(Vector2 size) {
+            viewportSize = size;
+            update();
+        }
+        inline Vector2 getViewportSize() const {
+            return viewportSize;
+        }
+
+        // Ponto do mundo no centro da janela.
+        inline void setPosition(Vector2 to) {
+            position = to;
+            update();
+        }
+        inline Vector2 getPosition() const {
+            return position;
+        }
+
+        // Pixels por unidade do mundo.
+        inline void setZoom(float to) {
+            zoom = std::clamp(to, MIN_ZOOM, MAX_ZOOM);
+            update();
+        }
+        inline float getZoom() const {
+            return zoom;
+        }
+
+        /* Arrasta o mundo junto com o cursor (deslocamento em pixels de tela). */
+        inline void pan(Vector2 screen_delta) {
+            setPosition(position + Vector2{ -screen_delta.x, screen_delta.y } / zoom);
+        }
+
+        /* Aplica o zoom mantendo fixo o ponto do mundo sob `screen_point`. */
+        inline void zoomAt(Vector2 screen_point, float factor) {
+            Vector2 anchor = screenToWorld(screen_point);
+            setZoom(zoom * factor);
+            setPosition(position + anchor - screenToWorld(screen_point));
+        }
+
+        inline void reset() {
+            position = {};
+            zoom = 1.0f;
+            update();
+        }
+
+        inline Vector2 screenToWorld(Vector2 point) const {
+            return _screenToWorld * point;
+        }
+        inline Vector2 worldToScreen(Vector2 point) const {
+            return _worldToScreen * point;
+        }
+
+        // Tela (pixels, y para baixo) -> mundo
+        inline const Transform2D& getScreenToWorld() const {
+            return _screenToWorld;
+        }
+        // Mundo -> tela (pixels, y para baixo)
+        inline const Transform2D& getWorldToScreen() const {
+            return _worldToScreen;
+        }
+
+        // Área do mundo coberta pela janela.
+        inline Rect2 getVisibleRect() const {
+            Vector2 half = viewportSize / (2.0f * zoom);
+            return { position - half, position + half };
+        }
+
+    private:
+        inline void update() {
+            Vector2 half = viewportSize / 2.0f;
+            _screenToWorld = {
+                { 1.0f / zoom, 0.0f },
+                { 0.0f, -1.0f / zoom },
+                { position.x - half.x / zoom, position.y + half.y / zoom },
+            };
+            _worldToScreen = {
+                { zoom, 0.0f },
+                { 0.0f, -zoom },
+                { half.x - position.x * zoom, half.y + position.y * zoom },
+            };
+        }
+
+        Vector2 viewportSize{};
+        Vector2 position{};
+        float zoom = 1.0f;
+        Transform2D _screenToWorld;
+        Transform2D _worldToScreen;
+    };
+
+} // namespace cg
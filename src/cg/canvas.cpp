@@ -1,5 +1,18 @@
 ﻿#include "canvas.hpp"
 
+#include <cmath>
+#include <sstream>
+#include <iterator>
+#include <string_view>
+
+#include "render_backend.hpp"
+#include "thread_pool.hpp"
+#include "tools/select_tool.hpp"
+#include "canvas_itens/point.hpp"
+#include "canvas_itens/line.hpp"
+#include "canvas_itens/polygon.hpp"
+#include "canvas_itens/text.hpp"
+
 
 namespace cg {
 
@@ -16,11 +29,517 @@ namespace cg {
 		return now; // próximo lastTime
 	}
 
+	size_t Canvas::dispatchInput()
+	{
+		if (recorder)
+			recorder->recordFrame(); // fecha o grupo de eventos deste quadro
+		return input.dispatch([this](auto& event) {
+			using Event = std::decay_t<decltype(event)>;
+			latency.markInput(event.timestamp); // será exibido na próxima troca de buffers
+
+			if constexpr (std::is_base_of_v<io::InputEvent, Event>) {
+				// A posição chega em pixels de tela: os controles da câmera a usam assim
+				if (captureViewInput(event))
+					return;
+
+				// Converte para o mundo com a câmera atual (já atualizada pelos eventos anteriores)
+				event.position = screenToWorld(event.position);
+			}
+			toolBox.captureInput(event);
+		});
+	}
+
+	bool Canvas::captureViewInput(const io::MouseMiddleButtonPressed& input_event)
+	{
+		isPanning = true;
+		lastPanPosition = input_event.position;
+		return true;
+	}
+
+	bool Canvas::captureViewInput(const io::MouseMiddleButtonReleased& input_event)
+	{
+		isPanning = false;
+		return true;
+	}
+
+	bool Canvas::captureViewInput(const io::MouseDrag& input_event)
+	{
+		if (!isPanning)
+			return false;
+		panView(input_event.position - lastPanPosition);
+		lastPanPosition = input_event.position;
+		return true;
+	}
+
+	bool Canvas::captureViewInput(const io::MouseWheelV& input_event)
+	{
+		zoomView(input_event.position, std::pow(Camera::ZOOM_STEP, (float)input_event.direction));
+		return true;
+	}
+
+	void Canvas::panView(Vector2 screen_delta)
+	{
+		camera.pan(screen_delta);
+		toolBox._reshape(*this); // guias acompanham a área visível
+	}
+
+	void Canvas::zoomView(Vector2 screen_point, float factor)
+	{
+		camera.zoomAt(screen_point, factor);
+		toolBox._reshape(*this);
+	}
+
+	void Canvas::resetView()
+	{
+		camera.reset();
+		toolBox._reshape(*this);
+	}
+
+	void Canvas::setView(Vector2 center, float zoom)
+	{
+		camera.setPosition(center);
+		camera.setZoom(zoom);
+		toolBox._reshape(*this);
+	}
+
 	void Canvas::updateRender()
 	{
-		for (auto& item : itens)
-			item->_render();
+		RenderBackend& backend = RenderBackend::current();
+		backend.setProjection(camera.getWorldToScreen(), windowSize);
+		backend.setPixelsPerUnit(camera.getZoom());
+		++frame;
+		if (useTileCache)
+			renderCached();
+		else if (useStaticLayer)
+			renderLayered();
+		else
+			renderItems(camera.getVisibleRect());
 		toolBox._render();
+		backend.flush();
+	}
+
+	void Canvas::refreshIndex()
+	{
+		for (CanvasItem* item : dirtyItems) {
+			item->isQueued = false;
+			if (useTileCache) {
+				// Sai das imagens dos blocos (invalida onde estava) e passa a ser desenhado por cima
+				if (!item->isLive) {
+					tiles.invalidate(item->tileBounds, item->getStrokeSize() / 2.0f + 1.0f);
+					item->isLive = true;
+					liveItems.push_back(item);
+				}
+				item->lastChange = frame;
+			}
+			if (item != layerSelection)
+				isLayerValid = false;
+			grid.update(item, item->getBounds());
+			pyramid.update(item, item->id, item->getBounds(), item->getOverviewColor(), item->getStrokeSize());
+
+			// Folgas globais: traço em pixels e tolerância de seleção no sistema local (ver `_isSelected`)
+			float stroke = item->getStrokeSize();
+			Vector2 scale = item->model.getScale();
+			maxStrokeSize = std::max(maxStrokeSize, stroke);
+			maxPickMargin = std::max(maxPickMargin, (CanvasItem::SELECTION_THRESHOLD + stroke) * std::max(std::abs(scale.x), std::abs(scale.y)));
+		}
+		dirtyItems.clear();
+	}
+
+	void Canvas::queryItems(const Rect2& area, std::vector<CanvasItem*>& out) const
+	{
+		out.clear();
+		grid.query(area, out);
+		std::sort(out.begin(), out.end(), Compare{});
+		out.erase(std::unique(out.begin(), out.end()), out.end());
+	}
+
+	void Canvas::renderItems(const Rect2& area, bool static_only)
+	{
+		refreshIndex();
+
+		// Traços têm tamanho fixo em pixels: a área cresce metade do maior traço
+		const Rect2 view = area.grown((maxStrokeSize / 2.0f + 1.0f) / camera.getZoom());
+		visibleCount = 0;
+
+		// Itens grandes recortam a própria geometria à mesma área (ver `ClipCache`)
+		RenderBackend& backend = RenderBackend::current();
+		const Rect2 previousClip = backend.getClipRect();
+		backend.setClipRect(view);
+
+		candidates.clear();
+		aggregateCount = 0;
+		const int level = LodPyramid::levelFor(backend.getPixelsPerUnit());
+		const bool isOverview = level >= 0 && view.isFinite();
+		if (isOverview) {
+			// Visão geral: itens menores que um pixel viram os pontos dos agregados da pirâmide
+			aggregates.clear();
+			pyramid.query(view, level, candidates, aggregates);
+			for (const auto& aggregate : aggregates)
+				for (const LodPyramid::Batch& batch : aggregate->batches)
+					backend.draw(Primitive::POINTS, std::span{ aggregate->points }.subspan(batch.first, batch.count),
+						batch.color, batch.size);
+			aggregateCount = aggregates.size();
+		}
+		else
+			grid.query(view, candidates);
+
+		if (!isOverview && candidates.size() >= itens.size()) {
+			// Quase tudo visível: percorre em ordem, sem ordenar os candidatos
+			candidates.clear();
+			for (auto& item : itens)
+				candidates.push_back(item.get());
+		}
+		else {
+			std::sort(candidates.begin(), candidates.end(), Compare{});
+			candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+		}
+
+		if (useParallelPrep && candidates.size() >= PARALLEL_MIN_ITEMS && ThreadPool::shared().getThreadCount() > 0)
+			renderParallel(view, static_only);
+		else
+			for (CanvasItem* item : candidates)
+				if (!(static_only && item->isLive) && item->getBounds().intersects(view)) {
+					item->_render();
+					++visibleCount;
+				}
+		backend.setClipRect(previousClip);
+	}
+
+	void Canvas::renderParallel(const Rect2& view, bool static_only)
+	{
+		RenderBackend& backend = RenderBackend::current();
+		const size_t chunks = (candidates.size() + PARALLEL_GRAIN - 1) / PARALLEL_GRAIN;
+		while (preparations.size() < chunks)
+			preparations.push_back(std::make_unique<Preparation>());
+
+		// Fase de CPU: descarte, LOD, transformação e recorte de cada bloco, em paralelo.
+		// Cada item fica num só bloco, então os caches dele (limites, malhas) são tocados por uma thread.
+		const Rect2 clip = backend.getClipRect();
+		const float pixelsPerUnit = backend.getPixelsPerUnit();
+		ThreadPool::shared().parallelFor(chunks, 1, [&](size_t begin, size_t end) {
+			for (size_t chunk = begin; chunk < end; ++chunk) {
+				Preparation& preparation = *preparations[chunk];
+				RecordingBackend& recording = preparation.recording;
+				recording.clear();
+				recording.isPretransformed = true;
+				recording.setClipRect(clip);
+				recording.setPixelsPerUnit(pixelsPerUnit);
+				preparation.deferred.clear();
+				preparation.visibleCount = 0;
+
+				ScopedBackend scope{ recording };
+				const size_t last = std::min(candidates.size(), (chunk + 1) * PARALLEL_GRAIN);
+				for (size_t i = chunk * PARALLEL_GRAIN; i < last; ++i) {
+					CanvasItem* item = candidates[i];
+					if ((static_only && item->isLive) || !item->getBounds().intersects(view))
+						continue;
+					if (item->isRenderThreadSafe())
+						item->_render();
+					else
+						preparation.deferred.push_back({ item, recording.commands.size() });
+					++preparation.visibleCount;
+				}
+			}
+		});
+
+		// Fase do backend: só envia os vértices gravados, na ordem dos itens
+		for (size_t chunk = 0; chunk < chunks; ++chunk) {
+			const Preparation& preparation = *preparations[chunk];
+			size_t replayed = 0;
+			for (const Preparation::Deferred& deferred : preparation.deferred) {
+				preparation.recording.replay(backend, replayed, deferred.command);
+				deferred.item->_render();
+				replayed = deferred.command;
+			}
+			preparation.recording.replay(backend, replayed, preparation.recording.commands.size());
+			visibleCount += preparation.visibleCount;
+		}
+	}
+
+	void Canvas::setTileCacheEnabled(bool enabled)
+	{
+		if (enabled == useTileCache)
+			return;
+		if (enabled)
+			setStaticLayerEnabled(false);
+		useTileCache = enabled;
+		tiles.clear(RenderBackend::current());
+		liveItems.clear();
+		for (auto& item : itens) {
+			item->isLive = false;
+			item->tileBounds = item->getBounds();
+		}
+		if (!enabled)
+			tileBackend.reset();
+	}
+
+	void Canvas::renderCached()
+	{
+		refreshIndex();
+		RenderBackend& backend = RenderBackend::current();
+
+		// Itens sem mudanças há LIVE_FRAMES quadros voltam para as imagens
+		for (size_t i = 0; i < liveItems.size();) {
+			CanvasItem* item = liveItems[i];
+			if (frame - item->lastChange < TileCache::LIVE_FRAMES) {
+				++i;
+				continue;
+			}
+			item->isLive = false;
+			item->tileBounds = item->getBounds();
+			tiles.invalidate(item->tileBounds, item->getStrokeSize() / 2.0f + 1.0f);
+			liveItems[i] = liveItems.back();
+			liveItems.pop_back();
+		}
+
+		// Blocos da vista: imagem em cache, rasterizada agora (até o limite do quadro) ou desenho direto.
+		// Os blocos ainda sem imagem são desenhados juntos, numa só passada sobre a área que os envolve
+		// (por bloco, cada item seria desenhado uma vez por bloco que toca, vazando sobre os vizinhos).
+		const float zoom = camera.getZoom();
+		const Rect2 visible = camera.getVisibleRect();
+		const TileCache::Grid grid = TileCache::gridOf(camera.getWorldToScreen());
+		std::int32_t x0, y0, x1, y1;
+		TileCache::tileRange(grid, visible, x0, y0, x1, y1);
+		int baked = 0;
+		Rect2 uncached;
+		for (std::int32_t y = y0; y <= y1; ++y)
+			for (std::int32_t x = x0; x <= x1; ++x) {
+				TileCache::Tile& tile = tiles.acquire(grid, x, y, frame, backend);
+				if (!tile.isValid && baked < TileCache::BAKES_PER_FRAME) {
+					bakeTile(tile, x, y);
+					++baked;
+				}
+				if (tile.isValid)
+					backend.drawImage(tile.image, tile.area);
+				else {
+					uncached.expand(tile.area.min);
+					uncached.expand(tile.area.max);
+				}
+			}
+		size_t drawn = 0;
+		if (!uncached.isEmpty()) {
+			renderItems(uncached, true);
+			drawn = visibleCount;
+		}
+
+		// Alterados recentemente, por cima, em ordem de id
+		const Rect2 view = visible.grown((maxStrokeSize / 2.0f + 1.0f) / zoom);
+		candidates.clear();
+		for (CanvasItem* item : liveItems)
+			if (item->getBounds().intersects(view))
+				candidates.push_back(item);
+		std::sort(candidates.begin(), candidates.end(), Compare{});
+
+		const Rect2 previousClip = backend.getClipRect();
+		backend.setClipRect(view);
+		for (CanvasItem* item : candidates)
+			item->_render();
+		backend.setClipRect(previousClip);
+		visibleCount = drawn + candidates.size();
+	}
+
+	void Canvas::bakeTile(TileCache::Tile& tile, std::int32_t x, std::int32_t y)
+	{
+		if (!tileBackend)
+			tileBackend = std::make_unique<SoftwareBackend>(TileCache::TILE_SIZE, TileCache::TILE_SIZE);
+		SoftwareBackend& target = *tileBackend;
+		{
+			ScopedBackend scope{ target };
+			target.setView(TileCache::tileView(tile.grid, x, y));
+			target.setPixelsPerUnit(tile.grid.zoom);
+			target.clear(background);
+			renderItems(tile.area, true);
+			target.flush();
+		}
+		std::copy(target.getPixels(), target.getPixels() + tile.image.pixels.size(), tile.image.pixels.begin());
+		++tile.image.revision;
+		tile.isValid = true;
+	}
+
+	void Canvas::setStaticLayerEnabled(bool enabled)
+	{
+		if (enabled == useStaticLayer)
+			return;
+		if (enabled)
+			setTileCacheEnabled(false);
+		useStaticLayer = enabled;
+		isLayerValid = false;
+		if (layerSelection)
+			layerSelection->isLive = false;
+		layerSelection = nullptr;
+		if (!enabled)
+			RenderBackend::current().releaseImage(layer.id);
+	}
+
+	void Canvas::renderLayered()
+	{
+		RenderBackend& backend = RenderBackend::current();
+
+		// O item selecionado sai da camada (e o anterior volta para ela)
+		CanvasItem* selected = toolBox.getSelectorTool().getSelected();
+		if (selected != layerSelection) {
+			if (layerSelection)
+				layerSelection->isLive = false;
+			if (selected)
+				selected->isLive = true;
+			layerSelection = selected;
+			isLayerValid = false;
+		}
+		refreshIndex(); // invalida a camada se outro item mudou
+
+		const Rect2 visible = camera.getVisibleRect();
+		if (visible.min != layerArea.min || visible.max != layerArea.max)
+			isLayerValid = false;
+
+		if (isLayerValid)
+			backend.drawImage(layer, visible);
+		else {
+			// O destino já foi limpo com o fundo: desenha e copia como está
+			renderItems(visible, true);
+			layerCount = visibleCount;
+			layerArea = visible;
+			isLayerValid = backend.captureImage(layer);
+		}
+		visibleCount = layerCount;
+
+		if (layerSelection) {
+			const Rect2 view = visible.grown((maxStrokeSize / 2.0f + 1.0f) / camera.getZoom());
+			if (layerSelection->getBounds().intersects(view)) {
+				const Rect2 previousClip = backend.getClipRect();
+				backend.setClipRect(view);
+				layerSelection->_render();
+				backend.setClipRect(previousClip);
+				++visibleCount;
+			}
+		}
+	}
+
+	void Canvas::waitOverview()
+	{
+		refreshIndex();
+		pyramid.waitIdle();
+	}
+
+	CanvasItem* Canvas::pick(Vector2 mouse_position)
+	{
+		refreshIndex();
+
+		queryItems(Rect2{ mouse_position, mouse_position }.grown(maxPickMargin), candidates);
+		for (auto it = candidates.rbegin(); it != candidates.rend(); ++it) {
+			CanvasItem* item = *it;
+			if (item->getBounds().grown(maxPickMargin).contains(mouse_position) && item->isSelected(mouse_position))
+				return item;
+		}
+		return nullptr;
+	}
+
+	void Canvas::save(std::ostream& os) const
+	{
+		for (auto& item : itens)
+			os << *item << '\n';
+	}
+
+	// Lê os itens até o fim do stream; falha (com a mensagem) no primeiro item malformado.
+	static bool read_items(std::istream& is, std::vector<std::unique_ptr<CanvasItem>>& out)
+	{
+		while (!is.eof()) {
+			std::string word = peek_word(is);
+			if (word == "Point") {
+				Point point;
+				if (!(is >> point)) {
+					print_error("Failed to deserialize point.");
+					return false;
+				}
+				out.push_back(std::make_unique<Point>(point));
+			}
+			else if (word == "Line") {
+				Line line;
+				if (!(is >> line)) {
+					print_error("Failed to deserialize line.");
+					return false;
+				}
+				out.push_back(std::make_unique<Line>(line));
+			}
+			else if (word == "Polygon") {
+				Polygon polygon;
+				if (!(is >> polygon)) {
+					print_error("Failed to deserialize polygon.");
+					return false;
+				}
+				out.push_back(std::make_unique<Polygon>(polygon));
+			}
+			else if (word == "Text") {
+				Text text;
+				if (!(is >> text)) {
+					print_error("Failed to deserialize text.");
+					return false;
+				}
+				out.push_back(std::make_unique<Text>(text));
+			}
+			else if (word.empty()) {
+				break;
+			}
+			else {
+				print_warning("Invalid file format. Expected 'Point', 'Line', 'Polygon' or 'Text' but got '%s', continuing...", word.c_str());
+				is >> word; // descarta a palavra, senão o laço não avança
+			}
+		}
+		return true;
+	}
+
+	bool Canvas::load(std::istream& is)
+	{
+		const std::string data{ std::istreambuf_iterator<char>{ is }, std::istreambuf_iterator<char>{} };
+
+		// Linha que começa um item (os textos são de uma linha, então não quebram o arquivo ao meio)
+		auto isItemStart = [&data](size_t at) {
+			for (std::string_view keyword : { "Point ", "Line ", "Polygon ", "Text " })
+				if (data.compare(at, keyword.size(), keyword) == 0)
+					return true;
+			return false;
+		};
+
+		struct Chunk {
+			size_t begin, end;
+			std::vector<std::unique_ptr<CanvasItem>> items;
+			bool isValid = false;
+		};
+		std::vector<Chunk> chunks;
+		const size_t count = std::max<size_t>(1, data.size() / LOAD_CHUNK_BYTES);
+		size_t begin = 0;
+		for (size_t i = 1; i < count && begin < data.size(); ++i) {
+			size_t end = data.find('\n', std::max(begin, i * data.size() / count));
+			while (end != std::string::npos && !isItemStart(end + 1))
+				end = data.find('\n', end + 1);
+			if (end == std::string::npos)
+				break;
+			chunks.push_back({ begin, end + 1, {}, false });
+			begin = end + 1;
+		}
+		chunks.push_back({ begin, data.size(), {}, false });
+
+		// Leitura e limites de cada trecho num job; a inserção (ids e índices) fica nesta thread.
+		// A tesselação fica para o primeiro desenho, e só dos polígonos visíveis.
+		ThreadPool::shared().parallelFor(chunks.size(), 1, [&](size_t first, size_t last) {
+			for (size_t i = first; i < last; ++i) {
+				Chunk& chunk = chunks[i];
+				std::istringstream iss{ data.substr(chunk.begin, chunk.end - chunk.begin) };
+				chunk.isValid = read_items(iss, chunk.items);
+				for (auto& item : chunk.items)
+					if (item->isRenderThreadSafe()) // o texto mede os glifos no `TextEngine`
+						item->getBounds();
+			}
+		});
+
+		for (Chunk& chunk : chunks)
+			if (!chunk.isValid) {
+				clear();
+				return false;
+			}
+		for (Chunk& chunk : chunks)
+			for (auto& item : chunk.items)
+				insert(std::move(item));
+		return true;
 	}
 
 	CanvasItem* Canvas::hitTest(float mx, float my)
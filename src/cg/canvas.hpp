@@ -8,15 +8,22 @@
 
 #include "util.hpp"
 #include "math.hpp"
+#include "profiler.hpp"
 
 #include "input_event.hpp"
+#include "input_queue.hpp"
+#include "input_record.hpp"
 #include "tool_box.hpp"
 
+#include "camera.hpp"
+#include "spatial_grid.hpp"
+#include "lod_pyramid.hpp"
+#include "tile_cache.hpp"
+#include "software_backend.hpp"
 #include "canvas_item.hpp"
 
 
 namespace cg {
-    using TimePoint = std::chrono::steady_clock::time_point;
 
     class Canvas {
     public:
@@ -26,35 +33,58 @@ namespace cg {
          }
 
         /** Send a screen input at screen coordinate.
-         * Converts Screen Coordinates to World Coordinates before trigger.
+         * The event is queued and only reaches the tools on the next `dispatchInput` call,
+         * where Screen Coordinates are converted to World Coordinates with the camera of that moment.
+         * Live input is ignored while a recorded session is being replayed.
          */
         template <typename IE> requires std::is_base_of_v<io::InputEvent, IE>
         inline void sendScreenInput(int x, int y) {
-            Vector2 position = screenToWorld(x, y);
-            IE input_event{ position };
-            toolBox.captureInput(input_event);
+            if (isReplaying)
+                return;
+            if (recorder)
+                recorder->record<IE>(x, y);
+            queueScreenInput<IE>(x, y);
         }
 
         template <typename IE> requires std::is_base_of_v<io::InputEvent, IE>
         inline void sendScreenInput(int x, int y, int direction) {
-            Vector2 position = screenToWorld(x, y);
-            IE input_event{ position, direction };
-            toolBox.captureInput(input_event);
+            if (isReplaying)
+                return;
+            if (recorder)
+                recorder->record<IE>(x, y, direction);
+            queueScreenInput<IE>(x, y, direction);
         }
 
 		template <typename KIE> requires std::is_base_of_v<io::KeyInputEvent, KIE>
         inline void sendScreenInput(int x, int y, int key, int mods) {
-            Vector2 position = screenToWorld(x, y);
-            KIE input_event{ position, key, mods };
-            toolBox.captureInput(input_event);
+            if (isReplaying)
+                return;
+            if (recorder)
+                recorder->record<KIE>(x, y, key, mods);
+            queueScreenInput<KIE>(x, y, key, mods);
         }
 
 		template <typename FIE> requires std::is_base_of_v<io::FocusInputEvent, FIE>
         inline void sendScreenInput() {
-            FIE input_event;
-            toolBox.captureInput(input_event);
+            if (isReplaying)
+                return;
+            if (recorder)
+                recorder->record<FIE>();
+            input.push(FIE{});
         }
 
+        /* Queues an input event at screen coordinate without recording it (used by the replayer). */
+        template <typename IE, typename... Args> requires std::is_base_of_v<io::InputEvent, IE>
+        inline void queueScreenInput(int x, int y, Args... args) {
+            input.push(IE{ Vector2{ (float)x, (float)y }, args... });
+        }
+
+        /** Dispatches the queued input events to the tool box (call once per frame, before rendering).
+         * Motion events were already coalesced by the queue, so the work is bounded per frame.
+         * Camera controls (middle button pan, wheel zoom) are handled here and do not reach the tools.
+         */
+        size_t dispatchInput();
+
         /* Propagates user input to a Canvas Item on the canvas. */
         template <typename IE> requires std::is_base_of_v<io::InputEvent, IE>
         inline void sendInput(IE input_event) {
@@ -64,9 +94,63 @@ namespace cg {
         /* Propagates a process call to each Canvas Item on the canvas. */
         TimePoint updateProcess(TimePoint lastTime);
 
-        /* Propagates a render call to each Canvas Item on the canvas. */
+        /** Propagates a render call to each visible Canvas Item on the canvas.
+         * Sets the camera projection on the current backend; items outside the view are culled.
+         */
         void updateRender();
 
+        /** Renders only the canvas items whose world bounds touch `area`,
+         * without tools, guides or GUI (used by image export).
+         */
+        inline void renderItems(const Rect2& area) {
+            renderItems(area, false);
+        }
+        inline void renderItems() {
+            renderItems(Rect2::infinite());
+        }
+
+        /** Liga o cache de blocos do conteúdo estático (ver `TileCache`).
+         * Com ele, cada quadro compõe imagens dos itens que não mudaram e desenha por cima só os alterados
+         * recentemente; os blocos são rasterizados em CPU, até TileCache::BAKES_PER_FRAME por quadro.
+         */
+        void setTileCacheEnabled(bool enabled);
+        inline bool isTileCacheEnabled() const {
+            return useTileCache;
+        }
+
+        /** Liga a camada estática, alternativa mais simples ao cache de blocos (que é desligado).
+         * Todos os itens, menos o selecionado, são desenhados uma vez e copiados do destino (`RenderBackend::captureImage`);
+         * os quadros seguintes desenham a cópia e, por cima, só o item selecionado e as ferramentas.
+         * A camada é refeita quando outro item muda, a seleção troca ou a câmera se move.
+         */
+        void setStaticLayerEnabled(bool enabled);
+        inline bool isStaticLayerEnabled() const {
+            return useStaticLayer;
+        }
+
+        /** Liga a preparação paralela dos itens visíveis (a partir de PARALLEL_MIN_ITEMS, com `ThreadPool::shared`).
+         * Blocos de PARALLEL_GRAIN itens são descartados e desenhados, cada um numa thread, num `RecordingBackend`
+         * que guarda os vértices já no mundo; depois a thread de desenho só os reenvia, na ordem dos itens.
+         * Itens fora de `CanvasItem::isRenderThreadSafe` (texto) são desenhados na reprodução, na sua vez.
+         */
+        inline void setParallelPrepEnabled(bool enabled) {
+            useParallelPrep = enabled;
+        }
+        inline bool isParallelPrepEnabled() const {
+            return useParallelPrep;
+        }
+
+        static constexpr size_t PARALLEL_MIN_ITEMS = 1024;
+        static constexpr size_t PARALLEL_GRAIN = 128;
+
+        // Blocos em cache e itens desenhados por cima deles.
+        inline size_t getTileCount() const {
+            return tiles.size();
+        }
+        inline size_t getLiveCount() const {
+            return liveItems.size();
+        }
+
         inline void insert(std::unique_ptr<CanvasItem> item) {
             item->id = ++CanvasItem::last_id;
 
@@ -74,9 +158,19 @@ namespace cg {
             if ((int)item->getTypeInfo() < (int)CanvasItem::TypeInfo::OTHER)
 			    typeCount[(int)item->getTypeInfo()]++;
 
+            item->owner = this;
+            invalidate(item.get()); // será indexado no próximo quadro
             itens.insert(std::move(item));
         }
 
+        /* Schedules the item to be re-indexed (its geometry or model changed). Called by `CanvasItem::invalidate`. */
+        inline void invalidate(CanvasItem* item) {
+            if (item->isQueued)
+                return;
+            item->isQueued = true;
+            dirtyItems.push_back(item);
+        }
+
         inline void remove(CanvasItem* item) {
             warn(itens.empty(), "Can't remove from empty Canvas!");
 
@@ -95,21 +189,29 @@ namespace cg {
                 // Caso contrário apenas ignoramos,
                 // podemos re-preencher os ids depois com a função normalizeIds
 
+            grid.remove(item);
+            pyramid.remove(item);
+            if (item == layerSelection)
+                layerSelection = nullptr; // já estava fora da camada
+            else
+                isLayerValid = false;
+            if (useTileCache) {
+                if (item->isLive)
+                    liveItems.erase(std::find(liveItems.begin(), liveItems.end(), item));
+                else
+                    tiles.invalidate(item->tileBounds, item->getStrokeSize() / 2.0f + 1.0f);
+            }
+            if (item->isQueued)
+                dirtyItems.erase(std::find(dirtyItems.begin(), dirtyItems.end(), item));
+
             itens.erase(found);
             // aqui o unique_ptr é destruído e liberado do Canvas
         }
 
-        /** Retorna o primeiro item encontrado na posição passada.
-         * Se não for encontrado, retorna `nullptr`
+        /** Retorna o primeiro item encontrado na posição passada (o mais acima).
+         * Se não for encontrado, retorna `nullptr`. Só testa os itens das células do índice espacial sob o cursor.
          */
-        CanvasItem* pick(Vector2 mouse_position) {
-            for (auto it = itens.rbegin(); it != itens.rend(); ++it) {
-                const auto& item = *it;
-                if (item->isSelected(mouse_position))
-                    return item.get();
-            }
-            return nullptr;
-        }
+        CanvasItem* pick(Vector2 mouse_position);
 
         inline Vector2 getWindowSize() const {
             return windowSize;
@@ -130,11 +232,9 @@ namespace cg {
         // Update coordinate system
         inline void setWindowSize(Vector2 to) {
             windowSize = to;
-            _screenToWorld = {
-                { 1.0f, 0.0f },
-                { 0.0f, -1.0f },
-                { -windowSize.x / 2.0f, windowSize.y / 2.0f },
-			};
+            if (recorder)
+                recorder->recordWindow(to);
+            camera.setViewportSize(to);
             /*_screenToNdc = {
                 { 2.0f / windowSize.x, 0.0f },
                 { 0.0f, -2.0f / windowSize.y },
@@ -157,12 +257,37 @@ namespace cg {
 
         // Changes screen coordinates to World Coordinates system.
         inline Vector2 screenToWorld(Vector2 point) const {
-			return _screenToWorld.transform(point);
+			return camera.screenToWorld(point);
         }
         inline Vector2 screenToWorld(int x, int y) const {
-            return _screenToWorld.transform(x, y);
+            return camera.screenToWorld(Vector2{ (float)x, (float)y });
+        }
+
+        inline const Camera& getCamera() const {
+            return camera;
+        }
+
+        /* Arrasta a vista em pixels de tela (botão do meio). */
+        void panView(Vector2 screen_delta);
+        /* Zoom de `factor` mantendo fixo o ponto sob `screen_point` (roda do mouse). */
+        void zoomView(Vector2 screen_point, float factor);
+        void resetView();
+        /* Centraliza a vista em `center` (mundo) com o zoom dado. */
+        void setView(Vector2 center, float zoom);
+
+        // Itens desenhados no último `updateRender` (após o descarte).
+        inline size_t getVisibleCount() const {
+            return visibleCount;
+        }
+
+        // Nós da pirâmide de detalhe desenhados como pontos no último `updateRender` (visão geral).
+        inline size_t getAggregateCount() const {
+            return aggregateCount;
         }
 
+        /* Indexa os itens pendentes e espera a pirâmide de detalhe terminar de ser construída. */
+        void waitOverview();
+
         inline size_t getTypeCount(CanvasItem::TypeInfo of_type) {
 			return typeCount[(int)of_type];
         }
@@ -170,8 +295,14 @@ namespace cg {
         inline void clear() {
             // WARNING -> Cuidado, clear pode remover ferramentas internas além das primitivas!
             itens.clear();
-            for (int i = 0; i < 3; ++i) // reset typeCount
-				typeCount[i] = 0;
+            grid.clear();
+            pyramid.clear();
+            tiles.clear(RenderBackend::current());
+            liveItems.clear();
+            layerSelection = nullptr;
+            isLayerValid = false;
+            dirtyItems.clear();
+            std::fill(std::begin(typeCount), std::end(typeCount), 0); // reset typeCount
         }
 
     public:
@@ -195,19 +326,98 @@ namespace cg {
             return itens;
         }
 
+        /* Writes every serializable item, one per line (.cgp text format). */
+        void save(std::ostream& os) const;
+
+        /** Appends the items read from a .cgp stream.
+         * Large files are split at item lines (LOAD_CHUNK_BYTES each) and parsed, with their bounds,
+         * in parallel by `ThreadPool::shared`; tessellation waits for the first draw. Items keep the file order.
+         * On a malformed item the canvas is cleared and `false` is returned.
+         */
+        bool load(std::istream& is);
+
+        static constexpr size_t LOAD_CHUNK_BYTES = size_t(1) << 18;
+
         // WATCH
         CanvasItem *hitTest(float mx, float my);
 
+    private:
+        // Controles da câmera; retornam `true` se consumiram o evento.
+        template <typename IE>
+        inline bool captureViewInput(const IE& input_event) { return false; }
+        bool captureViewInput(const io::MouseMiddleButtonPressed& input_event);
+        bool captureViewInput(const io::MouseMiddleButtonReleased& input_event);
+        bool captureViewInput(const io::MouseDrag& input_event);
+        bool captureViewInput(const io::MouseWheelV& input_event);
+
+        /* Reindexa os itens alterados desde o último quadro. */
+        void refreshIndex();
+        /* Desenha os itens que tocam `area` (só os fora de `liveItems`, se `static_only`). */
+        void renderItems(const Rect2& area, bool static_only);
+        /* Desenha `candidates` preparando os blocos no pool e reproduzindo as gravações nesta thread. */
+        void renderParallel(const Rect2& view, bool static_only);
+        /* Quadro com o cache de blocos: imagens dos itens estáticos e os alterados por cima. */
+        void renderCached();
+        void bakeTile(TileCache::Tile& tile, std::int32_t x, std::int32_t y);
+        /* Quadro com a camada estática: cópia dos itens fora da seleção e o selecionado por cima. */
+        void renderLayered();
+        /* Candidatos de `grid` em `area`, sem repetições e em ordem de id (z-index). */
+        void queryItems(const Rect2& area, std::vector<CanvasItem*>& out) const;
+
     private:
         std::set<std::unique_ptr<CanvasItem>, Compare> itens;
 
         Vector2 windowSize; // aspect ratio: 10:7
-		Transform2D _screenToWorld; // Screen coordinates to World coordinates
+        Camera camera; // Screen coordinates <-> World coordinates
         //Transform2D _screenToNdc; // Screen coordinates to Normalized Display Coordinates
         //Transform2D _ndcToScreen; // Normalized Display Coordinates to Screen Coordinates
 
-        size_t typeCount[3];
+        SpatialGrid grid; // limites de mundo dos itens, para descarte e seleção
+        LodPyramid pyramid; // agregados para a visão geral (zoom distante)
+        std::vector<CanvasItem*> dirtyItems; // itens a reindexar
+        float maxStrokeSize = 0.0f; // maior traço (pixels) já indexado
+        float maxPickMargin = 0.0f; // maior tolerância de seleção (mundo) já indexada
+        std::vector<CanvasItem*> candidates; // memória reaproveitada entre consultas
+        std::vector<std::shared_ptr<const LodPyramid::Aggregate>> aggregates;
+        size_t visibleCount = 0;
+        size_t aggregateCount = 0;
+
+        // Gravação de um bloco de `candidates` (reaproveitada entre quadros)
+        struct Preparation {
+            struct Deferred {
+                CanvasItem* item;
+                size_t command; // desenhado antes deste comando da gravação
+            };
+            RecordingBackend recording;
+            std::vector<Deferred> deferred; // itens desenhados na reprodução
+            size_t visibleCount = 0;
+        };
+        std::vector<std::unique_ptr<Preparation>> preparations;
+        bool useParallelPrep = true;
+
+        TileCache tiles;
+        bool useTileCache = false;
+        std::vector<CanvasItem*> liveItems; // alterados nos últimos TileCache::LIVE_FRAMES quadros
+        std::unique_ptr<SoftwareBackend> tileBackend; // rasteriza os blocos
+        std::uint64_t frame = 0;
+
+        Image layer; // itens fora de `layerSelection`, vistos de `layerArea`
+        Rect2 layerArea; // área visível na captura (posição, zoom e tamanho da janela)
+        CanvasItem* layerSelection = nullptr; // fora da camada (marcado como `isLive`), desenhado a cada quadro
+        size_t layerCount = 0; // itens desenhados na camada
+        bool useStaticLayer = false;
+        bool isLayerValid = false;
+
+        bool isPanning = false;
+        Vector2 lastPanPosition; // tela
+
+        size_t typeCount[(size_t)CanvasItem::TypeInfo::OTHER]{};
     public:
+        InputQueue input;
+        Color background{ 0.1333f, 0.1333f, 0.1333f, 0.0f }; // cor de fundo da janela (também dos blocos em cache)
+        InputRecorder* recorder = nullptr; // grava a entrada ao vivo, se definido
+        bool isReplaying = false; // a entrada vem de um InputReplayer
+        profiler::LatencyTracker latency; // entrada -> troca de buffers (alimentado pelo `dispatchInput`)
         ToolBox toolBox;
     };
 
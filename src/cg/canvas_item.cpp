@@ -1,4 +1,5 @@
 #include "canvas_item.hpp"
+#include "canvas.hpp"
 
 namespace cg {
 
@@ -9,4 +10,11 @@ namespace cg {
     std::istream& operator>>(std::istream& is, CanvasItem& item) {
         return item._deserialize(is);
     }
+
+    void CanvasItem::invalidate() {
+        isBoundsDirty = true;
+        ++revision;
+        if (owner)
+            owner->invalidate(this);
+    }
 }
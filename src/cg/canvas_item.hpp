@@ -19,6 +19,7 @@ namespace cg {
             POINT = 0,
             LINE,
             POLYGON,
+            TEXT,
             OTHER,
         };
     public:
@@ -55,9 +56,35 @@ namespace cg {
         /* Draw data onto screen with open GL calls. */
         virtual void _render() {}
 
+        /* Se `_render` pode rodar fora da thread de desenho, gravando num backend próprio (ver `Canvas::renderItems`). */
+        virtual bool isRenderThreadSafe() const { return true; }
+
         /* Reshape/ resize window event. Use canvas.getWindowSize to update the geometry. */
         virtual void _reshape(Canvas& canvas) {}
 
+        /** Limites da geometria no sistema local (sem a largura do traço).
+         * O padrão cobre todo o plano, então itens que não o sobrescrevem nunca são descartados.
+         */
+        virtual Rect2 getLocalBounds() const { return Rect2::infinite(); }
+
+        // Tamanho do traço (ponto ou linha) em pixels de tela, somado aos limites no descarte.
+        virtual float getStrokeSize() const { return 0.0f; }
+
+        // Cor que representa o item na visão geral, quando ele ocupa menos de um pixel (ver `LodPyramid`).
+        virtual Color getOverviewColor() const { return Color{ 1.0f, 1.0f, 1.0f }; }
+
+        /* Limites de mundo (cache, refeito após `invalidate`). */
+        inline const Rect2& getBounds() const {
+            if (isBoundsDirty) {
+                bounds = getLocalBounds().transformed(model);
+                isBoundsDirty = false;
+            }
+            return bounds;
+        }
+
+        // Muda a cada `invalidate` (caches derivados da geometria comparam a revisão).
+        inline std::uint32_t getRevision() const { return revision; }
+
         // verificar se mouse está dentro do item
         inline bool isSelected(Vector2 mouse_position) const { return _isSelected(toLocal(mouse_position)); }
 
@@ -67,30 +94,37 @@ namespace cg {
     public:
         virtual inline void translate(Vec2Offset by) {
             model.translate(by);
+            invalidate();
 		}
 
         virtual inline void rotate(Angle by) {
             model.rotate(by);
+            invalidate();
         }
 
         virtual inline void scale(Vector2 by) {
             model.scale(by);
+            invalidate();
         }
 
 		void mirror(Transform2D::Mirror<float> at) {
 			model.mirror(at);
+			invalidate();
 		}
 
 		void shear(float x_angle, float y_angle) {
 			model.shear(x_angle, y_angle);
+			invalidate();
 		}
 
         inline void translateTo(Vector2 to) {
             model.translateTo(to);
+            invalidate();
 		}
 
         inline void rotateTo(float angle) {
             model.rotateTo(angle);
+            invalidate();
         }
 
         inline TypeInfo getTypeInfo() const {
@@ -125,6 +159,22 @@ namespace cg {
         inline void noSerialize() {
             typeInfo = TypeInfo::OTHER;
         }
+
+        /** Chame após mudar a geometria ou a matriz de modelo:
+         * descarta os limites em cache e avisa o Canvas dono para reindexar o item.
+         */
+        void invalidate();
+
 		Transform2D model{}; // Model transformation matrix
+    private:
+        Canvas* owner = nullptr; // Canvas onde o item foi inserido
+        mutable Rect2 bounds; // limites de mundo em cache
+        mutable bool isBoundsDirty = true;
+        std::uint32_t revision = 0;
+        bool isQueued = false; // já está na lista de itens a reindexar do Canvas
+        // Cache de blocos do Canvas (ver `TileCache`) e camada estática
+        bool isLive = false; // alterado recentemente ou selecionado: desenhado por cima das imagens, fora delas
+        std::uint64_t lastChange = 0; // quadro da última mudança
+        Rect2 tileBounds; // limites com que o item está nas imagens dos blocos
     };
 }
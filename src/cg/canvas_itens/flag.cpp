@@ -1,7 +1,7 @@
 ﻿// Referência para a construção matemática da bandeira: <https://youtu.be/yBjX9jLuLSY>
 #include <cstdlib>
 
-#include "util.hpp"
+#include "api.hpp"
 
 #include "flag.hpp"
 
@@ -9,6 +9,36 @@
 namespace cg {
     Flag::ColorSet Flag::colors;
 
+    /* Acrescenta a primitiva como lista de triângulos (leques e faixas são desfeitos). */
+    static void appendTriangles(Primitive primitive, std::span<const Vector2> vertices, std::vector<Vector2>& triangles)
+    {
+        switch (primitive) {
+        case Primitive::TRIANGLES:
+            triangles.insert(triangles.end(), vertices.begin(), vertices.end());
+            break;
+        case Primitive::TRIANGLE_FAN:
+            for (std::size_t i = 2; i < vertices.size(); ++i)
+                triangles.insert(triangles.end(), { vertices[0], vertices[i - 1], vertices[i] });
+            break;
+        case Primitive::TRIANGLE_STRIP:
+            for (std::size_t i = 2; i < vertices.size(); ++i)
+                if (i % 2 == 0)
+                    triangles.insert(triangles.end(), { vertices[i - 2], vertices[i - 1], vertices[i] });
+                else
+                    triangles.insert(triangles.end(), { vertices[i - 1], vertices[i - 2], vertices[i] });
+            break;
+        default:
+            break; // a bandeira só tem superfícies
+        }
+    }
+
+
+    // Construção da bandeira
+    static constexpr Vector2 CENTER{ Flag::SIZE / 2.0f };
+    static constexpr float RADIUS = 3.5f;
+    // Faixa da bandeira, composta por arcos
+    static constexpr Vector2 ARC_CENTER{ CENTER.x - 2.0f, 0.0f };
+    static constexpr float ARC_INNER_RADIUS = 8.0f, ARC_OUTER_RADIUS = 8.5f;
 
     Flag::Flag() : CanvasItem(TypeInfo::OTHER)
 	{
@@ -47,6 +77,23 @@ namespace cg {
                 gluOrtho2D(0.0, SIZE.x, 0.0, SIZE.y); // coordenadas limite do viewport normalizadas (em 2D)
             }
         }
+
+        // A geometria não depende da vista: gera uma vez e só reenvia a cada quadro
+        RecordingBackend recorder;
+        {
+            ScopedBackend scope{ recorder };
+            genShapes();
+        }
+        for (const RecordingBackend::Command& command : recorder.commands) {
+            // Comandos seguidos da mesma cor viram um só lote (a ordem de desenho é mantida)
+            const Color color = command.color;
+            if (mesh.empty() || mesh.back().color.r != color.r || mesh.back().color.g != color.g
+                    || mesh.back().color.b != color.b || mesh.back().color.a != color.a)
+                mesh.push_back({ command.color, {} });
+            appendTriangles(command.primitive, recorder.verticesOf(command), mesh.back().triangles);
+        }
+
+        bandText = genBandText();
 	}
 
     void Flag::_process(DeltaTime delta)
@@ -55,42 +102,37 @@ namespace cg {
 
     void Flag::_render()
     {
-        GLdebug() {
-                glColor3ub(colors.YELLOW.r, colors.YELLOW.g, colors.YELLOW.b);
-        }
+        RenderBackend& backend = RenderBackend::current();
+        for (const Batch& batch : mesh)
+            backend.draw(Primitive::TRIANGLES, batch.triangles, batch.color);
+
+        TextEngine& engine = TextEngine::instance();
+        if (!engine.isCurrent(*bandText))
+            bandText = genBandText();
+        engine.draw(*bandText, Transform2D{ ARC_CENTER }, colors.GREEN.normalized());
+    }
 
+    void Flag::genShapes()
+    {
             // Desenha o diamante (losango) da bandeira do Brasil
-        float diamondOffset = 1.7f;
-        GLdebug() {
-            glBegin(GL_POLYGON);
-                glVertex2f(SIZE.x / 2.0f, SIZE.y - diamondOffset);
-                glVertex2f(SIZE.x - diamondOffset, SIZE.y / 2.0f);
-                glVertex2f(SIZE.x / 2.0f, diamondOffset);
-                glVertex2f(diamondOffset, SIZE.y / 2.0f);
-            glEnd();
-        }
+        const float diamondOffset = 1.7f;
+        const Vector2 diamond[] = {
+            { SIZE.x / 2.0f, SIZE.y - diamondOffset },
+            { SIZE.x - diamondOffset, SIZE.y / 2.0f },
+            { SIZE.x / 2.0f, diamondOffset },
+            { diamondOffset, SIZE.y / 2.0f },
+        };
+        RenderBackend::current().draw(Primitive::TRIANGLE_FAN, diamond, colors.YELLOW.normalized());
 
             // Desenha o círculo da bandeira do Brasil
-        static constexpr Vector2 CENTER{ SIZE / 2.0f };
-        static constexpr float RADIUS = 3.5f;
+        genCircleAuto(CENTER, RADIUS, colors.BLUE.normalized(), 10.0f);
 
-        GLdebug() {
-            glColor3ub(colors.BLUE.r, colors.BLUE.g, colors.BLUE.b);
-        }
-        GLdebug() {
-            genCircleAuto(CENTER, RADIUS, 10.0f);
-        }
-
-        // Desenha a faixa da bandeira, composta por arcos
-        GLdebug() {
-            glColor3ub(colors.WHITE.r, colors.WHITE.g, colors.WHITE.b);
-        }
-        const Vector2 arcCenter{ CENTER.x - 2.0f, 0.0f };
-        const float arcInnerRadius = 8.0f, arcOuterRadius = 8.5f;
+        const Vector2 arcCenter = ARC_CENTER;
+        const float arcInnerRadius = ARC_INNER_RADIUS, arcOuterRadius = ARC_OUTER_RADIUS;
 
         genSemiArcOverCircle(arcCenter,
             arcInnerRadius, arcOuterRadius, // radius: inner, outer
-            CENTER, 3.5f,
+            CENTER, 3.5f, colors.WHITE.normalized(),
             32        // número de segmentos (suavidade)
         );
 
@@ -112,7 +154,7 @@ namespace cg {
             Star(uint8_t size, Vector2 radialCoords) : radius(starSizes[size - 1]), coords(radialCoords) {
                 coords.y -= 0.5f;
                 coords = CENTER + coords * CELL_SCALAR;
-                genStar(coords, radius, 0.45f);
+                genStar(coords, radius, 0.45f, colors.WHITE.normalized());
             }
         };
         /* Estrelas da bandeira do Brasil */
@@ -173,34 +215,25 @@ namespace cg {
 
         // Canis Minor
         Star procyon(1, { -7.8f, 1.2f }); // Amazonas
+    }
 
-        /* Texto da faixa */
-        GLdebug() {
-            glColor3ub(colors.GREEN.r, colors.GREEN.g, colors.GREEN.b);
-        }
-        GLdebug() {
-            glPushMatrix();
-        }
+    std::shared_ptr<const TextEngine::Layout> Flag::genBandText()
+    {
+        const Vector2 arcCenter = ARC_CENTER;
+        const float arcInnerRadius = ARC_INNER_RADIUS, arcOuterRadius = ARC_OUTER_RADIUS;
 
         const float midRadius = (arcInnerRadius + arcOuterRadius) / 2.0f; // raio médio da faixa
         // Calcular ângulos do arco visível
         auto [startAngle, endAngle] = computeArcAngles(arcCenter, midRadius, CENTER, RADIUS);
 
-        GLdebug() {
-            glTranslatef(arcCenter.x, arcCenter.y, 0.0f); // Centralizar no centro do arco
-        }
-
-            // Desenhar texto na faixa
-        drawArcText("ORDEM E PROGRESSO", midRadius - 0.22f, endAngle, startAngle, 0.004f);
-        GLdebug() {
-            glPopMatrix();
-        }
-
+        /* Texto da faixa: do fim para o início do arco (sentido horário, em pé sobre a faixa) */
+        constexpr float TEXT_SIZE = 0.6f;
+        return TextEngine::instance().layoutArc("ORDEM E PROGRESSO", TEXT_SIZE, midRadius - 0.22f, endAngle, startAngle);
     }
 
     void Flag::_input(io::MouseMove input_event)
     {
-        std::cout << input_event.position.x << ", " << input_event.position.y << '\n';
+        LOG_TRACE("[Flag] mouse", { { "x", input_event.position.x }, { "y", input_event.position.y } });
     }
 
     std::ostream& Flag::_serialize(std::ostream& os) const
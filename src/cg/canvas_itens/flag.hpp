@@ -4,6 +4,7 @@
 
 #include <cg/math.hpp>
 #include <cg/geometry.hpp>
+#include <cg/text_engine.hpp>
 
 
 namespace cg {
@@ -25,6 +26,9 @@ namespace cg {
 
         void _render() override;
 
+        // Usa o `TextEngine` na faixa de texto.
+        bool isRenderThreadSafe() const override { return false; }
+
         void _input(io::MouseMove input_event) override;
 
         // Inherited via CanvasItem
@@ -34,5 +38,19 @@ namespace cg {
 
         // Inherited via CanvasItem
         bool _isSelected(Vector2 cursor_local_position) const override;
+
+    private:
+        // Submete a bandeira ao backend atual (só no construtor)
+        static void genShapes();
+        // Texto da faixa, ao longo do arco (no sistema do centro do arco)
+        static std::shared_ptr<const TextEngine::Layout> genBandText();
+
+        // Triângulos de uma cor, na ordem de desenho.
+        struct Batch {
+            Color color;
+            std::vector<Vector2> triangles;
+        };
+        std::vector<Batch> mesh; // losango, círculo, faixa e estrelas
+        std::shared_ptr<const TextEngine::Layout> bandText; // refeito se o atlas mudar de geração
     };
 }
@@ -1,5 +1,7 @@
 ﻿#include "line.hpp"
 
+#include <cg/render_backend.hpp>
+
 namespace cg {
 
 	void Line::_render()
@@ -7,24 +9,59 @@ namespace cg {
 		if (vertices.empty())
 			return; // A linha deve ter pelo menos 2 vértices (a posição do item conta como 1 vértice)
 
-		// Faremos manualmente!
-		// aplica transformação do modelo com open gl
-		//glMatrixMode(GL_MODELVIEW);
+		RenderBackend& backend = RenderBackend::current();
 
-		GLdebug() {
-			glLineWidth(width);
+		// Nível de detalhe: vértices cujo desvio na tela passa de meio pixel (escala da câmera e do modelo)
+		std::span<const Vector2> detail = vertices;
+		if (vertices.size() >= PolylineLod::MIN_VERTICES) {
+			if (isLodDirty) {
+				lod.build(vertices);
+				isLodDirty = false;
+			}
+			if (lod.select(vertices, 0.5f / screenScale(model), getRevision())) {
+				clipCache.isValid = clippedStroke.clip.isValid = stroke.isValid = false;
+				isDashDirty = true;
+			}
+			detail = lod.vertices;
 		}
-		GLdebug() {
-			glBegin(GL_LINE_STRIP);
-				glColor3f(color.r, color.g, color.b);
-				for (const auto& vertice : vertices) {
-					auto [x, y] = model * vertice; // aplica a transformação do modelo em cada vértice
-					glVertex2f(x, y);
-				}
-			glEnd();
+
+		const Rect2& view = backend.getClipRect();
+		const bool isInside = detail.size() < ClipCache::MIN_VERTICES || view.contains(getBounds());
+
+		// Traço largo: malha expandida na CPU (junções, pontas e borda suavizada), em vez da largura do GL
+		if (width > MAX_THIN_WIDTH) {
+			if (!isInside) {
+				// Atravessa a borda da vista: só os trechos perto dela viram triângulos
+				clippedStroke.draw(detail, model, view, getRevision(), width, style, color);
+				return;
+			}
+			if (stroke.needsBuild(width, style))
+				stroke.build(detail, width, style);
+			stroke.draw(model, color);
+			return;
+		}
+
+		if (!style.dash.isSolid()) {
+			// Tracejado fino: só as pontas dos traços, refeitas quando os vértices ou o padrão mudam
+			if (isDashDirty) {
+				dashSegments(detail, style.dash, dashes);
+				isDashDirty = false;
+			}
+			backend.draw(Primitive::LINES, dashes, model, color, width);
+			return;
 		}
 
-		//glLoadIdentity(); // Restaura a matriz de modelo
+		if (isInside) {
+			// Os vértices ficam no sistema local; o backend aplica a matriz de modelo.
+			backend.draw(Primitive::LINE_STRIP, detail, model, color, width);
+			return;
+		}
+
+		// Atravessa a borda da vista: envia só os trechos visíveis, já no mundo
+		if (clipCache.update(view, getRevision()))
+			clipPolyline(detail, model, clipCache.area, clipCache.vertices);
+		if (!clipCache.vertices.empty())
+			backend.draw(Primitive::LINES, clipCache.vertices, color, width);
 	}
 
 	// Retorna true se o segmento p1-p2 intercepta o retângulo centrado em mousePos com tamanho threshold
@@ -32,61 +69,8 @@ namespace cg {
 			Vector2 p1, Vector2 p2,
 			float threshold = CanvasItem::SELECTION_THRESHOLD)
 	{
-		// Definir os limites do retângulo de tolerância
-		float left   = mousePos.x - threshold;
-		float right  = mousePos.x + threshold;
-		float top    = mousePos.y - threshold;
-		float bottom = mousePos.y + threshold;
-
-		// Codificação dos pontos usando 4 bits (Cohen–Sutherland)
-		auto computeCode = [&](Vector2 v) -> int {
-			int code = 0;
-			if (v.x < left)   code |= 1; // Esquerda
-			if (v.x > right)  code |= 2; // Direita
-			if (v.y < top)    code |= 4; // Cima
-			if (v.y > bottom) code |= 8; // Baixo
-			return code;
-		};
-
-		int code1 = computeCode(p1);
-		int code2 = computeCode(p2);
-
-		while (true) {
-			if ((code1 | code2) == 0) {
-				// Ambos dentro do retângulo → intercepta
-				return true;
-			} else if ((code1 & code2) != 0) {
-				// Ambos fora da mesma região → não intercepta
-				return false;
-			} else {
-				// Pelo menos um ponto está fora → calcula interseção
-				int outCode = code1 ? code1 : code2;
-				Vector2 newPoint;
-
-				if (outCode & 8) {            // baixo
-					newPoint.x = p1.x + (p2.x - p1.x) * (bottom - p1.y) / (p2.y - p1.y);
-					newPoint.y = bottom;
-				} else if (outCode & 4) {     // cima
-					newPoint.x = p1.x + (p2.x - p1.x) * (top - p1.y) / (p2.y - p1.y);
-					newPoint.y = top;
-				} else if (outCode & 2) {     // direita
-					newPoint.y = p1.y + (p2.y - p1.y) * (right - p1.x) / (p2.x - p1.x);
-					newPoint.x = right;
-				} else if (outCode & 1) {     // esquerda
-					newPoint.y = p1.y + (p2.y - p1.y) * (left - p1.x) / (p2.x - p1.x);
-					newPoint.x = left;
-				}
-
-				// Substituir ponto externo pelo ponto de interseção
-				if (outCode == code1) {
-					p1 = newPoint;
-					code1 = computeCode(p1);
-				} else {
-					p2 = newPoint;
-					code2 = computeCode(p2);
-				}
-			}
-		}
+		// Retângulo de tolerância (Cohen–Sutherland)
+		return clipSegment(Rect2{ mousePos - Vector2{ threshold }, mousePos + Vector2{ threshold } }, p1, p2);
 	}
 
 	bool Line::_isSelected(Vector2 cursor_local_position) const
@@ -131,6 +115,8 @@ namespace cg {
 				os << ' ' << *vertice;
 		}
 		os << " ]";
+		if (!style.dash.isSolid())
+			os << " dash: " << style.dash.dash << ' ' << style.dash.gap << ' ' << style.dash.phase;
 		return os;
 	}
 
@@ -214,10 +200,22 @@ namespace cg {
 			else
 				is.clear(); // limpa possíveis flags
 
+			// Tracejado opcional (linhas contínuas não o gravam)
+			DashPattern newDash;
+			if (is && peek_word(is) == "dash:" && !(is >> dummy >> newDash.dash >> newDash.gap >> newDash.phase)) {
+				print_error("Falha ao ler 'dash: <traço> <espaço> <fase>'");
+				is.setstate(std::ios::failbit);
+			}
+
 			model = newModel;
 			width = newWidth;
 			color = newColor;
 			vertices = newVertices;
+			style.dash = newDash;
+			isLodDirty = true;
+			stroke.isValid = false;
+			isDashDirty = true;
+			invalidate();
 		}
 		catch (...) {
 			is.setstate(std::ios::failbit);
@@ -15,6 +15,9 @@ namespace cg
     {
         friend class Gizmo;
         inline static Vector2 selectionOffset{};
+    public:
+        // Linhas mais largas são expandidas em triângulos (`StrokeMesh`); as finas usam as linhas do backend.
+        static constexpr float MAX_THIN_WIDTH = 1.0f;
     public:
         Line() : CanvasItem{ TypeInfo::LINE } {
             vertices.reserve(2);
@@ -70,9 +73,37 @@ namespace cg
         inline void append(Vector2 vertice) {
             // Armazena o ponto relativo ao sistema de coordenadas local do modelo
             vertices.push_back(toLocal(vertice));
+            isLodDirty = true;
+            stroke.isValid = false;
+            isDashDirty = true;
 			setPivotToMiddle(); // Atualiza o sistema de coordenadas local
         }
 
+        Rect2 getLocalBounds() const override {
+            Rect2 local;
+            for (const Vector2& vertice : vertices)
+                local.expand(vertice);
+            return local;
+        }
+
+        float getStrokeSize() const override {
+            return width;
+        }
+
+        inline const StrokeStyle& getStrokeStyle() const {
+            return style;
+        }
+
+        inline void setStrokeStyle(const StrokeStyle& to) {
+            style = to; // a malha do traço é refeita no próximo desenho
+            isDashDirty = true;
+            invalidate();
+        }
+
+        Color getOverviewColor() const override {
+            return color;
+        }
+
 		// Define o pivô como o ponto médio entre todos os vértices
         void setPivotToMiddle() {
             Vector2 middle{};
@@ -84,6 +115,9 @@ namespace cg
         inline void setPivot(Vector2 global_position) {
             // guarda o modelo atual (com rotação + translação antiga)
             Transform2D oldModel = model;
+            stroke.isValid = false;
+            isDashDirty = true;
+            invalidate();
 
             // se não houver vértices, só movemos o modelo e retornamos
             if (vertices.empty()) {
@@ -134,6 +168,10 @@ namespace cg
 
         inline void setVertices(std::vector<Vector2> lineVertices) {
             vertices = lineVertices;
+            isLodDirty = true;
+            stroke.isValid = false;
+            isDashDirty = true;
+            invalidate();
         }
 
         // Inherited via CanvasItem
@@ -142,7 +180,15 @@ namespace cg
     protected:
         std::vector<Vector2> vertices;
         Color color{}; // TODO -> alpha blending
-		float width = 1.0f; // TODO -> anti-alias
+		float width = 1.0f; // pixels
+        StrokeStyle style;
+        StrokeMesh stroke; // traço largo no sistema local (refeito quando os vértices, a largura ou o estilo mudam)
+        std::vector<Vector2> dashes; // segmentos do tracejado de uma linha fina, no sistema local
+        bool isDashDirty = true;
+        PolylineLod lod; // simplificação pela escala de desenho (só para linhas com muitos vértices)
+        bool isLodDirty = true;
+        ClipCache clipCache; // trechos visíveis, quando a linha atravessa a borda da vista
+        ClippedStroke clippedStroke; // idem para o traço largo
     };
 
 } // namespace cg
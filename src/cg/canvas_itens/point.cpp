@@ -3,6 +3,7 @@
 #include <cstdlib>
 
 #include <util.hpp>
+#include <cg/render_backend.hpp>
 
 
 namespace cg
@@ -18,23 +19,12 @@ namespace cg
 
     bool Point::_isSelected(Vector2 cursor_local_position) const
     {
-		return point_selected(cursor_local_position, getPosition(), size + CanvasItem::SELECTION_THRESHOLD);
+		return point_selected(cursor_local_position, localPosition, size + CanvasItem::SELECTION_THRESHOLD);
     }
 
 	void Point::_render()
     {
-        GLdebug() {
-            //glEnable(GL_POINT_SMOOTH);
-            //glHint(GL_POINT_SMOOTH_HINT, GL_NICEST);
-            glPointSize(size);
-        }
-        GLdebug() {
-            glBegin(GL_POINTS);
-                glColor3f(color.r, color.g, color.b);
-				auto [x, y] = getPosition();
-                glVertex2f(x, y);
-            glEnd();
-        }
+        RenderBackend::current().drawPointSprites({ &localPosition, 1 }, model, color, size);
     }
 
     // std::ostream& Point::_print(std::ostream& os) const
@@ -63,7 +53,7 @@ namespace cg
                     return is;
                 }
                 if (dummy != "Point") {
-                    print_error("Esperado 'Point', mas veio: %s", dummy);
+                    print_error("Esperado 'Point', mas veio: %s", dummy.c_str());
                     is.setstate(std::ios::failbit);
                     return is;
                 }
@@ -74,7 +64,7 @@ namespace cg
                     return is;
                 }
                 if (dummy != "at:") {
-                    print_error("Esperado 'at:', mas veio: %s", dummy);
+                    print_error("Esperado 'at:', mas veio: %s", dummy.c_str());
                     is.setstate(std::ios::failbit);
                     return is;
                 }
@@ -85,7 +75,7 @@ namespace cg
                     return is;
                 }
                 if (dummy != "size:") {
-                    print_error("Esperado 'size:', mas veio: %s", dummy);
+                    print_error("Esperado 'size:', mas veio: %s", dummy.c_str());
                     is.setstate(std::ios::failbit);
                     return is;
                 }
@@ -96,7 +86,7 @@ namespace cg
                     return is;
                 }
                 if (dummy != "color:") {
-                    print_error("Esperado 'color:', mas veio: %s", dummy);
+                    print_error("Esperado 'color:', mas veio: %s", dummy.c_str());
                     is.setstate(std::ios::failbit);
                     return is;
                 }
@@ -114,6 +104,7 @@ namespace cg
             size = newSize;
 			setPosition(newPosition);
             model = newModel;
+            invalidate();
         }
         catch (...) {
             is.setstate(std::ios::failbit);
@@ -23,6 +23,19 @@ namespace cg
         void _input(io::MouseDrag mouse_event) override
         {
             localPosition = toLocal(mouse_event.position);
+            invalidate();
+        }
+
+        Rect2 getLocalBounds() const override {
+            return { localPosition, localPosition };
+        }
+
+        float getStrokeSize() const override {
+            return size;
+        }
+
+        Color getOverviewColor() const override {
+            return color;
         }
 
         inline Color& getColor() {
@@ -43,6 +56,7 @@ namespace cg
 
         inline void setPosition(Vector2 to) {
             localPosition = model.inverse() * to;
+            invalidate();
 		}
 
         //void _input(io::MouseMove input_event) override;
@@ -57,7 +71,7 @@ namespace cg
     private:
         Vector2 localPosition{};
         Color color{}; // TODO -> alpha blending
-		float size = SIZE; // TODO -> smooth point
+		float size = SIZE; // diâmetro, em pixels
     };
 
 } // namespace cg
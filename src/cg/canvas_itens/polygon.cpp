@@ -2,34 +2,11 @@
 
 #include "polygon.hpp"
 
-
-namespace cg {
-
-    // ponteiro acessível aos callbacks para salvar vértices criados pelo combine
-    static thread_local std::vector<std::unique_ptr<GLdouble[]>>* currentStorage = nullptr;
-
-    static void TESS_CALLBACK tessError(GLenum errorCode) {
-        const GLubyte* err = gluErrorString(errorCode);
-        print_error("Tessellation Error: %s\n", err);
-    }
+#include <cg/geometry.hpp>
+#include <cg/render_backend.hpp>
 
 
-    static void TESS_CALLBACK tessCombine(const GLdouble coords[3], void* /*vertex_data*/[4],
-        const GLfloat /*weight*/[4], void** outData) {
-        if (!currentStorage) {
-            // fallback: aloca e devolve (ainda seria um leak se s_currentStorage==nullptr)
-            GLdouble* p = new GLdouble[3];
-            p[0] = coords[0]; p[1] = coords[1]; p[2] = coords[2];
-            *outData = p;
-            return;
-        }
-        // cria um unique_ptr para o novo vértice e guarda no vetor
-        auto up = std::unique_ptr<GLdouble[]>(new GLdouble[3]);
-        up[0] = coords[0]; up[1] = coords[1]; up[2] = coords[2];
-        void* raw = up.get();
-        currentStorage->push_back(std::move(up));
-        *outData = raw;
-    }
+namespace cg {
 
     // Seleção de polígono (ray casting)
     // Determina se a posição do mouse está dentro de um polígono usando o algoritmo de "ray casting".
@@ -70,90 +47,74 @@ namespace cg {
 
 
     void Polygon::_render() {
-
-        GLdebug() {
-            glColor3f(innerColor.r, innerColor.g, innerColor.b);
-        }
-		ArrayList<Vector2> vertices;
-		vertices.reserve(this->vertices.size());
-
-		// Transforma os vértices do Sistema de Coordenadas Local para global usando a matriz de modelo
-        for (const auto& vertice : this->vertices)
-			vertices.push_back(model * vertice);
+        RenderBackend& backend = RenderBackend::current();
 
         switch (vertices.size()) {
             case 0: {
                 assert_err(false, "Cannot draw a polygon with no vertices");
             }; break;
             case 1: { // point
-                GLdebug() {
-                    glPointSize(width);
-                }
-                GLdebug() {
-                    glBegin(GL_POINTS);
-                        glVertex2f(vertices[0].x, vertices[0].y);
-                    glEnd();
-                }
+                backend.draw(Primitive::POINTS, vertices, model, innerColor, width);
             } break;
             case 2: { // line
-                GLdebug() {
-				    glLineWidth(width);
-                }
-                GLdebug() {
-                    glBegin(GL_LINES);
-                        glVertex2f(vertices[0].x, vertices[0].y);
-                        glVertex2f(vertices[1].x, vertices[1].y);
-                    glEnd();
-                }
+                backend.draw(Primitive::LINES, vertices, model, innerColor, width);
             } break;
             default: {
-				// TODO -> Implementar contorno
-				// TODO -> Usar cache para evitar tesselar a cada frame
-
-                // container "dono" que guarda todas as alocações estáveis
-                std::vector<std::unique_ptr<GLdouble[]>> tmp_vertices; // precisa ser alocado para converter no formato esperado
-
-                // Tornamos o ponteiro acessível aos callbacks (thread_local para segurança mínima)
-                currentStorage = &tmp_vertices;
-
-                GLUtesselator* tess = gluNewTess();
-                if (!tess) {
-                    print_error("Failed to create GLU tesselator.\n");
-                    currentStorage = nullptr;
-                    return;
-				}
-
-                gluTessCallback(tess, GLU_TESS_BEGIN, (void (TESS_CALLBACK*)())glBegin);
-                gluTessCallback(tess, GLU_TESS_END, (void (TESS_CALLBACK*)())glEnd);
-                gluTessCallback(tess, GLU_TESS_VERTEX, (void (TESS_CALLBACK*)())glVertex3dv);
-                gluTessCallback(tess, GLU_TESS_ERROR, (void (TESS_CALLBACK*)())tessError);
-                gluTessCallback(tess, GLU_TESS_COMBINE, (GLvoid(TESS_CALLBACK*)()) &tessCombine);
-
-                gluTessBeginPolygon(tess, nullptr);
-                gluTessBeginContour(tess);
-
-                // adiciona o ponto inicial e os vértices convertendo para alocações heap
-                auto push_vertex = [&](GLdouble x, GLdouble y, GLdouble z = 0.0) {
-                    auto up = std::unique_ptr<GLdouble[]>(new GLdouble[3]);
-                    up[0] = x; up[1] = y; up[2] = z;
-                    void* raw = up.get();
-                    tmp_vertices.push_back(std::move(up));
-                    gluTessVertex(tess, (GLdouble*)raw, raw);
-                };
+                if (isFilled)
+                    renderFill(backend);
+                if (isContoured)
+                    renderContour(backend);
+            }
+        }
+    }
 
-                for (const auto& vertice : vertices)
-					push_vertex(vertice.x, vertice.y);
+    void Polygon::updateTessellation()
+    {
+        // Os triângulos ficam no sistema local, então só são refeitos quando os vértices mudam.
+        if (isTessellationDirty) {
+            triangles.clear();
+            tessellate(vertices, triangles);
+            isTessellationDirty = false;
+        }
+    }
 
-                // finaliza a tesselagem
-                gluTessEndContour(tess);
-                gluTessEndPolygon(tess);
+    void Polygon::renderFill(RenderBackend& backend)
+    {
+        // Com contorno, o interior segue pelo caminho do traço: polígonos vizinhos formam um só lote no backend
+        const Rect2& view = backend.getClipRect();
+        if (vertices.size() >= ClipCache::MIN_VERTICES && !view.contains(getBounds())) {
+            // Atravessa a borda da vista: tessela só o contorno recortado (Sutherland–Hodgman)
+            if (clipCache.update(view, getRevision())) {
+                clipPolygon(vertices, model, clipCache.area, clipped);
+                tessellate(clipped, clipCache.vertices);
+            }
+            if (clipCache.vertices.empty())
+                return;
+            if (isContoured)
+                drawSolidTriangles(clipCache.vertices, Transform2D{}, innerColor);
+            else
+                backend.draw(Primitive::TRIANGLES, clipCache.vertices, innerColor);
+            return;
+        }
 
-                gluDeleteTess(tess);
+        updateTessellation();
+        if (isContoured)
+            drawSolidTriangles(triangles, model, innerColor);
+        else
+            backend.draw(Primitive::TRIANGLES, triangles, model, innerColor);
+    }
 
-				currentStorage = nullptr; // limpa o ponteiro thread_local
-				// tmp_vertices é desalocado automaticamente ao sair do escopo
-            }
+    void Polygon::renderContour(RenderBackend& backend)
+    {
+        const Rect2& view = backend.getClipRect();
+        if (vertices.size() >= ClipCache::MIN_VERTICES && !view.contains(getBounds())) {
+            // Atravessa a borda da vista: só os trechos do contorno perto dela viram triângulos
+            clippedContour.draw(vertices, model, view, getRevision(), width, CONTOUR_STYLE, contourColor, true);
+            return;
         }
+        if (contour.needsBuild(width, CONTOUR_STYLE))
+            contour.build(vertices, width, CONTOUR_STYLE, true);
+        contour.draw(model, contourColor);
     }
 
 //     std::ostream& Polygon::_print(std::ostream& os) const
@@ -179,7 +140,7 @@ namespace cg {
             for (vertice = ++vertice; vertice < vertices.end(); ++vertice)
                 os << ' ' << *vertice;
         }
-        os << " ]";
+        os << " ] filled: " << isFilled << " contoured: " << isContoured;
         return os;
     }
 
@@ -191,6 +152,7 @@ namespace cg {
 			float newWidth;
             Color colors[2];
 			ArrayList<Vector2> newVertices;
+            bool newFilled = true, newContoured = false; // arquivos antigos não têm os campos
 
             if constexpr (IS_DEBUG) {
 				// Lê o cabeçalho
@@ -295,12 +257,25 @@ namespace cg {
             else
                 is.clear(); // limpa possíveis flags
 
+            if (peek_word(is) == "filled:") {
+                if (!(is >> dummy >> newFilled >> dummy) || dummy != "contoured:" || !(is >> newContoured)) {
+                    print_error("Falha ao ler 'filled: <0|1> contoured: <0|1>'");
+                    is.setstate(std::ios::failbit);
+                    return is;
+                }
+            }
+
 			// Substitui os dados apenas se tudo foi lido corretamente
 			model = newModel;
 			width = newWidth;
 			innerColor = colors[0];
 			contourColor = colors[1];
             vertices = newVertices;
+            isFilled = newFilled;
+            isContoured = newContoured;
+            isTessellationDirty = true;
+            contour.isValid = false;
+            invalidate();
         }
         catch (...) {
             is.setstate(std::ios::failbit);
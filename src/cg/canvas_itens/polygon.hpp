@@ -4,6 +4,7 @@
 
 #include <cg/canvas.hpp>
 #include <cg/math.hpp>
+#include <cg/geometry.hpp>
 
 #include "../canvas_item.hpp"
 
@@ -13,6 +14,8 @@ namespace cg
     class Polygon : public CanvasItem
     {
         inline static Vector2 selectionOffset{};
+        // Quinas vivas, como o interior (chanfro além do limite)
+        static constexpr StrokeStyle CONTOUR_STYLE{ LineJoin::MITER, LineCap::BUTT };
     public:
         Polygon() : CanvasItem(TypeInfo::POLYGON) {}
         Polygon(Vector2 position, Color color = Color{}) : CanvasItem{ TypeInfo::POLYGON }, innerColor{ color }, contourColor{ color } {
@@ -41,12 +44,32 @@ namespace cg
 
         inline void append(Vector2 newVertex) {
             vertices.push_back(toLocal(newVertex));
+            isTessellationDirty = true;
+            contour.isValid = false;
             setPivotToMiddle();
         }
 
+        Rect2 getLocalBounds() const override {
+            Rect2 local;
+            for (const Vector2& vertice : vertices)
+                local.expand(vertice);
+            return local;
+        }
+
+        float getStrokeSize() const override {
+            return width;
+        }
+
+        Color getOverviewColor() const override {
+            return innerColor;
+        }
+
         inline void setPivot(Vector2 global_position) {
             // guarda o modelo atual (com rotação + translação antiga)
             Transform2D oldModel = model;
+            isTessellationDirty = true;
+            contour.isValid = false;
+            invalidate();
 
             // se não houver vértices, só movemos o modelo e retornamos
             if (vertices.empty()) {
@@ -102,12 +125,49 @@ namespace cg
 
         inline void setVertices(std::vector<Vector2> allVertices) {
             vertices = allVertices;
+            isTessellationDirty = true;
+            contour.isValid = false;
+            invalidate();
         }
 
         inline void setColor(ColorRgb color) {
             innerColor = color;
         }
 
+        inline void setContourColor(Color color) {
+            contourColor = color;
+        }
+
+        inline Color getContourColor() const {
+            return contourColor;
+        }
+
+        // Largura do contorno, em pixels
+        inline void setWidth(float new_width) {
+            width = new_width;
+            invalidate();
+        }
+
+        // Desenha o interior (padrão)
+        inline void setFilled(bool filled) {
+            isFilled = filled;
+            invalidate();
+        }
+
+        inline bool getFilled() const {
+            return isFilled;
+        }
+
+        // Desenha o contorno, com `contourColor` e `width`
+        inline void setContoured(bool contoured) {
+            isContoured = contoured;
+            invalidate();
+        }
+
+        inline bool getContoured() const {
+            return isContoured;
+        }
+
         inline Color& getColor() {
             return innerColor;
         }
@@ -119,12 +179,26 @@ namespace cg
         // Inherited via CanvasItem
         std::ostream& _serialize(std::ostream& os) const override;
         std::istream& _deserialize(std::istream& is) override;
+    private:
+        void renderFill(RenderBackend& backend);
+        void renderContour(RenderBackend& backend);
+        // Refaz a tesselagem (coordenadas locais) se os vértices mudaram
+        void updateTessellation();
+
     private:
         std::vector<Vector2> vertices;
         Color innerColor{};
-        Color contourColor{}; // TODO -> Implement contour color
-		float width = 1.0f; // TODO -> Implement line width
-        // TODO -> anti-alias
+        Color contourColor{};
+        float width = 1.0f; // contorno, em pixels
+        bool isFilled = true;
+        bool isContoured = false;
+
+        std::vector<Vector2> triangles; // cache da tesselagem, em coordenadas locais
+        bool isTessellationDirty = true;
+        StrokeMesh contour; // traço fechado sobre os mesmos vértices locais (invalide junto da tesselagem)
+        ClipCache clipCache; // triângulos de mundo do contorno recortado à vista
+        ClippedStroke clippedContour; // trechos do traço perto da vista, quando o polígono atravessa a borda
+        std::vector<Vector2> clipped; // contorno recortado (rascunho reaproveitado)
 
     };
 
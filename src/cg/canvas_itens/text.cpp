@@ -0,0 +1,71 @@
+﻿#include "text.hpp"
+
+#include <string>
+#include <iomanip>
+
+#include <util.hpp>
+
+
+namespace cg
+{
+    const TextEngine::Layout& Text::getLayout() const
+    {
+        TextEngine& engine = TextEngine::instance();
+        if (!layout || !engine.isCurrent(*layout))
+            layout = engine.layout(text, size);
+        return *layout;
+    }
+
+    Rect2 Text::getLocalBounds() const
+    {
+        const Rect2& bounds = getLayout().bounds;
+        // Sem glifos visíveis (ou sem fonte), o item ainda ocupa a origem para ser indexado e selecionado
+        return bounds.isEmpty() ? Rect2{ Vector2{}, Vector2{} } : bounds;
+    }
+
+    bool Text::_isSelected(Vector2 cursor_local_position) const
+    {
+        return getLocalBounds().grown(CanvasItem::SELECTION_THRESHOLD).contains(cursor_local_position);
+    }
+
+    void Text::_render()
+    {
+        TextEngine::instance().draw(getLayout(), model, color);
+    }
+
+    std::ostream& Text::_serialize(std::ostream& os) const
+    {
+        os << "Text " << model << " size: " << size << " color: " << color << " text: " << std::quoted(text);
+        return os;
+    }
+
+    std::istream& Text::_deserialize(std::istream& is)
+    {
+        try {
+            std::string dummy, newText;
+            Color newColor;
+            float newSize;
+            Transf2x3<float> newModel;
+            if (!(is >> dummy >> newModel) || dummy != "Text" ||
+                !(is >> dummy >> newSize) || dummy != "size:" ||
+                !(is >> dummy >> newColor) || dummy != "color:" ||
+                !(is >> dummy >> std::quoted(newText)) || dummy != "text:") {
+                if constexpr (IS_DEBUG)
+                    print_error("Erro ao ler 'Text <model> size: <size> color: <color> text: \"<text>\"' (em '%s')", dummy.c_str());
+                is.setstate(std::ios::failbit); // marca falha no stream
+                return is;
+            }
+            color = newColor;
+            size = newSize;
+            text = std::move(newText);
+            layout.reset();
+            model = newModel;
+            invalidate();
+        }
+        catch (...) {
+            is.setstate(std::ios::failbit);
+        }
+        return is;
+    }
+
+} // namespace cg
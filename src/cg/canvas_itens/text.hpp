@@ -0,0 +1,87 @@
+﻿#pragma once
+
+#include <memory>
+#include <string>
+
+#include "../canvas.hpp"
+
+#include <cg/math.hpp>
+#include <cg/text_engine.hpp>
+
+
+namespace cg
+{
+    /* Texto em uma linha, desenhado pelo atlas de glifos (ver `TextEngine`).
+     * A origem do item fica no início da linha de base.
+     */
+    class Text : public CanvasItem
+    {
+    public:
+        inline static const float SIZE = 24.0f; // altura da linha, em unidades do mundo
+    public:
+        Text() : CanvasItem(TypeInfo::TEXT) {}
+        Text(Vector2 position, std::string text, Color color = Color{}, float size = SIZE)
+            : CanvasItem{ TypeInfo::TEXT, position }, text{ std::move(text) }, color{ color }, size{ size } {}
+
+        void _render() override;
+
+        // O atlas de glifos (`TextEngine`) é compartilhado: só na thread de desenho.
+        bool isRenderThreadSafe() const override { return false; }
+
+        Rect2 getLocalBounds() const override;
+
+        Color getOverviewColor() const override {
+            return color;
+        }
+
+        inline Color& getColor() {
+            return color;
+        }
+
+        inline Color getColor() const {
+            return color;
+        }
+
+        inline void setColor(Color newColor) {
+            color = newColor;
+        }
+
+        inline const std::string& getText() const {
+            return text;
+        }
+
+        inline void setText(std::string to) {
+            text = std::move(to);
+            layout.reset();
+            invalidate();
+        }
+
+        inline float getSize() const {
+            return size;
+        }
+
+        inline void setSize(float to) {
+            size = to;
+            layout.reset();
+            invalidate();
+        }
+
+    protected:
+        bool _isSelected(Vector2 cursor_local_position) const override;
+
+        // Inherited via CanvasItem
+        std::ostream& _serialize(std::ostream& os) const override;
+        std::istream& _deserialize(std::istream& is) override;
+
+    private:
+        // Layout atual do texto (refeito se o atlas mudou de geração)
+        const TextEngine::Layout& getLayout() const;
+
+    private:
+        std::string text;
+        Color color{};
+        float size = SIZE;
+        mutable std::shared_ptr<const TextEngine::Layout> layout;
+    };
+
+} // namespace cg
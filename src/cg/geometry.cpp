@@ -1,14 +1,103 @@
-#include "../api.hpp"
-
+#include <set>
+#include <array>
 #include <cmath>
+#include <mutex>
+#include <queue>
+#include <limits>
+#include <cstring>
+#include <utility>
+#include <functional>
 
 #include "geometry.hpp"
 
+#if !defined(CG_NO_SIMD) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+    #define CG_SSE2 1
+    #include <emmintrin.h>
+#endif
+
 
 namespace cg
 {
 
-void genSemiArcOverCircle(const Vector2& arcCenter, float innerRadius,
+namespace {
+    static_assert(sizeof(Vector2) == 2 * sizeof(float), "Vector2 must be two packed floats");
+
+    /* `count` pontos do círculo unitário a cada `stride`, de `start` em passos de `step` (rotação incremental). */
+    void unitArc(Vector2* out, std::size_t count, std::size_t stride, float start, float step)
+    {
+        const double cosStep = std::cos((double)step), sinStep = std::sin((double)step);
+        double c = std::cos((double)start), s = std::sin((double)start);
+        for (std::size_t i = 0; i < count; ++i, out += stride) {
+            *out = { (float)c, (float)s };
+            const double next = c * cosStep - s * sinStep;
+            s = s * cosStep + c * sinStep;
+            c = next;
+        }
+    }
+
+    /* p = p * escala + deslocamento; índices pares e ímpares têm os seus (faixas intercaladas). */
+    void scaleOffset(std::span<Vector2> points, float evenScale, Vector2 evenOffset, float oddScale, Vector2 oddOffset)
+    {
+        std::size_t i = 0;
+#ifdef CG_SSE2
+        const __m128 scale = _mm_setr_ps(evenScale, evenScale, oddScale, oddScale);
+        const __m128 offset = _mm_setr_ps(evenOffset.x, evenOffset.y, oddOffset.x, oddOffset.y);
+        float* data = &points.data()->x;
+        for (; i + 2 <= points.size(); i += 2)
+            _mm_storeu_ps(data + 2 * i, _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(data + 2 * i), scale), offset));
+#endif
+        for (; i < points.size(); ++i)
+            points[i] = i % 2 == 0 ? points[i] * evenScale + evenOffset : points[i] * oddScale + oddOffset;
+    }
+
+    inline void scaleOffset(std::span<Vector2> points, float scale, Vector2 offset)
+    {
+        scaleOffset(points, scale, offset, scale, offset);
+    }
+
+    // Passo para `segments` intervalos entre dois ângulos (nenhum intervalo: fica no início).
+    inline float stepOf(float from, float to, std::size_t segments)
+    {
+        return segments > 0 ? (to - from) / (float)segments : 0.0f;
+    }
+} // namespace
+
+
+void genArc(std::span<Vector2> out, Vector2 center, float radius, float start_angle, float step)
+{
+    unitArc(out.data(), out.size(), 1, start_angle, step);
+    scaleOffset(out, radius, center);
+}
+
+
+void genSemiArc(std::span<Vector2> out, Vector2 center, float innerRadius, float outerRadius,
+        float startAngle, float endAngle)
+{
+    const std::size_t count = out.size() / 2; // pontos por arco
+    if (count == 0)
+        return;
+    const float step = stepOf(startAngle, endAngle, count - 1);
+    genArc(out.first(count), center, outerRadius, startAngle, step);
+    genArc(out.subspan(count, count), center, innerRadius, endAngle, -step);
+}
+
+
+void genStar(std::span<Vector2, STAR_VERTICES> out, Vector2 center, float outerRadius, float innerRatio)
+{
+    // Direções fixas das pontas e vales: calculadas uma vez
+    static const auto directions = [] {
+        std::array<Vector2, STAR_VERTICES - 1> table;
+        unitArc(table.data(), table.size(), 1, PI<float> / 2.0f, -PI<float> / 5.0f);
+        return table;
+    }();
+
+    out[0] = center; // centro do leque
+    std::copy(directions.begin(), directions.end(), out.begin() + 1);
+    scaleOffset(out.subspan(1), outerRadius, center, outerRadius * std::clamp(innerRatio, 0.0f, 1.0f), center);
+}
+
+
+std::size_t genSemiArcOverCircle(std::span<Vector2> out, const Vector2& arcCenter, float innerRadius,
         float outerRadius, const Vector2& circleCenter, float circleRadius,
         std::size_t segments, std::size_t edgeSegments)
 {
@@ -16,7 +105,7 @@ void genSemiArcOverCircle(const Vector2& arcCenter, float innerRadius,
     float dx = circleCenter.x - arcCenter.x;
     float dy = circleCenter.y - arcCenter.y;
     float d  = std::sqrt(dx*dx + dy*dy);
-    if (d < 1e-6f) return;
+    if (d < 1e-6f) return 0;
     float phi = std::atan2(dy, dx);
 
     // 2) intervalo de ângulos no arco interno/externo (lei dos cossenos)
@@ -44,60 +133,67 @@ void genSemiArcOverCircle(const Vector2& arcCenter, float innerRadius,
     float angIn1  = intersectAng(innerRadius, in1);
     float angOut1 = intersectAng(outerRadius, out1);
 
-    //glPolygonMode(GL_FRONT_AND_BACK, GL_LINE); // Modo wireframe
+    // 4) monta o TRIANGLE_STRIP: pares (externo, interno) intercalados
+    const std::size_t edgeCount = 2 * (edgeSegments + 1), mainCount = 2 * (segments + 1);
+    std::span<Vector2> left = out.first(edgeCount), main = out.subspan(edgeCount, mainCount),
+        right = out.subspan(edgeCount + mainCount, edgeCount);
+
+    // 4.1) lateral esquerda: de angOut0 → angIn0, os dois pontos do par sobre o círculo azul
+    const float leftStep = stepOf(angOut0, angIn0, edgeSegments);
+    unitArc(left.data(), edgeSegments + 1, 2, angOut0, leftStep);
+    unitArc(left.data() + 1, edgeSegments + 1, 2, angOut0, leftStep);
+    scaleOffset(left, circleRadius, circleCenter);
+
+    // 4.2) arcos principal (outer → inner) no centro da faixa
+    unitArc(main.data(), segments + 1, 2, out0, stepOf(out0, out1, segments));
+    unitArc(main.data() + 1, segments + 1, 2, in0, stepOf(in0, in1, segments));
+    scaleOffset(main, outerRadius, arcCenter, innerRadius, arcCenter);
+
+    // 4.3) lateral direita: de angIn1 → angOut1
+    const float rightStep = stepOf(angIn1, angOut1, edgeSegments);
+    unitArc(right.data(), edgeSegments + 1, 2, angIn1, rightStep);
+    unitArc(right.data() + 1, edgeSegments + 1, 2, angIn1, rightStep);
+    scaleOffset(right, circleRadius, circleCenter);
+
+    return edgeCount * 2 + mainCount;
+}
+
 
-    // 4) monta o TRIANGLE_STRIP
-    glBegin(GL_TRIANGLE_STRIP);
+namespace {
+    // Faixas de detalhe: contagens de segmentos arredondadas para cima em passos de 2^(1/4)
+    constexpr int LOD_STEPS_PER_OCTAVE = 4;
+    constexpr int LOD_BUCKETS = LOD_STEPS_PER_OCTAVE * 11 + 1; // até 2^11 = CURVE_MAX_SEGMENTS
+    static_assert(CURVE_MAX_SEGMENTS == 1 << 11);
 
-    // 4.1) lateral esquerda: interpolar de angOut0 → angIn0
-    for (std::size_t i = 0; i <= edgeSegments; ++i) {
-        float t    = float(i) / edgeSegments;
-        float aOut = angOut0*(1 - t) + angIn0*t;
-        float aIn  = angOut0*(1 - t) + angIn0*t;
-        // ponto na borda externa (círculo azul)
-        glVertex2f(
-            circleCenter.x + circleRadius * std::cos(aOut),
-            circleCenter.y + circleRadius * std::sin(aOut)
-        );
-        // ponto na borda interna (também no círculo azul)
-        glVertex2f(
-            circleCenter.x + circleRadius * std::cos(aIn),
-            circleCenter.y + circleRadius * std::sin(aIn)
-        );
+    inline int lodBucket(std::size_t segments)
+    {
+        return (int)std::ceil(LOD_STEPS_PER_OCTAVE * std::log2((double)segments));
     }
+} // namespace
 
-    // 4.2) arcos principal (outer → inner) no centro da faixa
-    for (std::size_t i = 0; i <= segments; ++i) {
-        float to = out0 + (out1 - out0) * (float(i) / segments);
-        float ti = in0  + (in1 - in0) * (float(i) / segments);
-        // externo
-        glVertex2f(
-            arcCenter.x + outerRadius * std::cos(to),
-            arcCenter.y + outerRadius * std::sin(to)
-        );
-        // interno
-        glVertex2f(
-            arcCenter.x + innerRadius * std::cos(ti),
-            arcCenter.y + innerRadius * std::sin(ti)
-        );
-    }
-
-    // 4.3) lateral direita: interpolar de angIn1 → angOut1
-    for (std::size_t i = 0; i <= edgeSegments; ++i) {
-        float t    = float(i) / edgeSegments;
-        float aOut = angIn1 * (1 - t) + angOut1*t;
-        float aIn  = angIn1 * (1 - t) + angOut1*t;
-        glVertex2f(
-            circleCenter.x + circleRadius * std::cos(aOut),
-            circleCenter.y + circleRadius * std::sin(aOut)
-        );
-        glVertex2f(
-            circleCenter.x + circleRadius * std::cos(aIn),
-            circleCenter.y + circleRadius * std::sin(aIn)
-        );
-    }
-
-    glEnd();
+
+std::size_t circleSegments(float screen_radius, float max_error)
+{
+    if (!(screen_radius > max_error))
+        return CURVE_MIN_SEGMENTS; // menor que o erro (ou inválido): qualquer contorno serve
+    const double segments = PI<double> / std::acos(1.0 - (double)max_error / screen_radius);
+    return (std::size_t)std::clamp(std::ceil(segments), (double)CURVE_MIN_SEGMENTS, (double)CURVE_MAX_SEGMENTS);
+}
+
+
+std::span<const Vector2> unitCircle(std::size_t segments)
+{
+    static std::array<std::once_flag, LOD_BUCKETS> built;
+    static std::array<std::vector<Vector2>, LOD_BUCKETS> tables;
+
+    const int bucket = lodBucket(std::clamp<std::size_t>(segments, 1, CURVE_MAX_SEGMENTS));
+    std::call_once(built[bucket], [bucket] {
+        const std::size_t count = std::max<std::size_t>(3,
+            (std::size_t)std::ceil(std::exp2((double)bucket / LOD_STEPS_PER_OCTAVE) - 1e-9));
+        tables[bucket].resize(count);
+        unitArc(tables[bucket].data(), count, 1, 0.0f, TAU<float> / count);
+    });
+    return tables[bucket];
 }
 
 
@@ -121,60 +217,907 @@ std::pair<float, float> computeArcAngles(const Vector2& arcCenter, float radius,
 }
 
 
-void drawArcText(const char* text, float radius, float startAngle, float endAngle, float scale)
+namespace {
+    struct Slot;
+
+    // Aresta do contorno, orientada de cima (menor y) para baixo.
+    struct Edge {
+        float y0, y1;
+        float x0, x1;
+        float dxdy;
+        std::size_t id; // desempate estável
+        Slot* slot = nullptr; // posição na varredura (nulo fora dela)
+
+        inline float at(float y) const {
+            // Pontas exatas: os trapézios encontram os vértices do contorno sem fendas
+            if (y == y0)
+                return x0;
+            if (y == y1)
+                return x1;
+            return x0 + (y - y0) * dxdy;
+        }
+    };
+
+    // Região entre a aresta de uma posição e a da seguinte, aberta desde `top` (mesclada enquanto o par não muda)
+    struct Region {
+        const Edge* left = nullptr;
+        const Edge* right = nullptr;
+        float top = 0.0f;
+    };
+
+    struct SweepOrder {
+        const float* y; // altura da varredura
+
+        bool operator()(const Slot* a, const Slot* b) const;
+    };
+
+    // Posição na linha de varredura. Num cruzamento as posições trocam de aresta, sem mexer na árvore.
+    struct Slot {
+        Edge* edge;
+        std::set<Slot*, SweepOrder>::iterator it;
+        bool isActive = false;
+        bool isInside = false; // a região à direita é preenchida (regra par-ímpar)
+        bool isOpen = false;
+        Region region;
+    };
+
+    bool SweepOrder::operator()(const Slot* a, const Slot* b) const
+    {
+        const Edge& ea = *a->edge;
+        const Edge& eb = *b->edge;
+        const float xa = ea.at(*y), xb = eb.at(*y);
+        if (xa != xb)
+            return xa < xb;
+        if (ea.dxdy != eb.dxdy)
+            return ea.dxdy < eb.dxdy; // abaixo da varredura, à esquerda fica a menos inclinada para a direita
+        return ea.id < eb.id;
+    }
+
+    struct Crossing {
+        float y;
+        Edge* left;
+        Edge* right;
+
+        bool operator>(const Crossing& other) const { return y > other.y; }
+    };
+} // namespace
+
+
+void tessellate(std::span<const Vector2> contour, std::vector<Vector2>& triangles)
 {
-    if (!text || *text == '\0') return;
+    const std::size_t n = contour.size();
+    if (n < 3)
+        return;
+
+    std::vector<Edge> edges;
+    edges.reserve(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        Vector2 a = contour[i];
+        Vector2 b = contour[(i + 1) % n];
+        if (!(a.y != b.y) || !std::isfinite(a.x + b.x))
+            continue; // arestas horizontais não delimitam faixas
+        if (a.y > b.y)
+            std::swap(a, b);
+        edges.push_back({ a.y, b.y, a.x, b.x, (b.x - a.x) / (b.y - a.y), edges.size() });
+    }
+    if (edges.size() < 2)
+        return;
+
+    // Varredura de cima para baixo (Bentley–Ottmann): os níveis são os vértices e os cruzamentos entre arestas
+    // vizinhas. Cada região entre vizinhas vira um único trapézio enquanto o par não muda, então a saída é
+    // linear em vértices mais cruzamentos (a tesselagem de faixas em todos os pares era quadrática).
+    std::vector<Edge*> starts(edges.size()), ends(edges.size());
+    for (std::size_t i = 0; i < edges.size(); ++i)
+        starts[i] = ends[i] = &edges[i];
+    std::sort(starts.begin(), starts.end(), [](const Edge* a, const Edge* b) { return a->y0 < b->y0; });
+    std::sort(ends.begin(), ends.end(), [](const Edge* a, const Edge* b) { return a->y1 < b->y1; });
+
+    float sweepY = starts.front()->y0;
+    std::set<Slot*, SweepOrder> status{ SweepOrder{ &sweepY } };
+    std::vector<Slot> slots(edges.size()); // uma por aresta inserida (cruzamentos reaproveitam as posições)
+    std::size_t nextSlot = 0, nextStart = 0, nextEnd = 0;
+    std::priority_queue<Crossing, std::vector<Crossing>, std::greater<Crossing>> crossings;
+    std::vector<Slot*> touched; // posições cuja aresta ou vizinha à direita mudou neste nível
+
+    auto nextOf = [&status](const Slot* slot) -> Slot* {
+        auto it = std::next(slot->it);
+        return it == status.end() ? nullptr : *it;
+    };
+    auto previousOf = [&status](const Slot* slot) -> Slot* {
+        return slot->it == status.begin() ? nullptr : *std::prev(slot->it);
+    };
+
+    auto close = [&triangles, &sweepY](Slot& slot) {
+        if (!slot.isOpen)
+            return;
+        slot.isOpen = false;
+        const float top = slot.region.top, bottom = sweepY;
+        if (!(top < bottom))
+            return;
+        Vector2 a{ slot.region.left->at(top), top }, b{ slot.region.right->at(top), top };
+        Vector2 c{ slot.region.right->at(bottom), bottom }, d{ slot.region.left->at(bottom), bottom };
+        if (a != b && b != c)
+            triangles.insert(triangles.end(), { a, b, c });
+        if (c != d && d != a)
+            triangles.insert(triangles.end(), { a, c, d });
+    };
+
+    // Acerta a paridade e a região da posição e segue para a direita enquanto algo muda
+    auto settle = [&](Slot* slot) {
+        while (slot) {
+            const Slot* previous = previousOf(slot);
+            const Slot* next = nextOf(slot);
+            const bool isInside = (previous ? !previous->isInside : true) && next;
+            const bool isSame = slot->isInside == isInside && slot->isOpen == isInside &&
+                (!isInside || (slot->region.left == slot->edge && slot->region.right == next->edge));
+            if (isSame)
+                return;
+            close(*slot);
+            const bool flipped = slot->isInside != isInside;
+            slot->isInside = isInside;
+            if (isInside) {
+                slot->isOpen = true;
+                slot->region = { slot->edge, next->edge, sweepY };
+            }
+            if (!flipped)
+                return;
+            slot = nextOf(slot);
+        }
+    };
+
+    auto checkCrossing = [&](const Slot* slot) {
+        const Slot* next = nextOf(slot);
+        if (!next)
+            return;
+        Edge* left = slot->edge;
+        Edge* right = next->edge;
+        if (!(left->dxdy > right->dxdy))
+            return; // divergem (ou são paralelas) abaixo da varredura
+        const float gap = right->at(sweepY) - left->at(sweepY);
+        float y = sweepY + std::max(gap, 0.0f) / (left->dxdy - right->dxdy);
+        if (!(y > sweepY))
+            y = std::nextafter(sweepY, std::numeric_limits<float>::infinity()); // já se tocam: troca logo abaixo
+        if (y < std::min(left->y1, right->y1))
+            crossings.push({ y, left, right });
+    };
 
-    // Calcular ângulo total e direção
-    float arcAngle = endAngle - startAngle;
-    bool clockwise = (arcAngle < 0);
-    float absArcAngle = std::abs(arcAngle);
+    while (nextStart < starts.size() || nextEnd < ends.size()) {
+        sweepY = ends[nextEnd]->y1;
+        if (nextStart < starts.size())
+            sweepY = std::min(sweepY, starts[nextStart]->y0);
+        if (!crossings.empty())
+            sweepY = std::min(sweepY, crossings.top().y);
+        touched.clear();
 
-    // Pré-calcular largura total do texto (unscaled)
-    float totalWidth = 0;
-    for (const char* c = text; *c; c++) {
-        totalWidth += glutStrokeWidth(GLUT_STROKE_ROMAN, *c);
+        // Cruzamentos: as vizinhas trocam de posição
+        while (!crossings.empty() && crossings.top().y == sweepY) {
+            const Crossing crossing = crossings.top();
+            crossings.pop();
+            Slot* left = crossing.left->slot;
+            Slot* right = crossing.right->slot;
+            if (!left || !right || nextOf(left) != right)
+                continue; // o par deixou de ser vizinho
+            std::swap(left->edge, right->edge);
+            left->edge->slot = left;
+            right->edge->slot = right;
+            touched.insert(touched.end(), { left, right });
+            if (Slot* previous = previousOf(left))
+                touched.push_back(previous);
+        }
+
+        // Arestas que terminam: fecham a própria região; a vizinha à esquerda passa a ver outra e a da
+        // direita inverte a paridade
+        for (; nextEnd < ends.size() && ends[nextEnd]->y1 == sweepY; ++nextEnd) {
+            Slot* slot = ends[nextEnd]->slot;
+            close(*slot);
+            if (Slot* previous = previousOf(slot))
+                touched.push_back(previous);
+            if (Slot* next = nextOf(slot))
+                touched.push_back(next);
+            status.erase(slot->it);
+            slot->isActive = false;
+            slot->edge->slot = nullptr;
+        }
+
+        // Arestas que começam
+        for (; nextStart < starts.size() && starts[nextStart]->y0 == sweepY; ++nextStart) {
+            Slot* slot = &slots[nextSlot++];
+            slot->edge = starts[nextStart];
+            slot->edge->slot = slot;
+            slot->isActive = true;
+            slot->it = status.insert(slot).first;
+            touched.push_back(slot);
+            if (Slot* previous = previousOf(slot))
+                touched.push_back(previous);
+            if (Slot* next = nextOf(slot))
+                touched.push_back(next);
+        }
+
+        // Da esquerda para a direita: cada posição vê a vizinha já acertada (sem fechar regiões à toa)
+        std::erase_if(touched, [](const Slot* slot) { return !slot->isActive; });
+        std::sort(touched.begin(), touched.end(), status.value_comp());
+        touched.erase(std::unique(touched.begin(), touched.end()), touched.end());
+        for (Slot* slot : touched)
+            settle(slot);
+        for (Slot* slot : touched)
+            checkCrossing(slot);
+    }
+}
+
+
+namespace {
+    // Codificação das regiões (Cohen–Sutherland)
+    enum OutCode : int { LEFT = 1, RIGHT = 2, TOP = 4, BOTTOM = 8 };
+
+    inline int outCode(const Rect2& rect, Vector2 v) {
+        int code = 0;
+        if (v.x < rect.min.x) code |= LEFT;
+        if (v.x > rect.max.x) code |= RIGHT;
+        if (v.y < rect.min.y) code |= TOP;
+        if (v.y > rect.max.y) code |= BOTTOM;
+        return code;
     }
-    if (totalWidth <= 0) return;
+} // namespace
 
-    float cumulativeWidth = 0;
 
-    for (const char* c = text; *c; c++) {
-        float charWidth = glutStrokeWidth(GLUT_STROKE_ROMAN, *c);
-        // Cálculo do ângulo para este caractere
-        float charAngle;
-        float t = (cumulativeWidth + charWidth / 2) / totalWidth;
+bool clipSegment(const Rect2& rect, Vector2& from, Vector2& to)
+{
+    int code1 = outCode(rect, from);
+    int code2 = outCode(rect, to);
+
+    while (true) {
+        if ((code1 | code2) == 0)
+            return true; // ambos dentro
+        if ((code1 & code2) != 0)
+            return false; // ambos fora, do mesmo lado
 
-        if (clockwise) {
-            charAngle = startAngle - t * absArcAngle;
+        // Pelo menos um ponto está fora → move-o para a borda que ele cruza
+        int code = code1 ? code1 : code2;
+        Vector2 point;
+        if (code & BOTTOM) {
+            point.x = from.x + (to.x - from.x) * (rect.max.y - from.y) / (to.y - from.y);
+            point.y = rect.max.y;
+        } else if (code & TOP) {
+            point.x = from.x + (to.x - from.x) * (rect.min.y - from.y) / (to.y - from.y);
+            point.y = rect.min.y;
+        } else if (code & RIGHT) {
+            point.y = from.y + (to.y - from.y) * (rect.max.x - from.x) / (to.x - from.x);
+            point.x = rect.max.x;
         } else {
-            charAngle = startAngle + t * absArcAngle;
+            point.y = from.y + (to.y - from.y) * (rect.min.x - from.x) / (to.x - from.x);
+            point.x = rect.min.x;
         }
 
-        glPushMatrix();
-        // Posicionar no ponto do arco
-        float x = radius * cos(charAngle);
-        float y = radius * sin(charAngle);
-        glTranslatef(x, y, 0);
+        if (code == code1) {
+            from = point;
+            code1 = outCode(rect, from);
+        } else {
+            to = point;
+            code2 = outCode(rect, to);
+        }
+    }
+}
+
+
+void clipPolyline(std::span<const Vector2> polyline, const Transform2D& model,
+        const Rect2& rect, std::vector<Vector2>& segments)
+{
+    if (polyline.size() < 2)
+        return;
+
+    Vector2 last = model * polyline[0];
+    int lastCode = outCode(rect, last);
+    for (std::size_t i = 1; i < polyline.size(); ++i) {
+        Vector2 current = model * polyline[i];
+        int code = outCode(rect, current);
 
-        // Orientação para caracteres "em pé"
-        float rotation = (charAngle + PI<float> / 2) * 180.0f / PI<float>;
+        if ((lastCode | code) == 0) {
+            segments.push_back(last);
+            segments.push_back(current);
+        }
+        else if ((lastCode & code) == 0) { // cruza a borda (ou passa perto de um canto)
+            Vector2 from = last, to = current;
+            if (clipSegment(rect, from, to)) {
+                segments.push_back(from);
+                segments.push_back(to);
+            }
+        }
+        last = current;
+        lastCode = code;
+    }
+}
 
-        // Ajuste para orientação correta
-        if (clockwise) rotation += 180.0f;
 
-        glRotatef(rotation, 0, 0, 1);
+bool visibleRuns(std::span<const Vector2> polyline, const Transform2D& model, const Rect2& rect,
+        std::vector<Vector2>& runs, std::vector<std::uint32_t>& ends, std::vector<float>& offsets, bool closed)
+{
+    runs.clear();
+    ends.clear();
+    offsets.clear();
+    const std::size_t n = polyline.size();
+    if (n < 2)
+        return false;
+    const std::size_t segments = closed && n > 2 ? n : n - 1;
 
-        // Centralização
-        glTranslatef(-0.38f * charWidth * scale, 0.05f * charWidth * scale, 0);
-        glScalef(scale, scale, scale);
+    std::vector<bool> touches(segments);
+    Vector2 last = model * polyline[0];
+    int lastCode = outCode(rect, last);
+    for (std::size_t s = 0; s < segments; ++s) {
+        Vector2 current = model * polyline[(s + 1) % n];
+        int code = outCode(rect, current);
+        if ((lastCode | code) == 0)
+            touches[s] = true;
+        else if ((lastCode & code) == 0) {
+            Vector2 from = last, to = current;
+            touches[s] = clipSegment(rect, from, to);
+        }
+        last = current;
+        lastCode = code;
+    }
 
-        // Renderizar caractere
-        glutStrokeCharacter(GLUT_STROKE_ROMAN, *c);
-        glPopMatrix();
+    // Intervalos [primeiro, último) com um segmento a mais de cada lado: as pontas dos trechos caem no vizinho,
+    // então os vértices dos segmentos que tocam mantêm a junção original (a ponta inclinaria os lados do segmento)
+    std::vector<std::size_t> ranges;
+    float length = 0.0f;
+    for (std::size_t s = 0; s < segments; ++s) {
+        const std::size_t next = (s + 1) % n;
+        const bool previousTouches = s > 0 ? touches[s - 1] : closed && touches[segments - 1];
+        const bool nextTouches = s + 1 < segments ? touches[s + 1] : closed && touches[0];
+        if (touches[s] || previousTouches || nextTouches) {
+            if (ranges.empty() || ranges.back() != s) {
+                ranges.push_back(s);
+                ranges.push_back(s + 1);
+                offsets.push_back(length);
+            }
+            else
+                ranges.back() = s + 1;
+        }
+        length += polyline[s].distance(polyline[next]);
+    }
+    if (ranges.size() == 2 && ranges[0] == 0 && ranges[1] == segments)
+        return true;
 
-        cumulativeWidth += charWidth;
+    if (closed && segments == n && ranges.size() > 2 && ranges.front() == 0 && ranges.back() == segments) {
+        // O último trecho continua no primeiro, pelo vértice 0
+        ranges.back() = segments + ranges[1];
+        ranges.erase(ranges.begin(), ranges.begin() + 2);
+        offsets.erase(offsets.begin());
     }
+    for (std::size_t i = 0; i < ranges.size(); i += 2) {
+        for (std::size_t v = ranges[i]; v <= ranges[i + 1]; ++v)
+            runs.push_back(polyline[v % n]);
+        ends.push_back((std::uint32_t)runs.size());
+    }
+    return false;
+}
+
+
+void clipPolygon(std::span<const Vector2> contour, const Transform2D& model,
+        const Rect2& rect, std::vector<Vector2>& clipped)
+{
+    clipped.clear();
+    if (contour.empty())
+        return;
+
+    std::vector<Vector2> input;
+    input.reserve(contour.size());
+    for (Vector2 vertice : contour)
+        input.push_back(model * vertice);
+
+    // Uma passada por borda: mantém o lado de dentro e insere as interseções
+    auto clipEdge = [&](auto inside, auto intersect) {
+        clipped.clear();
+        if (input.empty())
+            return;
+        Vector2 previous = input.back();
+        bool wasInside = inside(previous);
+        for (Vector2 current : input) {
+            bool isInside = inside(current);
+            if (isInside != wasInside)
+                clipped.push_back(intersect(previous, current));
+            if (isInside)
+                clipped.push_back(current);
+            previous = current;
+            wasInside = isInside;
+        }
+        input.swap(clipped);
+    };
+    auto atX = [](float x) {
+        return [x](Vector2 a, Vector2 b) { return Vector2{ x, a.y + (b.y - a.y) * (x - a.x) / (b.x - a.x) }; };
+    };
+    auto atY = [](float y) {
+        return [y](Vector2 a, Vector2 b) { return Vector2{ a.x + (b.x - a.x) * (y - a.y) / (b.y - a.y), y }; };
+    };
+
+    clipEdge([&rect](Vector2 v) { return v.x >= rect.min.x; }, atX(rect.min.x));
+    clipEdge([&rect](Vector2 v) { return v.x <= rect.max.x; }, atX(rect.max.x));
+    clipEdge([&rect](Vector2 v) { return v.y >= rect.min.y; }, atY(rect.min.y));
+    clipEdge([&rect](Vector2 v) { return v.y <= rect.max.y; }, atY(rect.max.y));
+    clipped.swap(input);
+}
+
+
+void PolylineLod::build(std::span<const Vector2> polyline)
+{
+    const std::size_t n = polyline.size();
+    importance.assign(n, 0.0f);
+    order.resize(n);
+    isSelected = false;
+    if (n == 0)
+        return;
+
+    constexpr float INF = std::numeric_limits<float>::infinity();
+    importance.front() = importance.back() = INF;
+
+    // Douglas–Peucker iterativo: divide cada trecho no vértice mais distante da corda
+    struct Range { std::uint32_t first, last; float error; };
+    std::vector<Range> stack;
+    stack.push_back({ 0, (std::uint32_t)(n - 1), INF });
+    while (!stack.empty()) {
+        Range range = stack.back();
+        stack.pop_back();
+        if (range.last - range.first < 2)
+            continue;
+
+        Vector2 a = polyline[range.first];
+        Vector2 ab = polyline[range.last] - a;
+        float length2 = ab.dot(ab);
+        float farthest = -1.0f;
+        std::uint32_t split = range.first + 1;
+        for (std::uint32_t i = range.first + 1; i < range.last; ++i) {
+            Vector2 ap = polyline[i] - a;
+            float t = length2 > 0.0f ? std::clamp(ap.dot(ab) / length2, 0.0f, 1.0f) : 0.0f;
+            Vector2 d = ap - ab * t;
+            float distance2 = d.dot(d);
+            if (distance2 > farthest) {
+                farthest = distance2;
+                split = i;
+            }
+        }
+
+        float error = std::min(std::sqrt(farthest), range.error);
+        importance[split] = error;
+        stack.push_back({ range.first, split, error });
+        stack.push_back({ split, range.last, error });
+    }
+
+    for (std::uint32_t i = 0; i < n; ++i)
+        order[i] = i;
+    std::sort(order.begin(), order.end(), [this](std::uint32_t a, std::uint32_t b) {
+        return importance[a] > importance[b];
+    });
+}
+
+
+bool PolylineLod::select(std::span<const Vector2> polyline, float tolerance, std::uint32_t revision)
+{
+    int to = std::ilogb(std::max(tolerance, std::numeric_limits<float>::min()));
+    if (isSelected && level == to && selectedRevision == revision)
+        return false;
+    level = to;
+    selectedRevision = revision;
+    isSelected = true;
+
+    const float threshold = std::ldexp(1.0f, level);
+    auto end = std::partition_point(order.begin(), order.end(), [this, threshold](std::uint32_t i) {
+        return importance[i] > threshold;
+    });
+    const std::size_t count = end - order.begin();
+
+    vertices.clear();
+    vertices.reserve(count);
+    if (count > polyline.size() / 8) {
+        // Boa parte da polilinha: percorrer em ordem sai mais barato que ordenar os índices
+        for (std::size_t i = 0; i < polyline.size(); ++i)
+            if (importance[i] > threshold)
+                vertices.push_back(polyline[i]);
+        return true;
+    }
+
+    chosen.assign(order.begin(), end);
+    std::sort(chosen.begin(), chosen.end());
+    for (std::uint32_t i : chosen)
+        vertices.push_back(polyline[i]);
+    return true;
+}
+
+
+bool ClipCache::update(const Rect2& view, std::uint32_t item_revision)
+{
+    Vector2 size = view.getSize();
+    float guard = std::max(size.x, size.y) * GUARD_BAND;
+    Vector2 limit = size + Vector2{ 4.0f * guard }; // até o dobro da banda nova (aproximou o zoom)
+
+    if (isValid && revision == item_revision && area.contains(view)
+            && area.getSize().x <= limit.x && area.getSize().y <= limit.y)
+        return false;
+
+    area = view.grown(guard);
+    revision = item_revision;
+    isValid = true;
+    vertices.clear();
+    return true;
+}
+
+
+void dashPolyline(std::span<const Vector2> polyline, const DashPattern& pattern,
+        std::vector<Vector2>& pieces, std::vector<std::uint32_t>& ends, bool closed)
+{
+    pieces.clear();
+    ends.clear();
+    const std::size_t n = polyline.size();
+    if (n < 2)
+        return;
+    const std::size_t segments = closed && n > 2 ? n : n - 1;
+    auto pointAt = [&](std::size_t i) { return polyline[i % n]; };
+
+    float total = 0.0f;
+    for (std::size_t s = 0; s < segments; ++s)
+        total += pointAt(s).distance(pointAt(s + 1));
+    const float period = pattern.dash + pattern.gap;
+    if (pattern.isSolid() || !std::isfinite(total) || total / period > (float)MAX_DASHES) {
+        for (std::size_t i = 0; i <= segments; ++i)
+            pieces.push_back(pointAt(i));
+        ends.push_back((std::uint32_t)pieces.size());
+        return;
+    }
+
+    // Posição inicial no padrão e quanto falta para a próxima troca entre traço e espaço
+    float offset = std::fmod(pattern.phase, period);
+    if (offset < 0.0f)
+        offset += period;
+    bool isDash = offset < pattern.dash;
+    float remaining = isDash ? pattern.dash - offset : period - offset;
+    if (isDash)
+        pieces.push_back(pointAt(0));
+
+    for (std::size_t s = 0; s < segments; ++s) {
+        const Vector2 from = pointAt(s), to = pointAt(s + 1);
+        const float length = from.distance(to);
+        float position = 0.0f; // ao longo do segmento
+        while (length - position > remaining) {
+            position += remaining;
+            pieces.push_back(from + (to - from) * (position / length));
+            if (isDash)
+                ends.push_back((std::uint32_t)pieces.size());
+            isDash = !isDash;
+            remaining = isDash ? pattern.dash : pattern.gap;
+        }
+        remaining -= length - position;
+        if (isDash)
+            pieces.push_back(to);
+    }
+    if (isDash) {
+        // Traço aberto no último ponto (só o início) não aparece
+        const std::uint32_t begin = ends.empty() ? 0 : ends.back();
+        if (pieces.size() - begin >= 2)
+            ends.push_back((std::uint32_t)pieces.size());
+        else
+            pieces.resize(begin);
+    }
+}
+
+void dashSegments(std::span<const Vector2> polyline, const DashPattern& pattern,
+        std::vector<Vector2>& segments, bool closed)
+{
+    thread_local std::vector<Vector2> pieces;
+    thread_local std::vector<std::uint32_t> ends;
+    dashPolyline(polyline, pattern, pieces, ends, closed);
+
+    segments.clear();
+    std::uint32_t begin = 0;
+    for (std::uint32_t end : ends) {
+        for (std::uint32_t i = begin + 1; i < end; ++i)
+            segments.insert(segments.end(), { pieces[i - 1], pieces[i] });
+        begin = end;
+    }
+}
+
+
+namespace {
+    // Rampa de cobertura da borda: texel 0 transparente, texel 1 opaco (interpolados pela filtragem linear)
+    constexpr Vector2 RAMP_OPAQUE{ 0.75f, 0.5f }, RAMP_CLEAR{ 0.25f, 0.5f };
+
+    const Image& featherRamp()
+    {
+        static const Image ramp = [] {
+            const std::uint8_t texels[8] = { 255, 255, 255, 0, 255, 255, 255, 255 };
+            Image image;
+            image.width = 2;
+            image.height = 1;
+            image.pixels.resize(2);
+            std::memcpy(image.pixels.data(), texels, sizeof(texels));
+            image.isSmooth = true;
+            return image;
+        }();
+        return ramp;
+    }
+
+    inline Vector2 leftNormal(Vector2 direction)
+    {
+        return { -direction.y, direction.x };
+    }
+
+    inline float crossOf(Vector2 a, Vector2 b)
+    {
+        return a.x * b.y - a.y * b.x;
+    }
+
+    /** Direções unitárias de `from` (ângulo 0) até `to` (ângulo `angle`, de 0 a π), girando de `from` para `side`,
+     * nos passos da tabela do círculo unitário (`unitCircle`) para `segments` segmentos por volta; termina em `to`.
+     */
+    void arcOutline(Vector2 from, Vector2 side, Vector2 to, float angle, std::size_t segments, std::vector<Vector2>& out)
+    {
+        std::span<const Vector2> unit = unitCircle(segments);
+        const float step = TAU<float> / (float)unit.size();
+        out.push_back(from);
+        for (std::size_t k = 1; k < unit.size() && ((float)k + 0.01f) * step < angle; ++k)
+            out.push_back(from * unit[k].x + side * unit[k].y);
+        out.push_back(to);
+    }
+} // namespace
+
+void StrokeMesh::emit(Vector2 point, Vector2 core_direction, Vector2 feather_direction)
+{
+    spine.push_back(point);
+    core.push_back(core_direction);
+    feather.push_back(feather_direction);
+    const bool isEdge = feather_direction.x != 0.0f || feather_direction.y != 0.0f;
+    texcoords.push_back(isEdge ? RAMP_CLEAR : RAMP_OPAQUE);
+}
+
+void StrokeMesh::emitSegment(Vector2 from, Vector2 to, Vector2 from_left, Vector2 from_right, Vector2 to_left, Vector2 to_right)
+{
+    const Vector2 none{};
+    // Interior
+    emit(from, from_left, none); emit(to, to_left, none); emit(to, to_right, none);
+    emit(from, from_left, none); emit(to, to_right, none); emit(from, from_right, none);
+    // Bordas esmaecidas
+    for (auto [a, b] : { std::pair{ from_left, to_left }, std::pair{ from_right, to_right } }) {
+        emit(from, a, none); emit(to, b, none); emit(to, b, b);
+        emit(from, a, none); emit(to, b, b); emit(from, a, a);
+    }
+}
+
+void StrokeMesh::emitFan(Vector2 center, std::span<const Vector2> outline, std::span<const Vector2> feather_outline)
+{
+    const Vector2 none{};
+    for (std::size_t j = 0; j + 1 < outline.size(); ++j) {
+        const Vector2 c0 = outline[j], c1 = outline[j + 1], f0 = feather_outline[j], f1 = feather_outline[j + 1];
+        if (c0.x != c1.x || c0.y != c1.y) {
+            emit(center, none, none); emit(center, c0, none); emit(center, c1, none);
+        }
+        emit(center, c0, none); emit(center, c1, none); emit(center, c1, f1);
+        emit(center, c0, none); emit(center, c1, f1); emit(center, c0, f0);
+    }
+}
+
+void StrokeMesh::build(std::span<const Vector2> polyline, float stroke_width, const StrokeStyle& stroke_style, bool closed)
+{
+    reset(stroke_width, stroke_style);
+    buildDashed(polyline, style.dash, closed);
+}
+
+void StrokeMesh::build(std::span<const Vector2> runs, std::span<const std::uint32_t> ends, std::span<const float> offsets,
+        float stroke_width, const StrokeStyle& stroke_style)
+{
+    reset(stroke_width, stroke_style);
+    std::uint32_t begin = 0;
+    for (std::size_t i = 0; i < ends.size(); ++i) {
+        DashPattern dash = style.dash;
+        dash.phase += offsets[i];
+        buildDashed(runs.subspan(begin, ends[i] - begin), dash, false);
+        begin = ends[i];
+    }
+}
+
+void StrokeMesh::reset(float stroke_width, const StrokeStyle& stroke_style)
+{
+    spine.clear();
+    core.clear();
+    feather.clear();
+    texcoords.clear();
+    width = stroke_width;
+    style = stroke_style;
+    scale = 0.0f; // reposiciona no próximo `draw`
+    isValid = true;
+}
+
+void StrokeMesh::buildDashed(std::span<const Vector2> polyline, const DashPattern& dash, bool closed)
+{
+    if (dash.isSolid()) {
+        buildPiece(polyline, closed);
+        return;
+    }
+    // Cada traço do padrão é uma polilinha aberta, com as pontas do estilo
+    std::vector<Vector2> pieces;
+    std::vector<std::uint32_t> ends;
+    dashPolyline(polyline, dash, pieces, ends, closed);
+    std::uint32_t begin = 0;
+    for (std::uint32_t end : ends) {
+        buildPiece(std::span<const Vector2>(pieces).subspan(begin, end - begin), false);
+        begin = end;
+    }
+}
+
+void StrokeMesh::buildPiece(std::span<const Vector2> polyline, bool closed)
+{
+    // Vértices repetidos não têm direção
+    std::vector<Vector2> points;
+    points.reserve(polyline.size());
+    for (const Vector2& point : polyline)
+        if (points.empty() || point.x != points.back().x || point.y != points.back().y)
+            points.push_back(point);
+    if (closed && points.size() > 2 && points.front().x == points.back().x && points.front().y == points.back().y)
+        points.pop_back();
+    const std::size_t n = points.size();
+    if (n < 2)
+        return;
+    closed = closed && n > 2;
+
+    const std::size_t segments = closed ? n : n - 1;
+    std::vector<Vector2> directions(segments), normals(segments);
+    for (std::size_t s = 0; s < segments; ++s) {
+        directions[s] = (points[(s + 1) % n] - points[s]).normalized();
+        normals[s] = leftNormal(directions[s]);
+    }
+
+    // Extrusões de cada lado no início do segmento que sai do vértice e no fim do que chega nele
+    std::vector<Vector2> startLeft(n), startRight(n), endLeft(n), endRight(n);
+    const std::size_t circleDetail = circleSegments(width / 2.0f); // segmentos por volta das pontas e junções redondas
+    std::vector<Vector2> outline, featherOutline;
+    for (std::size_t i = 0; i < n; ++i) {
+        outline.clear();
+        featherOutline.clear();
+        const bool hasIn = closed || i > 0, hasOut = closed || i + 1 < n;
+
+        if (!hasIn || !hasOut) {
+            // Ponta: contorno de +normal a -normal passando pela direção de saída
+            const std::size_t s = hasOut ? i : i - 1;
+            const Vector2 normal = hasOut ? normals[s] : -normals[s];
+            const Vector2 outward = hasOut ? -directions[s] : directions[s];
+            if (hasOut) {
+                startLeft[i] = normals[s];
+                startRight[i] = -normals[s];
+            }
+            else {
+                endLeft[i] = normals[s];
+                endRight[i] = -normals[s];
+            }
+            switch (style.cap) {
+            case LineCap::BUTT:
+                outline = { normal, normal, -normal, -normal };
+                featherOutline = { normal, normal + outward, outward - normal, -normal };
+                break;
+            case LineCap::SQUARE:
+                outline = featherOutline = { normal, normal + outward, outward - normal, -normal };
+                break;
+            case LineCap::ROUND:
+                arcOutline(normal, outward, -normal, PI<float>, circleDetail, outline);
+                featherOutline = outline;
+                break;
+            }
+            emitFan(points[i], outline, featherOutline);
+            continue;
+        }
+
+        // Junção entre o segmento que chega (0) e o que sai (1)
+        const std::size_t in = (i + segments - 1) % segments, out = i % segments;
+        const Vector2 n0 = normals[in], n1 = normals[out];
+        const float turn = crossOf(directions[in], directions[out]);
+        const float denominator = 1.0f + n0.dot(n1); // 2 cos²(θ/2)
+        const bool isReversal = denominator <= 1e-6f;
+        const Vector2 miter = isReversal ? Vector2{} : (n0 + n1) / denominator; // comprimento 1 / cos(θ/2)
+        const float miterLength = isReversal ? std::numeric_limits<float>::infinity() : miter.length();
+
+        if (!isReversal && (std::abs(turn) <= 1e-6f || (style.join == LineJoin::MITER && miterLength <= style.miterLimit))) {
+            startLeft[i] = endLeft[i] = miter;
+            startRight[i] = endRight[i] = -miter;
+            continue;
+        }
+
+        // Lado interno: quina limitada ao `miterLimit`; lado externo: as normais dos dois segmentos e o preenchimento
+        const Vector2 inner = isReversal ? Vector2{} : miter * (std::min(miterLength, style.miterLimit) / miterLength);
+        Vector2 outerFrom, outerTo, innerSide;
+        if (isReversal) {
+            startLeft[i] = n1;
+            endLeft[i] = n0;
+            startRight[i] = -n1;
+            endRight[i] = -n0;
+            outerFrom = n0;
+            outerTo = n1;
+        }
+        else if (turn > 0.0f) { // vira à esquerda: o lado externo é o direito
+            startLeft[i] = endLeft[i] = innerSide = inner;
+            endRight[i] = outerFrom = -n0;
+            startRight[i] = outerTo = -n1;
+        }
+        else {
+            startRight[i] = endRight[i] = innerSide = -inner;
+            endLeft[i] = outerFrom = n0;
+            startLeft[i] = outerTo = n1;
+        }
+        if (!isReversal) {
+            // As pontas dos segmentos ficam inclinadas (da quina interna à normal): completa até o vértice
+            const Vector2 none{};
+            emit(points[i], none, none); emit(points[i], innerSide, none); emit(points[i], outerFrom, none);
+            emit(points[i], none, none); emit(points[i], outerTo, none); emit(points[i], innerSide, none);
+        }
+
+        if (style.join == LineJoin::ROUND && isReversal)
+            arcOutline(n0, directions[in], n1, PI<float>, circleDetail, outline);
+        else if (style.join == LineJoin::ROUND) {
+            const float angle = std::acos(std::clamp(outerFrom.dot(outerTo), -1.0f, 1.0f));
+            const Vector2 side = crossOf(outerFrom, outerTo) < 0.0f ? -leftNormal(outerFrom) : leftNormal(outerFrom);
+            arcOutline(outerFrom, side, outerTo, angle, circleDetail, outline);
+        }
+        else
+            outline = { outerFrom, outerTo }; // chanfro (também a quina acima do limite)
+        emitFan(points[i], outline, outline);
+    }
+
+    for (std::size_t s = 0; s < segments; ++s) {
+        const std::size_t next = (s + 1) % n;
+        emitSegment(points[s], points[next], startLeft[s], startRight[s], endLeft[next], endRight[next]);
+    }
+}
+
+void StrokeMesh::draw(const Transform2D& model, Color color)
+{
+    if (spine.empty())
+        return;
+    const float pixels = screenScale(model);
+    if (!(pixels > 0.0f) || !std::isfinite(pixels))
+        return;
+
+    if (pixels != scale) {
+        // Borda centrada no contorno: interior até meia largura - FEATHER / 2, borda até + FEATHER / 2
+        scale = pixels;
+        const float coreScale = std::max(width - FEATHER, 0.0f) / 2.0f / pixels;
+        const float featherScale = FEATHER / pixels;
+        vertices.resize(spine.size());
+
+        const float* spineData = &spine.data()->x;
+        const float* coreData = &core.data()->x;
+        const float* featherData = &feather.data()->x;
+        float* out = &vertices.data()->x;
+        const std::size_t count = 2 * spine.size();
+        std::size_t i = 0;
+#ifdef CG_SSE2
+        const __m128 coreFactor = _mm_set1_ps(coreScale), featherFactor = _mm_set1_ps(featherScale);
+        for (; i + 4 <= count; i += 4) {
+            const __m128 offset = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(coreData + i), coreFactor),
+                _mm_mul_ps(_mm_loadu_ps(featherData + i), featherFactor));
+            _mm_storeu_ps(out + i, _mm_add_ps(_mm_loadu_ps(spineData + i), offset));
+        }
+#endif
+        for (; i < count; ++i)
+            out[i] = spineData[i] + coreData[i] * coreScale + featherData[i] * featherScale;
+    }
+    RenderBackend::current().drawMaskedTriangles(featherRamp(), vertices, texcoords, model, color);
+}
+
+
+void ClippedStroke::draw(std::span<const Vector2> polyline, const Transform2D& model, const Rect2& view,
+        std::uint32_t revision, float width, const StrokeStyle& style, Color color, bool closed)
+{
+    if (clip.update(view, revision) || mesh.needsBuild(width, style)) {
+        if (visibleRuns(polyline, model, clip.area, clip.vertices, ends, offsets, closed))
+            mesh.build(polyline, width, style, closed); // nenhum segmento fica de fora
+        else
+            mesh.build(clip.vertices, ends, offsets, width, style);
+    }
+    mesh.draw(model, color);
+}
+
+void drawSolidTriangles(std::span<const Vector2> triangles, const Transform2D& model, Color color)
+{
+    // Todas as coordenadas são iguais: um só vetor, crescido sob demanda, serve a qualquer quantidade
+    thread_local std::vector<Vector2> opaque;
+    if (opaque.size() < triangles.size())
+        opaque.resize(triangles.size(), RAMP_OPAQUE);
+    RenderBackend::current().drawMaskedTriangles(featherRamp(), triangles,
+        std::span<const Vector2>(opaque.data(), triangles.size()), model, color);
 }
 
 
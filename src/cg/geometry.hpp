@@ -1,18 +1,54 @@
 #pragma once
 #include <cg/math.hpp>
+#include <cg/render_backend.hpp>
 
+#include <span>
+#include <vector>
 #include <algorithm> // std::clamp
 
 
 namespace cg
 {
 
+/** Pontos de um arco: `out[i] = center + radius * (cos, sin)(start_angle + i * step)`.
+ * Sem trigonometria por vértice: o ângulo avança por uma rotação incremental (em double, sem deriva visível
+ * mesmo com milhares de segmentos) e a escala e o deslocamento são aplicados em lote (SSE2, dois pontos por vez).
+ */
+void genArc(std::span<Vector2> out, Vector2 center, float radius, float start_angle, float step);
+
+/* Círculo com `out.size()` segmentos, a partir do ângulo 0 (para TRIANGLE_FAN ou LINE_LOOP). */
+inline void genCircle(std::span<Vector2> out, Vector2 center, float radius)
+{
+    if (!out.empty())
+        genArc(out, center, radius, 0.0f, TAU<float> / out.size());
+}
+
+/** Contorno de uma faixa anelar (para LINE_LOOP): arco externo de `startAngle` a `endAngle`, depois o interno de volta.
+ * `out.size()` deve ser `2 * (segmentos por arco + 1)`.
+ */
+void genSemiArc(std::span<Vector2> out, Vector2 center, float innerRadius, float outerRadius,
+        float startAngle, float endAngle);
+
+constexpr std::size_t STAR_VERTICES = 12; // centro e as 5 pontas alternadas com os vales, fechando o leque
+
+/** Estrela regular de 5 pontas, como TRIANGLE_FAN (primeira ponta para cima).
+ * @param innerRatio Razão do raio interno (entre 0 e 1)
+ */
+void genStar(std::span<Vector2, STAR_VERTICES> out, Vector2 center, float outerRadius, float innerRatio);
+
+constexpr std::size_t semiArcOverCircleVertexCount(std::size_t segments, std::size_t edgeSegments)
+{
+    return 2 * (segments + 1) + 4 * (edgeSegments + 1);
+}
+
 /**
  * Gera um "anel" parcial (faixa) entre dois raios (innerRadius, outerRadius)
  * de um centro arcCenter, mas somente o trecho que fica DENTRO do círculo
- * (circleCenter, circleRadius).
+ * (circleCenter, circleRadius), como TRIANGLE_STRIP.
+ * @param out `semiArcOverCircleVertexCount(segments, edgeSegments)` vértices
+ * @return Vértices escritos (0 se os centros coincidem)
  */
-void genSemiArcOverCircle(const Vector2& arcCenter, float innerRadius,
+std::size_t genSemiArcOverCircle(std::span<Vector2> out, const Vector2& arcCenter, float innerRadius,
         float outerRadius, const Vector2& circleCenter, float circleRadius,
         std::size_t segments = 64, std::size_t edgeSegments = 4);
 
@@ -21,60 +57,29 @@ void genSemiArcOverCircle(const Vector2& arcCenter, float innerRadius,
 std::pair<float, float> computeArcAngles(const Vector2& arcCenter, float radius, const Vector2& circleCenter, float circleRadius);
 
 
-/** Gera um círculo no frame buffer do Open GL
+// Versões que desenham direto no backend atual (vértices num buffer temporário)
+
+/** Gera um círculo no backend de desenho atual
  * @param center Posição do círculo, em relação ao centro
  * @param radius Raio do círculo
  * @param segments "Resolução"/ quantidade de segmentos do polígono gerado
  */
-inline void genCircle(Vector2 center, float radius, std::size_t segments)
+inline void genCircle(Vector2 center, float radius, std::size_t segments, Color color)
 {
-    glBegin(GL_POLYGON); // Inicializa o desenho de um polígono
-    float x, y;
-    float offset = TAU<float> / segments;
-    float angle = 0.0f; // current angle in radians
-    for (std::size_t i = 0; i < segments; i++) {
-        // define a coordenada de cada ponto no perímetro do círculo
-        x = center.x + radius * cosf(angle);
-        y = center.y + radius * sinf(angle);
-
-        glVertex2f(x, y);
-        angle += offset;
-    }
-    glEnd();
+    std::vector<Vector2> vertices(segments);
+    genCircle(vertices, center, radius);
+    RenderBackend::current().draw(Primitive::TRIANGLE_FAN, vertices, color);
 }
 
 
-/** Gera um semi-círculo em Open GL frame buffer
+/** Gera o contorno de um semi-círculo no backend de desenho atual
  * @param segmentsByArc quantidade de segmentos em cada arco (interno e externo)
  */
 inline void genSemiArc(Vector2 center, float innerRadius, float outerRadius,
-        float startAngle, float endAngle, std::size_t segmentsByArc) {
-    glBegin(GL_LINE_LOOP); // Inicializa o desenho de um polígono
-    float x, y;
-    float offset = (endAngle - startAngle) / segmentsByArc;
-    float angle = startAngle; // current angle in radians
-
-    // Arco externo
-    for (std::size_t i = 0; i <= segmentsByArc; i++) {
-        // define a coordenada de cada ponto no perímetro do semi-arco
-        x = center.x + outerRadius * cosf(angle);
-        y = center.y + outerRadius * sinf(angle);
-
-        glVertex2f(x, y);
-        angle += offset;
-    }
-
-    glColor3ub(0, 0, 0);
-    // Arco interno
-    for (std::size_t i = 0; i <= segmentsByArc; i++) {
-        // define a coordenada de cada ponto no perímetro do semi-arco
-        x = center.x + innerRadius * cosf(angle);
-        y = center.y + innerRadius * sinf(angle);
-
-        glVertex2f(x, y);
-        angle -= offset;
-    }
-    glEnd();
+        float startAngle, float endAngle, std::size_t segmentsByArc, Color color) {
+    std::vector<Vector2> vertices(2 * (segmentsByArc + 1));
+    genSemiArc(vertices, center, innerRadius, outerRadius, startAngle, endAngle);
+    RenderBackend::current().draw(Primitive::LINE_LOOP, vertices, color);
 }
 
 
@@ -84,56 +89,272 @@ inline void genSemiArc(Vector2 center, float innerRadius, float outerRadius,
  * @param outerRadius Raio externo (pontas)
  * @param innerRatio Razão do raio interno (entre 0 e 1)
  */
-inline void genStar(const Vector2& center, float outerRadius, float innerRatio) {
-    constexpr int numPoints = 5;
-    float innerRadius = outerRadius * std::clamp(innerRatio, 0.0f, 1.0f);
+inline void genStar(const Vector2& center, float outerRadius, float innerRatio, Color color) {
+    Vector2 vertices[STAR_VERTICES];
+    genStar(vertices, center, outerRadius, innerRatio);
+    RenderBackend::current().draw(Primitive::TRIANGLE_FAN, vertices, color);
+}
+
+
+inline void genSemiArcOverCircle(const Vector2& arcCenter, float innerRadius,
+        float outerRadius, const Vector2& circleCenter, float circleRadius, Color color,
+        std::size_t segments = 64, std::size_t edgeSegments = 4) {
+    std::vector<Vector2> strip(semiArcOverCircleVertexCount(segments, edgeSegments));
+    strip.resize(genSemiArcOverCircle(strip, arcCenter, innerRadius, outerRadius, circleCenter, circleRadius,
+        segments, edgeSegments));
+    RenderBackend::current().draw(Primitive::TRIANGLE_STRIP, strip, color);
+}
+
+
+/** Triangula um contorno simples ou auto-intersectante (regra par-ímpar), como o tesselador do GLU.
+ * Uma varredura de cima para baixo mantém as arestas ordenadas e troca as vizinhas nos cruzamentos;
+ * cada região entre duas arestas vizinhas vira um trapézio (dois triângulos) enquanto o par não muda.
+ * Saída linear em vértices mais cruzamentos, tempo O((n + k) log n).
+ * @param contour Vértices do contorno (fechado implicitamente)
+ * @param triangles Saída: trios de vértices, acrescentados ao final
+ */
+void tessellate(std::span<const Vector2> contour, std::vector<Vector2>& triangles);
+
+
+/** Recorta o segmento ao retângulo (Cohen–Sutherland), movendo as pontas para as bordas.
+ * @return false se o segmento fica inteiramente fora
+ */
+bool clipSegment(const Rect2& rect, Vector2& from, Vector2& to);
+
+
+/** Recorta uma polilinha ao retângulo, mantendo só os trechos visíveis.
+ * @param polyline Vértices locais, levados ao mundo por `model`
+ * @param segments Saída: pares de vértices de mundo (`Primitive::LINES`), acrescentados ao final
+ */
+void clipPolyline(std::span<const Vector2> polyline, const Transform2D& model,
+        const Rect2& rect, std::vector<Vector2>& segments);
+
+/** Trechos contínuos da polilinha cujos segmentos tocam o retângulo, para traços largos: os vértices são
+ * os originais (sem corte na borda), então as junções de dentro ficam intactas e as pontas dos trechos caem fora.
+ * @param polyline Vértices locais, levados ao mundo por `model` só para o teste
+ * @param runs Saída: vértices locais dos trechos, em sequência; `ends` marca o fim (exclusivo) de cada um
+ * @param offsets Saída: comprimento da polilinha antes de cada trecho (fase do tracejado)
+ * @param closed Inclui o segmento do último vértice ao primeiro (um trecho pode passar pelo vértice 0)
+ * @return true se todos os segmentos tocam o retângulo (o traço inteiro serve)
+ */
+bool visibleRuns(std::span<const Vector2> polyline, const Transform2D& model, const Rect2& rect,
+        std::vector<Vector2>& runs, std::vector<std::uint32_t>& ends, std::vector<float>& offsets,
+        bool closed = false);
+
+
+/** Recorta um contorno fechado ao retângulo (Sutherland–Hodgman).
+ * Contornos côncavos podem ganhar arestas sobre a borda do retângulo, sem área na regra par-ímpar.
+ * @param contour Vértices locais, levados ao mundo por `model`
+ * @param clipped Saída: contorno recortado em coordenadas de mundo (substitui o conteúdo)
+ */
+void clipPolygon(std::span<const Vector2> contour, const Transform2D& model,
+        const Rect2& rect, std::vector<Vector2>& clipped);
+
+
+/* Representação multi-resolução de uma polilinha, pela ordem de importância de Douglas–Peucker.
+ * Cada vértice guarda o erro com que entra na simplificação (limitado pelo do vértice que dividiu
+ * o seu trecho), então os vértices com erro acima de uma tolerância formam exatamente a
+ * simplificação de Douglas–Peucker nela. Ordenados por importância, o subconjunto sai em
+ * O(k log k) para k vértices escolhidos, independente do tamanho da polilinha.
+ */
+struct PolylineLod {
+    static constexpr std::size_t MIN_VERTICES = 64; // polilinhas menores são enviadas inteiras
+
+    std::vector<Vector2> vertices; // subconjunto selecionado, em ordem, no sistema da polilinha
 
-    glBegin(GL_TRIANGLE_FAN);
-        // Centro do fan
-        glVertex2f(center.x, center.y);
+    /* Calcula a importância dos vértices (refaça quando a polilinha mudar). */
+    void build(std::span<const Vector2> polyline);
 
-        // Gera os vértices alternando externo e interno
-        for (int i = 0; i <= numPoints * 2; ++i) {
-            float angle = PI<float> / 2 - i * (PI<float> / numPoints); // começa pra cima
-            float radius = (i % 2 == 0) ? outerRadius : innerRadius;
+    /** Seleciona os vértices com erro acima de `tolerance`, arredondada para baixo a uma potência de 2
+     * (a seleção só é refeita quando o nível muda ou `revision` difere da última).
+     * @return true se `vertices` foi refeito
+     */
+    bool select(std::span<const Vector2> polyline, float tolerance, std::uint32_t revision);
 
-            float x = center.x + radius * std::cos(angle);
-            float y = center.y + radius * std::sin(angle);
+private:
+    std::vector<float> importance; // erro de cada vértice (infinito nas pontas)
+    std::vector<std::uint32_t> order; // índices por importância decrescente
+    std::vector<std::uint32_t> chosen;
+    int level = 0;
+    std::uint32_t selectedRevision = 0;
+    bool isSelected = false;
+};
 
-            glVertex2f(x, y);
-        }
-    glEnd();
+
+/* Geometria de um item recortada à área visível, em coordenadas de mundo.
+ * O recorte usa a vista com uma banda de guarda em volta, então pequenos deslocamentos da câmera
+ * reaproveitam o resultado; ele é refeito quando a vista sai da banda, o zoom aproxima demais
+ * ou a geometria do item muda (revisão de `CanvasItem::invalidate`).
+ */
+struct ClipCache {
+    static constexpr std::size_t MIN_VERTICES = 64; // itens menores são enviados inteiros
+    static constexpr float GUARD_BAND = 0.5f; // folga de cada lado, em frações do maior lado da vista
+
+    Rect2 area; // vista com a banda de guarda usada no último recorte
+    std::uint32_t revision = 0;
+    bool isValid = false;
+    std::vector<Vector2> vertices;
+
+    /* Retorna true se o recorte deve ser refeito para `view` (já atualizando `area`). */
+    bool update(const Rect2& view, std::uint32_t item_revision);
+};
+
+
+/* Curvas adaptadas à tela: o número de segmentos segue o tamanho em pixels, não o raio no mundo. */
+constexpr float CURVE_MAX_ERROR = 0.25f; // desvio máximo da corda em relação ao arco, em pixels
+constexpr std::size_t CURVE_MIN_SEGMENTS = 8;
+constexpr std::size_t CURVE_MAX_SEGMENTS = 2048;
+
+/** Segmentos de um círculo de `screen_radius` pixels cujas cordas desviam no máximo `max_error` pixels do arco
+ * (sagita r(1 - cos(π/n)) <= erro), entre CURVE_MIN_SEGMENTS e CURVE_MAX_SEGMENTS.
+ */
+std::size_t circleSegments(float screen_radius, float max_error = CURVE_MAX_ERROR);
+
+/** Pontos do círculo unitário com pelo menos `segments` segmentos, a partir do ângulo 0.
+ * As contagens são agrupadas em faixas de detalhe de 2^(1/4) e cada faixa é gerada uma vez e mantida em cache
+ * (seguro entre threads): o tamanho retornado é o da faixa.
+ */
+std::span<const Vector2> unitCircle(std::size_t segments);
+
+/* Pixels por unidade local de um item: zoom do backend vezes a maior escala do modelo. */
+inline float screenScale(const Transform2D& model)
+{
+    Vector2 scale = model.getScale();
+    return RenderBackend::current().getPixelsPerUnit() * std::max(std::abs(scale.x), std::abs(scale.y));
 }
 
+enum class LineJoin { MITER, BEVEL, ROUND };
+enum class LineCap { BUTT, SQUARE, ROUND };
 
-/**
- * Desenha um texto ao longo de um arco de círculo.
- *
- * @param text Texto a ser desenhado
- * @param radius Raio do arco
- * @param startAngle Ângulo de início do arco (em radianos)
- * @param endAngle Ângulo de fim do arco (em radianos)
- * @param scale Fator de escala para o texto
- *
- * @note A direção do texto depende do sinal do ângulo de abertura.
- *       Se o ângulo for negativo, o texto será desenhado no sentido horário.
+/* Tracejado: traços de `dash` e espaços de `gap` ao longo do comprimento de arco, começando `phase` adiante
+ * no padrão. Os comprimentos estão nas unidades dos vértices; sem traço ou sem espaço, a linha é contínua.
+ */
+struct DashPattern {
+    float dash = 0.0f;
+    float gap = 0.0f;
+    float phase = 0.0f;
+
+    inline bool isSolid() const {
+        return !(dash > 0.0f && gap > 0.0f);
+    }
+
+    bool operator==(const DashPattern&) const = default;
+};
+
+constexpr std::size_t MAX_DASHES = std::size_t(1) << 20;
+
+/** Divide a polilinha nos traços do padrão pelo comprimento de arco acumulado: só as pontas dos traços
+ * são interpoladas (os vértices internos são os originais), sem passos intermediários.
+ * Padrões com mais de MAX_DASHES traços na polilinha saem contínuos (um traço).
+ * @param pieces Saída: vértices dos traços, um após o outro
+ * @param ends Saída: fim (exclusivo) de cada traço em `pieces`
+ * @param closed Inclui o trecho do último vértice ao primeiro
+ */
+void dashPolyline(std::span<const Vector2> polyline, const DashPattern& pattern,
+        std::vector<Vector2>& pieces, std::vector<std::uint32_t>& ends, bool closed = false);
+
+/* Os traços do padrão como pares de pontos (`Primitive::LINES`), para as linhas finas do backend. */
+void dashSegments(std::span<const Vector2> polyline, const DashPattern& pattern,
+        std::vector<Vector2>& segments, bool closed = false);
+
+struct StrokeStyle {
+    LineJoin join = LineJoin::ROUND;
+    LineCap cap = LineCap::ROUND;
+    float miterLimit = 4.0f; // comprimento máximo da quina, em meias larguras (acima disso: chanfro)
+    DashPattern dash; // contínuo por padrão
+
+    bool operator==(const StrokeStyle&) const = default;
+};
+
+/* Traço largo de uma polilinha expandido em triângulos na CPU, com junções, pontas e uma borda
+ * esmaecida de um pixel (cobertura por uma rampa de alpha, via `RenderBackend::drawMaskedTriangles`).
+ * A largura é em pixels de tela, então a malha guarda, para cada vértice, o ponto da polilinha e as direções
+ * da extrusão (sem a escala): as junções só são recalculadas quando a polilinha ou o estilo mudam, e a cada
+ * zoom novo os vértices são apenas reposicionados (SSE2), num custo linear sem depender das junções.
+ */
+struct StrokeMesh {
+    static constexpr float FEATHER = 1.0f; // largura da borda esmaecida, em pixels
+
+    bool isValid = false; // invalide ao mudar a polilinha
+    float width = 0.0f; // pixels, da última construção
+    StrokeStyle style;
+
+    /* Retorna true se a malha deve ser refeita para a largura e o estilo. */
+    inline bool needsBuild(float stroke_width, const StrokeStyle& stroke_style) const {
+        return !isValid || width != stroke_width || !(style == stroke_style);
+    }
+
+    /** Expande a polilinha (coordenadas locais) em triângulos.
+     * @param closed Liga o último vértice ao primeiro (junção no lugar das pontas)
+     */
+    void build(std::span<const Vector2> polyline, float stroke_width, const StrokeStyle& stroke_style, bool closed = false);
+
+    /** Idem para trechos abertos de uma mesma polilinha (ver `visibleRuns`).
+     * @param ends Fim (exclusivo) de cada trecho em `runs`
+     * @param offsets Comprimento da polilinha antes de cada trecho, para o tracejado seguir a polilinha inteira
+     */
+    void build(std::span<const Vector2> runs, std::span<const std::uint32_t> ends, std::span<const float> offsets,
+            float stroke_width, const StrokeStyle& stroke_style);
+
+    /* Submete o traço numa chamada, com a escala de pixels da vista atual e de `model`. */
+    void draw(const Transform2D& model, Color color);
+
+    inline std::size_t size() const {
+        return spine.size();
+    }
+
+private:
+    // Vértice = spine + core * (meia largura - FEATHER / 2) + feather * FEATHER, em unidades locais
+    void emit(Vector2 point, Vector2 core, Vector2 feather);
+    // Corpo e bordas de um segmento, com as extrusões de cada lado nas duas pontas
+    void emitSegment(Vector2 from, Vector2 to, Vector2 from_left, Vector2 from_right, Vector2 to_left, Vector2 to_right);
+    void emitFan(Vector2 center, std::span<const Vector2> outline, std::span<const Vector2> feather); // junções e pontas
+    void reset(float stroke_width, const StrokeStyle& stroke_style);
+    void buildDashed(std::span<const Vector2> polyline, const DashPattern& dash, bool closed); // traços do padrão
+    void buildPiece(std::span<const Vector2> polyline, bool closed); // acrescenta uma polilinha contínua
+
+    std::vector<Vector2> spine, core, feather;
+    std::vector<Vector2> texcoords; // na rampa: interior opaco, borda externa transparente
+    std::vector<Vector2> vertices; // posicionados para `scale`
+    float scale = 0.0f; // pixels por unidade local do último posicionamento
+};
+
+
+/* Traço largo de um item que atravessa a borda da vista: só os trechos perto dela viram triângulos,
+ * refeitos quando o recorte (`ClipCache`) precisa ser refeito ou a largura e o estilo mudam.
+ */
+struct ClippedStroke {
+    ClipCache clip; // `clip.vertices` guarda os trechos de `visibleRuns`
+    std::vector<std::uint32_t> ends;
+    std::vector<float> offsets;
+    StrokeMesh mesh;
+
+    /* Desenha a polilinha (local) recortada a `view`; invalide `clip` ao trocar o nível de detalhe. */
+    void draw(std::span<const Vector2> polyline, const Transform2D& model, const Rect2& view, std::uint32_t revision,
+            float width, const StrokeStyle& style, Color color, bool closed = false);
+};
+
+
+/* Triângulos opacos submetidos pelo caminho dos traços (mesma máscara), para que o backend
+ * desenhe preenchimentos e contornos vizinhos na ordem de desenho num mesmo lote.
  */
-void drawArcText(const char* text, float radius, float startAngle, float endAngle, float scale);
+void drawSolidTriangles(std::span<const Vector2> triangles, const Transform2D& model, Color color);
 
 
 /** Gera um círculo com base na qualidade.
+ * Os segmentos só dependem do raio no mundo; para acompanhar o zoom, use `circleSegments` e `unitCircle`.
  * @param quality Fator de suavidade ajustável. Quanto maior, mais segmentos.
  * @param min_offset Quantidade mínima de segmentos.
  * @param limit Quantidade máxima de segmentos.
  */
-inline void genCircleAuto(Vector2 center, float radius, float quality = 1.5f, int min_offset = 12, int limit = 2048) {
+inline void genCircleAuto(Vector2 center, float radius, Color color, float quality = 1.5f, int min_offset = 12, int limit = 2048) {
     int segs = int(quality * radius) + min_offset; // Valor base linear + offset mínimo
-    genCircle(center, radius, std::min(segs, limit));
+    genCircle(center, radius, std::min(segs, limit), color);
 }
 
 
-inline void genCircleAuto(float x, float y, float radius, float quality = 1.5f, int min_offset = 12, int limit = 2048) {
-    genCircleAuto({x, y}, radius, quality, min_offset, limit);
+inline void genCircleAuto(float x, float y, float radius, Color color, float quality = 1.5f, int min_offset = 12, int limit = 2048) {
+    genCircleAuto({x, y}, radius, color, quality, min_offset, limit);
 }
 
 
@@ -0,0 +1,245 @@
+﻿#include "image_export.hpp"
+
+#include <array>
+#include <vector>
+#include <memory>
+#include <cctype>
+#include <cstdint>
+#include <algorithm>
+
+#include "canvas.hpp"
+#include "software_backend.hpp"
+
+
+namespace cg {
+
+	namespace {
+
+		// Codificador que recebe a imagem em faixas de linhas RGBA8 (de cima para baixo).
+		class ImageWriter {
+		public:
+			virtual ~ImageWriter() = default;
+			virtual void begin(int width, int height) = 0;
+			virtual void writeRows(const std::uint32_t* pixels, int rows) = 0;
+			virtual void end() = 0;
+
+		protected:
+			ImageWriter(std::ostream& os) : os{ os } {}
+
+			// Converte uma linha RGBA8 em RGB8 (o alpha não aparece na janela)
+			void appendRgb(std::vector<std::uint8_t>& out, const std::uint32_t* row, int width) {
+				auto bytes = reinterpret_cast<const std::uint8_t*>(row);
+				for (int x = 0; x < width; ++x, bytes += 4)
+					out.insert(out.end(), bytes, bytes + 3);
+			}
+
+			std::ostream& os;
+			int width = 0;
+		};
+
+		// PPM binário (P6): cabeçalho em texto e as linhas RGB em sequência.
+		class PpmWriter : public ImageWriter {
+		public:
+			PpmWriter(std::ostream& os) : ImageWriter{ os } {}
+
+			void begin(int width, int height) override {
+				this->width = width;
+				os << "P6\n" << width << ' ' << height << "\n255\n";
+			}
+
+			void writeRows(const std::uint32_t* pixels, int rows) override {
+				buffer.clear();
+				for (int y = 0; y < rows; ++y)
+					appendRgb(buffer, pixels + (std::size_t)y * width, width);
+				os.write((const char*)buffer.data(), (std::streamsize)buffer.size());
+			}
+
+			void end() override {}
+
+		private:
+			std::vector<std::uint8_t> buffer;
+		};
+
+		/** PNG RGB8 com deflate em blocos "stored" (sem compressão, sem dependência de zlib).
+		 * O fluxo zlib atravessa vários chunks IDAT: um por faixa, terminado por um bloco final vazio e o Adler-32.
+		 */
+		class PngWriter : public ImageWriter {
+		public:
+			PngWriter(std::ostream& os) : ImageWriter{ os } {}
+
+			void begin(int width, int height) override {
+				this->width = width;
+				static constexpr std::uint8_t signature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+				os.write((const char*)signature, sizeof(signature));
+
+				std::vector<std::uint8_t> header;
+				putU32(header, (std::uint32_t)width);
+				putU32(header, (std::uint32_t)height);
+				header.insert(header.end(), { 8, 2, 0, 0, 0 }); // 8 bits, RGB, deflate, filtro 0, sem entrelaçamento
+				writeChunk("IHDR", header);
+
+				isFirstData = true;
+				adlerA = 1, adlerB = 0;
+			}
+
+			void writeRows(const std::uint32_t* pixels, int rows) override {
+				raw.clear();
+				for (int y = 0; y < rows; ++y) {
+					raw.push_back(0); // filtro "None"
+					appendRgb(raw, pixels + (std::size_t)y * width, width);
+				}
+				updateAdler(raw);
+
+				data.clear();
+				startZlib();
+				for (std::size_t offset = 0; offset < raw.size(); offset += MAX_STORED) {
+					std::size_t length = std::min(MAX_STORED, raw.size() - offset);
+					putStoredHeader(data, false, length);
+					data.insert(data.end(), raw.begin() + offset, raw.begin() + offset + length);
+				}
+				writeChunk("IDAT", data);
+			}
+
+			void end() override {
+				data.clear();
+				startZlib();
+				putStoredHeader(data, true, 0);
+				putU32(data, (adlerB << 16) | adlerA);
+				writeChunk("IDAT", data);
+				writeChunk("IEND", {});
+			}
+
+		private:
+			static constexpr std::size_t MAX_STORED = 65535;
+
+			static void putU32(std::vector<std::uint8_t>& out, std::uint32_t value) {
+				out.insert(out.end(), { (std::uint8_t)(value >> 24), (std::uint8_t)(value >> 16),
+					(std::uint8_t)(value >> 8), (std::uint8_t)value });
+			}
+
+			static void putStoredHeader(std::vector<std::uint8_t>& out, bool final, std::size_t length) {
+				out.insert(out.end(), { (std::uint8_t)(final ? 1 : 0),
+					(std::uint8_t)length, (std::uint8_t)(length >> 8),
+					(std::uint8_t)~length, (std::uint8_t)(~length >> 8) });
+			}
+
+			void startZlib() {
+				if (isFirstData)
+					data.insert(data.end(), { 0x78, 0x01 }); // deflate, janela de 32 KiB, sem dicionário
+				isFirstData = false;
+			}
+
+			void updateAdler(const std::vector<std::uint8_t>& bytes) {
+				constexpr std::uint32_t MOD = 65521;
+				constexpr std::size_t NMAX = 5552; // maior bloco sem estourar 32 bits antes do módulo
+				for (std::size_t i = 0; i < bytes.size();) {
+					std::size_t end = std::min(bytes.size(), i + NMAX);
+					for (; i < end; ++i) {
+						adlerA += bytes[i];
+						adlerB += adlerA;
+					}
+					adlerA %= MOD;
+					adlerB %= MOD;
+				}
+			}
+
+			static std::uint32_t crc32(std::uint32_t crc, const std::uint8_t* bytes, std::size_t size) {
+				static const std::array<std::uint32_t, 256> table = [] {
+					std::array<std::uint32_t, 256> t{};
+					for (std::uint32_t n = 0; n < 256; ++n) {
+						std::uint32_t c = n;
+						for (int k = 0; k < 8; ++k)
+							c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+						t[n] = c;
+					}
+					return t;
+				}();
+				for (std::size_t i = 0; i < size; ++i)
+					crc = table[(crc ^ bytes[i]) & 0xFF] ^ (crc >> 8);
+				return crc;
+			}
+
+			void writeChunk(const char type[4], const std::vector<std::uint8_t>& payload) {
+				std::vector<std::uint8_t> length;
+				putU32(length, (std::uint32_t)payload.size());
+				os.write((const char*)length.data(), 4);
+				os.write(type, 4);
+				os.write((const char*)payload.data(), (std::streamsize)payload.size());
+
+				std::uint32_t crc = crc32(0xFFFFFFFFu, (const std::uint8_t*)type, 4);
+				crc = crc32(crc, payload.data(), payload.size()) ^ 0xFFFFFFFFu;
+				std::vector<std::uint8_t> footer;
+				putU32(footer, crc);
+				os.write((const char*)footer.data(), 4);
+			}
+
+			std::vector<std::uint8_t> raw, data;
+			std::uint32_t adlerA = 1, adlerB = 0;
+			bool isFirstData = true;
+		};
+
+	} // namespace
+
+
+	ImageFormat imageFormatFromPath(const std::string& path)
+	{
+		std::string extension = path.size() >= 4 ? path.substr(path.size() - 4) : "";
+		std::transform(extension.begin(), extension.end(), extension.begin(), [](unsigned char c) { return (char)std::tolower(c); });
+		return extension == ".ppm" ? ImageFormat::PPM : ImageFormat::PNG;
+	}
+
+	bool exportImage(Canvas& canvas, std::ostream& os, const ImageExportOptions& options)
+	{
+		const int width = options.width, height = options.height;
+		if (width <= 0 || height <= 0) {
+			print_error("Invalid export size %dx%d.", width, height);
+			return false;
+		}
+
+		std::unique_ptr<ImageWriter> writer;
+		if (options.format == ImageFormat::PPM)
+			writer = std::make_unique<PpmWriter>(os);
+		else
+			writer = std::make_unique<PngWriter>(os);
+
+		// Área visível da câmera ajustada à imagem (mesma proporção, centralizada)
+		const Camera& camera = canvas.getCamera();
+		const Vector2 window = canvas.getWindowSize();
+		const float fit = std::min(width / window.x, height / window.y); // ampliação em relação à janela
+		const float scale = fit * camera.getZoom(); // pixels da imagem por unidade do mundo
+		const Vector2 center = camera.getPosition();
+
+		const int strip = std::clamp(options.stripHeight, 1, height);
+		SoftwareBackend backend{ width, strip, options.threads };
+		backend.setPixelsPerUnit(scale);
+		ScopedBackend scope{ backend };
+
+		canvas.waitOverview(); // agregados completos, para a mesma imagem a cada exportação
+		writer->begin(width, height);
+		for (int y = 0; y < height && os.good(); y += strip) {
+			// Mundo -> pixels da imagem, deslocado para a faixa [y, y + strip)
+			backend.setView({ { scale, 0.0f }, { 0.0f, -scale },
+				{ width / 2.0f - center.x * scale, height / 2.0f + center.y * scale - y } }, fit);
+			backend.clear(options.background);
+
+			// Só os itens que tocam a faixa
+			const Rect2 area{
+				{ center.x - width / 2.0f / scale, center.y + (height / 2.0f - (y + strip)) / scale },
+				{ center.x + width / 2.0f / scale, center.y + (height / 2.0f - y) / scale },
+			};
+			canvas.renderItems(area);
+			backend.flush();
+			writer->writeRows(backend.getPixels(), std::min(strip, height - y));
+		}
+		if (os.good())
+			writer->end();
+		os.flush();
+
+		if (!os.good()) {
+			print_error("Failed to write the exported image.");
+			return false;
+		}
+		return true;
+	}
+
+} // namespace cg
@@ -0,0 +1,40 @@
+﻿#pragma once
+/* Exportação de imagens grandes (impressão) sem depender do tamanho da janela nem do viewport do GL.
+ *
+ * A área visível da câmera do Canvas é ampliada para o tamanho pedido e rasterizada em CPU (SoftwareBackend)
+ * uma faixa de linhas por vez; cada faixa é enviada ao codificador (PPM ou PNG) assim que fica pronta,
+ * então a memória usada é a de uma faixa, não a da imagem inteira. Os blocos de cada faixa são
+ * rasterizados em paralelo pelas threads do backend.
+ */
+
+#include <string>
+#include <ostream>
+
+#include "math.hpp"
+
+
+namespace cg {
+
+    class Canvas;
+
+    enum class ImageFormat { PPM, PNG };
+
+    struct ImageExportOptions {
+        int width = 0, height = 0; // tamanho da imagem em pixels
+        Color background{ 0.1333f, 0.1333f, 0.1333f, 1.0f }; // fundo da aplicação
+        ImageFormat format = ImageFormat::PNG;
+        int stripHeight = 256; // linhas rasterizadas por vez (limita a memória)
+        unsigned threads = 0; // threads de rasterização (0: as do `ThreadPool::shared`, uma por núcleo)
+    };
+
+    /* Formato pela extensão do arquivo: `.ppm` ou PNG (padrão). */
+    ImageFormat imageFormatFromPath(const std::string& path);
+
+    /** Renderiza os itens do Canvas (sem ferramentas nem GUI) e grava a imagem em `os` (modo binário).
+     * A área visível da câmera é ajustada ao tamanho pedido, mantendo a proporção e centralizada;
+     * tamanhos de ponto e larguras de linha acompanham a ampliação.
+     * Retorna `false` se o tamanho for inválido ou a escrita falhar.
+     */
+    bool exportImage(Canvas& canvas, std::ostream& os, const ImageExportOptions& options);
+
+} // namespace cg
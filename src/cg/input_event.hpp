@@ -1,17 +1,43 @@
 ﻿#pragma once
 
+#include <chrono>
+
 namespace cg {
+    using TimePoint = std::chrono::steady_clock::time_point;
 
     namespace io {
         class Canvas;
 
+        // Códigos das teclas especiais usadas pelas ferramentas (mesmos valores do GLUT).
+        namespace keys {
+            constexpr int F1 = 1;
+            constexpr int F2 = 2;
+            constexpr int F3 = 3;
+            constexpr int F4 = 4;
+            constexpr int LEFT = 100;
+            constexpr int UP = 101;
+            constexpr int RIGHT = 102;
+            constexpr int DOWN = 103;
+            constexpr int DEL = 111;
+        }
+
+        // Bits de `KeyInputEvent::mods` (mesmos valores do GLUT).
+        namespace mods {
+            constexpr int SHIFT = 1;
+            constexpr int CTRL = 2;
+            constexpr int ALT = 4;
+        }
+
         struct InputEvent {
             Vector2 position; // mouse position on screen
+            TimePoint timestamp; // instante em que a callback da janela recebeu o evento
             // Transforms mouse Screen Coordinates to Normalized Device Coordinates before creating the event.
-            InputEvent(Vector2 position) : position{ position } {}
+            InputEvent(Vector2 position) : position{ position }, timestamp{ std::chrono::steady_clock::now() } {}
 		};
 
-        struct FocusInputEvent {};
+        struct FocusInputEvent {
+            TimePoint timestamp = std::chrono::steady_clock::now();
+        };
         struct FocusIn : public FocusInputEvent {};
         struct FocusOut : public FocusInputEvent {};
 
@@ -34,6 +60,12 @@ namespace cg {
         struct MouseLeftButtonReleased : public MouseInputEvent {
             MouseLeftButtonReleased(Vector2 position) : MouseInputEvent{ position } {}
         };
+        struct MouseMiddleButtonPressed : public MouseInputEvent {
+            MouseMiddleButtonPressed(Vector2 position) : MouseInputEvent{ position } {}
+        };
+        struct MouseMiddleButtonReleased : public MouseInputEvent {
+            MouseMiddleButtonReleased(Vector2 position) : MouseInputEvent{ position } {}
+        };
         struct MouseWheelV : public MouseInputEvent {
             int direction; // direction moved △y
 
@@ -46,7 +78,7 @@ namespace cg {
         };
 
         struct KeyInputEvent : InputEvent {
-			int key; // key code (ASCII if keyboard, or GLUT Enum if special)
+			int key; // key code (ASCII if keyboard, or `io::keys` if special)
             int mods; // bit field describing which modifier keys were held down
             KeyInputEvent(Vector2 position, int key, int mods) : InputEvent{ position }, key{ key }, mods{ mods } {}
 		};
@@ -0,0 +1,95 @@
+﻿#pragma once
+
+#include <deque>
+#include <variant>
+#include <chrono>
+
+#include "math.hpp"
+#include "input_event.hpp"
+
+
+namespace cg {
+
+    namespace io {
+        // Todos os eventos que o Canvas pode receber das callbacks da janela.
+        using Event = std::variant<
+            FocusIn, FocusOut,
+            MouseMove, MouseDrag,
+            MouseLeftButtonPressed, MouseLeftButtonReleased,
+            MouseRightButtonPressed, MouseRightButtonReleased,
+            MouseMiddleButtonPressed, MouseMiddleButtonReleased,
+            MouseWheelV, MouseWheelH,
+            KeyboardInputEvent, SpecialKeyInputEvent
+        >;
+    } // namespace io
+
+
+    /** Fila de eventos de entrada, esvaziada uma vez por quadro.
+     * As callbacks da janela apenas registram o evento (que já carrega o instante de chegada). Eventos
+     * consecutivos de movimento (`MouseMove`/`MouseDrag`) são agrupados na última posição, então
+     * a quantidade de trabalho por quadro não depende da taxa de amostragem do mouse/mesa digitalizadora.
+     * A ordem relativa entre os eventos discretos (cliques, teclas, foco) é sempre preservada.
+     */
+    class InputQueue {
+    public:
+        // Limite de eventos despachados por quadro; o restante fica para o próximo quadro.
+        static constexpr size_t MAX_EVENTS_PER_FRAME = 64;
+        template <typename E>
+        void push(E event) {
+            if constexpr (std::is_same_v<E, io::MouseMove>) {
+                if (!pending.empty() && std::holds_alternative<io::MouseMove>(pending.back())) {
+                    std::get<io::MouseMove>(pending.back()).position = event.position;
+                    ++coalesced;
+                    return;
+                }
+            }
+            else if constexpr (std::is_same_v<E, io::MouseDrag>) {
+                if (!pending.empty() && std::holds_alternative<io::MouseDrag>(pending.back())) {
+                    std::get<io::MouseDrag>(pending.back()).position = event.position;
+                    ++coalesced;
+                    return;
+                }
+            }
+            pending.push_back(io::Event{ std::move(event) }); // o `timestamp` fica o do primeiro evento agrupado
+        }
+
+        /** Despacha até `MAX_EVENTS_PER_FRAME` eventos em ordem de chegada para `handler`.
+         * Retorna a quantidade de eventos despachados.
+         */
+        template <typename Handler>
+        size_t dispatch(Handler&& handler) {
+            size_t count = 0;
+            while (!pending.empty() && count < MAX_EVENTS_PER_FRAME) {
+                // Retira antes de despachar: o handler pode enfileirar novos eventos.
+                io::Event event = std::move(pending.front());
+                pending.pop_front();
+
+                std::visit([&](auto& e) { handler(e); }, event);
+                ++count;
+            }
+            return count;
+        }
+
+        inline size_t size() const {
+            return pending.size();
+        }
+
+        inline bool empty() const {
+            return pending.empty();
+        }
+
+        // Quantidade de eventos de movimento absorvidos por agrupamento desde o início.
+        inline size_t getCoalescedCount() const {
+            return coalesced;
+        }
+
+        inline void clear() {
+            pending.clear();
+        }
+
+    private:
+        std::deque<io::Event> pending;
+        size_t coalesced = 0;
+    };
+
+} // namespace cg
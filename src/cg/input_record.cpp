@@ -0,0 +1,157 @@
+﻿#include "input_record.hpp"
+
+#include <sstream>
+
+#include "canvas.hpp"
+
+
+namespace cg {
+
+	static constexpr const char* RECORD_HEADER = "CGInput";
+	static constexpr int RECORD_VERSION = 1;
+
+	bool InputRecorder::open(const std::string& path, Vector2 window_size)
+	{
+		ofs.open(path);
+		if (!ofs.is_open()) {
+			print_error("Failed to open input record file: %s", path.c_str());
+			return false;
+		}
+		start = std::chrono::steady_clock::now();
+		ofs << RECORD_HEADER << ' ' << RECORD_VERSION << '\n';
+		recordWindow(window_size);
+		print_info("Recording input to %s", path.c_str());
+		return true;
+	}
+
+	void InputRecorder::close()
+	{
+		if (ofs.is_open())
+			ofs.close();
+	}
+
+	void InputRecorder::recordWindow(Vector2 size)
+	{
+		if (ofs.is_open())
+			ofs << "window " << (int)size.x << ' ' << (int)size.y << '\n';
+	}
+
+	void InputRecorder::recordFrame()
+	{
+		if (ofs.is_open())
+			ofs << "frame " << elapsed() << '\n';
+	}
+
+	double InputRecorder::elapsed() const
+	{
+		return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+	}
+
+
+	bool InputReplayer::load(const std::string& path)
+	{
+		std::ifstream ifs(path);
+		if (!ifs.is_open()) {
+			print_error("Failed to open input record file: %s", path.c_str());
+			return false;
+		}
+
+		std::string header;
+		int version = 0;
+		if (!(ifs >> header >> version) || header != RECORD_HEADER || version != RECORD_VERSION) {
+			print_error("Invalid input record file: %s", path.c_str());
+			return false;
+		}
+
+		frames.clear();
+		next = 0;
+		Frame current;
+		std::string line;
+		size_t line_number = 1;
+
+		while (std::getline(ifs, line)) {
+			++line_number;
+			std::istringstream iss(line);
+			std::string name;
+			if (!(iss >> name))
+				continue; // linha vazia
+
+			if (name == "frame") {
+				iss >> current.time;
+				frames.push_back(std::move(current));
+				current = {};
+				continue;
+			}
+
+			Record record{ name };
+			if (name == "window") {
+				record.isResize = true;
+				iss >> record.a >> record.b;
+			}
+			else {
+				double time;
+				iss >> time;
+				if (name != "FocusIn" && name != "FocusOut")
+					iss >> record.x >> record.y;
+				iss >> record.a >> record.b; // opcionais
+			}
+
+			if (iss.fail() && !iss.eof()) {
+				print_warning("Malformed input record at line %zu, skipping: %s", line_number, line.c_str());
+				continue;
+			}
+			current.records.push_back(std::move(record));
+		}
+
+		if (!current.records.empty()) // eventos após o último quadro
+			frames.push_back(std::move(current));
+
+		print_info("Loaded %zu recorded frames from %s", frames.size(), path.c_str());
+		return !frames.empty();
+	}
+
+	bool InputReplayer::feed(Canvas& canvas, const ResizeCallback& on_resize)
+	{
+		if (isFinished())
+			return false;
+
+		for (const Record& r : frames[next].records) {
+			if (r.isResize) {
+				on_resize(r.a, r.b);
+			}
+			else if (r.name == io::event_name<io::MouseMove>())
+				canvas.queueScreenInput<io::MouseMove>(r.x, r.y);
+			else if (r.name == io::event_name<io::MouseDrag>())
+				canvas.queueScreenInput<io::MouseDrag>(r.x, r.y);
+			else if (r.name == io::event_name<io::MouseLeftButtonPressed>())
+				canvas.queueScreenInput<io::MouseLeftButtonPressed>(r.x, r.y);
+			else if (r.name == io::event_name<io::MouseLeftButtonReleased>())
+				canvas.queueScreenInput<io::MouseLeftButtonReleased>(r.x, r.y);
+			else if (r.name == io::event_name<io::MouseRightButtonPressed>())
+				canvas.queueScreenInput<io::MouseRightButtonPressed>(r.x, r.y);
+			else if (r.name == io::event_name<io::MouseRightButtonReleased>())
+				canvas.queueScreenInput<io::MouseRightButtonReleased>(r.x, r.y);
+			else if (r.name == io::event_name<io::MouseMiddleButtonPressed>())
+				canvas.queueScreenInput<io::MouseMiddleButtonPressed>(r.x, r.y);
+			else if (r.name == io::event_name<io::MouseMiddleButtonReleased>())
+				canvas.queueScreenInput<io::MouseMiddleButtonReleased>(r.x, r.y);
+			else if (r.name == io::event_name<io::MouseWheelV>())
+				canvas.queueScreenInput<io::MouseWheelV>(r.x, r.y, r.a);
+			else if (r.name == io::event_name<io::MouseWheelH>())
+				canvas.queueScreenInput<io::MouseWheelH>(r.x, r.y, r.a);
+			else if (r.name == io::event_name<io::KeyboardInputEvent>())
+				canvas.queueScreenInput<io::KeyboardInputEvent>(r.x, r.y, r.a, r.b);
+			else if (r.name == io::event_name<io::SpecialKeyInputEvent>())
+				canvas.queueScreenInput<io::SpecialKeyInputEvent>(r.x, r.y, r.a, r.b);
+			else if (r.name == io::event_name<io::FocusIn>())
+				canvas.input.push(io::FocusIn{});
+			else if (r.name == io::event_name<io::FocusOut>())
+				canvas.input.push(io::FocusOut{});
+			else
+				print_warning("Unknown recorded event '%s', ignoring.", r.name.c_str());
+		}
+		++next;
+		return true;
+	}
+
+} // namespace cg
@@ -0,0 +1,130 @@
+﻿#pragma once
+/* Gravação e reprodução determinística da entrada do usuário.
+ * O arquivo é texto, uma linha por registro (tempos em ms desde o início da gravação):
+ *
+ *     CGInput 1
+ *     window <largura> <altura>
+ *     <Evento> <t> [x y [argumentos...]]
+ *     frame <t>
+ *
+ * `frame` fecha o grupo de eventos despachados num mesmo quadro, então a reprodução agrupa
+ * os movimentos exatamente como na sessão original, independente da velocidade da máquina.
+ * As coordenadas são de tela; a conversão para o mundo é refeita na reprodução.
+ */
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <functional>
+#include <type_traits>
+
+#include "math.hpp"
+#include "input_event.hpp"
+
+
+namespace cg {
+	class Canvas;
+
+	namespace io {
+		// Nome usado na serialização de cada evento.
+		template <typename E>
+		constexpr const char* event_name() {
+			if constexpr (std::is_same_v<E, MouseMove>) return "MouseMove";
+			else if constexpr (std::is_same_v<E, MouseDrag>) return "MouseDrag";
+			else if constexpr (std::is_same_v<E, MouseLeftButtonPressed>) return "MouseLeftPressed";
+			else if constexpr (std::is_same_v<E, MouseLeftButtonReleased>) return "MouseLeftReleased";
+			else if constexpr (std::is_same_v<E, MouseRightButtonPressed>) return "MouseRightPressed";
+			else if constexpr (std::is_same_v<E, MouseRightButtonReleased>) return "MouseRightReleased";
+			else if constexpr (std::is_same_v<E, MouseMiddleButtonPressed>) return "MouseMiddlePressed";
+			else if constexpr (std::is_same_v<E, MouseMiddleButtonReleased>) return "MouseMiddleReleased";
+			else if constexpr (std::is_same_v<E, MouseWheelV>) return "MouseWheelV";
+			else if constexpr (std::is_same_v<E, MouseWheelH>) return "MouseWheelH";
+			else if constexpr (std::is_same_v<E, KeyboardInputEvent>) return "Key";
+			else if constexpr (std::is_same_v<E, SpecialKeyInputEvent>) return "SpecialKey";
+			else if constexpr (std::is_same_v<E, FocusIn>) return "FocusIn";
+			else if constexpr (std::is_same_v<E, FocusOut>) return "FocusOut";
+			else static_assert(!sizeof(E), "Evento sem nome de serialização");
+		}
+	} // namespace io
+
+
+	/** Grava os eventos enviados ao Canvas (`Canvas::sendScreenInput`), as mudanças de tamanho
+	 * da janela e os limites de cada quadro.
+	 */
+	class InputRecorder {
+	public:
+		bool open(const std::string& path, Vector2 window_size);
+		void close();
+
+		inline bool isOpen() const {
+			return ofs.is_open();
+		}
+
+		template <typename E, typename... Args>
+		void record(Args... args) {
+			if (!ofs.is_open())
+				return;
+			ofs << io::event_name<E>() << ' ' << elapsed();
+			((ofs << ' ' << args), ...);
+			ofs << '\n';
+		}
+
+		void recordWindow(Vector2 size);
+		void recordFrame();
+
+	private:
+		double elapsed() const; // ms desde `open`
+
+		std::ofstream ofs;
+		TimePoint start;
+	};
+
+
+	/** Reproduz um arquivo gravado pelo `InputRecorder`, um quadro gravado por quadro desenhado. */
+	class InputReplayer {
+	public:
+		using ResizeCallback = std::function<void(int width, int height)>;
+
+		bool load(const std::string& path);
+
+		/** Enfileira no Canvas os eventos do próximo quadro gravado.
+		 * `on_resize` é chamado para cada mudança de tamanho da janela (antes dos eventos do quadro).
+		 * Retorna falso quando não há mais quadros.
+		 */
+		bool feed(Canvas& canvas, const ResizeCallback& on_resize);
+
+		inline bool isActive() const {
+			return !frames.empty();
+		}
+
+		inline bool isFinished() const {
+			return next >= frames.size();
+		}
+
+		inline size_t getFrameCount() const {
+			return frames.size();
+		}
+
+		// Duração da sessão original (ms).
+		inline double getRecordedDuration() const {
+			return frames.empty() ? 0.0 : frames.back().time;
+		}
+
+	private:
+		struct Record {
+			std::string name;
+			int x = 0, y = 0;
+			int a = 0, b = 0; // direção da roda, ou tecla e modificadores
+			bool isResize = false;
+		};
+
+		struct Frame {
+			std::vector<Record> records;
+			double time = 0.0; // ms desde o início da gravação
+		};
+
+		std::vector<Frame> frames;
+		size_t next = 0;
+	};
+
+} // namespace cg
@@ -0,0 +1,354 @@
+﻿#include "lod_pyramid.hpp"
+
+#include <cmath>
+#include <tuple>
+#include <algorithm>
+
+
+namespace cg {
+
+	namespace {
+		// Coordenada inteira da célula do nível (limitada às representáveis)
+		inline std::int32_t cellOf(float v, int level) {
+			static constexpr float LIMIT = 1e9f;
+			return (std::int32_t)std::floor(std::clamp(std::ldexp(v, -level), -LIMIT, LIMIT));
+		}
+
+		inline float cellSize(int level) {
+			return std::ldexp(1.0f, level);
+		}
+	} // namespace
+
+	LodPyramid::~LodPyramid()
+	{
+		if (!builder.joinable())
+			return;
+		{
+			std::lock_guard lock{ mutex };
+			stopping = true;
+		}
+		wake.notify_all();
+		builder.join();
+	}
+
+	int LodPyramid::levelFor(float pixels_per_unit)
+	{
+		if (!(pixels_per_unit > 0.0f && pixels_per_unit <= OVERVIEW_ZOOM))
+			return -1;
+		return std::min(std::ilogb(1.0f / pixels_per_unit), MAX_LEVEL); // 2^nível <= 1 pixel
+	}
+
+	void LodPyramid::update(CanvasItem* item, std::uint64_t id, const Rect2& bounds, Color color, float size)
+	{
+		if (bounds.isEmpty()) {
+			remove(item);
+			return;
+		}
+
+		// Menor nível cuja célula cobre o item
+		Placement placement{ -1, 0, 0 };
+		const Vector2 extent = bounds.getSize();
+		const float largest = std::max(extent.x, extent.y);
+		if (bounds.isFinite() && largest <= cellSize(MAX_LEVEL)) {
+			int level = largest <= 1.0f ? 0 : std::ilogb(largest);
+			if (cellSize(level) < largest)
+				++level;
+			const Vector2 center = bounds.getCenter();
+			placement = { level, cellOf(center.x, level) >> 4, cellOf(center.y, level) >> 4 };
+		}
+		static_assert(NODE_CELLS == 16, "os índices de nó usam deslocamento de 4 bits");
+
+		const Record record{ item, id, bounds.getCenter(), color, size };
+		{
+			std::lock_guard lock{ mutex };
+			auto placed = placements.find(item);
+			if (placed != placements.end()) {
+				const Placement& old = placed->second;
+				if (old.level == placement.level && old.x == placement.x && old.y == placement.y) {
+					if (placement.level < 0)
+						return;
+
+					// Mesmo nó: só atualiza o registro
+					auto& records = levels[placement.level].at(key(placement.x, placement.y)).records;
+					auto found = std::find_if(records.begin(), records.end(), [item](const Record& r) { return r.item == item; });
+					if (found->id == id && found->center == record.center && found->size == size
+							&& found->color.r == color.r && found->color.g == color.g
+							&& found->color.b == color.b && found->color.a == color.a)
+						return;
+					*found = record;
+					// O nó e os ancestrais (que reduzem o agregado dele) ficam desatualizados
+					std::int32_t x = placement.x, y = placement.y;
+					for (int level = placement.level; level <= MAX_LEVEL; ++level, x >>= 1, y >>= 1)
+						markDirty(level, x, y);
+				}
+				else {
+					if (old.level < 0)
+						unbounded.erase(std::find(unbounded.begin(), unbounded.end(), item));
+					else
+						eraseRecord(old, item);
+					placed->second = placement;
+					if (placement.level < 0)
+						unbounded.push_back(item);
+					else
+						insertRecord(placement, record);
+				}
+			}
+			else {
+				placements.emplace(item, placement);
+				if (placement.level < 0)
+					unbounded.push_back(item);
+				else
+					insertRecord(placement, record);
+			}
+
+			if (!builder.joinable())
+				builder = std::thread{ &LodPyramid::buildLoop, this };
+		}
+		wake.notify_one();
+	}
+
+	void LodPyramid::remove(CanvasItem* item)
+	{
+		std::lock_guard lock{ mutex };
+		auto placed = placements.find(item);
+		if (placed == placements.end())
+			return;
+
+		if (placed->second.level < 0)
+			unbounded.erase(std::find(unbounded.begin(), unbounded.end(), item));
+		else
+			eraseRecord(placed->second, item);
+		placements.erase(placed);
+		wake.notify_one();
+	}
+
+	void LodPyramid::clear()
+	{
+		std::lock_guard lock{ mutex };
+		for (Level& level : levels)
+			level.clear();
+		placements.clear();
+		unbounded.clear();
+		pending.clear();
+		idle.notify_all();
+	}
+
+	void LodPyramid::insertRecord(const Placement& placement, const Record& record)
+	{
+		levels[placement.level][key(placement.x, placement.y)].records.push_back(record);
+
+		// O item entra no agregado do nó e de todos os ancestrais
+		std::int32_t x = placement.x, y = placement.y;
+		for (int level = placement.level; level <= MAX_LEVEL; ++level, x >>= 1, y >>= 1) {
+			++levels[level][key(x, y)].subtreeCount;
+			markDirty(level, x, y);
+		}
+	}
+
+	void LodPyramid::eraseRecord(const Placement& placement, CanvasItem* item)
+	{
+		auto& records = levels[placement.level].at(key(placement.x, placement.y)).records;
+		auto found = std::find_if(records.begin(), records.end(), [item](const Record& r) { return r.item == item; });
+		*found = records.back();
+		records.pop_back();
+
+		std::int32_t x = placement.x, y = placement.y;
+		for (int level = placement.level; level <= MAX_LEVEL; ++level, x >>= 1, y >>= 1) {
+			auto node = levels[level].find(key(x, y));
+			if (--node->second.subtreeCount == 0)
+				levels[level].erase(node); // subárvore vazia: descarta também o agregado
+			else
+				markDirty(level, x, y);
+		}
+	}
+
+	void LodPyramid::markDirty(int level, std::int32_t x, std::int32_t y)
+	{
+		Node& node = levels[level][key(x, y)];
+		if (node.isDirty)
+			return;
+		node.isDirty = true;
+		pending.push_back({ level, x, y });
+	}
+
+	void LodPyramid::collectSubtree(int level, std::int32_t x, std::int32_t y, std::vector<CanvasItem*>& out) const
+	{
+		auto found = levels[level].find(key(x, y));
+		if (found == levels[level].end())
+			return;
+		for (const Record& record : found->second.records)
+			out.push_back(record.item);
+		if (level > 0)
+			for (int child = 0; child < 4; ++child)
+				collectSubtree(level - 1, 2 * x + (child & 1), 2 * y + (child >> 1), out);
+	}
+
+	void LodPyramid::query(const Rect2& area, int level, std::vector<CanvasItem*>& items,
+			std::vector<std::shared_ptr<const Aggregate>>& aggregates) const
+	{
+		std::lock_guard lock{ mutex };
+		items.insert(items.end(), unbounded.begin(), unbounded.end());
+		if (area.isEmpty() || level < 0 || level > MAX_LEVEL)
+			return;
+
+		// Visita os nós do nível que tocam a área; os itens passam até meia célula da borda do nó
+		auto forEachNode = [this, &area](int at, auto&& visit) {
+			const Rect2 loose = area.grown(cellSize(at) / 2.0f);
+			const std::int32_t x0 = cellOf(loose.min.x, at) >> 4, y0 = cellOf(loose.min.y, at) >> 4;
+			const std::int32_t x1 = cellOf(loose.max.x, at) >> 4, y1 = cellOf(loose.max.y, at) >> 4;
+			const Level& nodes = levels[at];
+
+			std::int64_t count = ((std::int64_t)x1 - x0 + 1) * ((std::int64_t)y1 - y0 + 1);
+			if (count > (std::int64_t)nodes.size()) {
+				// Área maior que o nível ocupado: percorre só os nós existentes
+				for (const auto& [node_key, node] : nodes) {
+					auto x = (std::int32_t)(node_key >> 32), y = (std::int32_t)(std::uint32_t)node_key;
+					if (x >= x0 && x <= x1 && y >= y0 && y <= y1)
+						visit(x, y, node);
+				}
+				return;
+			}
+			for (std::int32_t y = y0; y <= y1; ++y)
+				for (std::int32_t x = x0; x <= x1; ++x)
+					if (auto node = nodes.find(key(x, y)); node != nodes.end())
+						visit(x, y, node->second);
+		};
+
+		// Itens maiores que uma célula: desenhados inteiros
+		for (int at = MAX_LEVEL; at > level; --at)
+			forEachNode(at, [&items](std::int32_t, std::int32_t, const Node& node) {
+				for (const Record& record : node.records)
+					items.push_back(record.item);
+			});
+
+		// Os demais, pelos agregados (ou inteiros, enquanto o nó não foi construído)
+		forEachNode(level, [&](std::int32_t x, std::int32_t y, const Node& node) {
+			if (node.aggregate)
+				aggregates.push_back(node.aggregate);
+			else
+				collectSubtree(level, x, y, items);
+		});
+	}
+
+	void LodPyramid::waitIdle()
+	{
+		std::unique_lock lock{ mutex };
+		idle.wait(lock, [this]() { return !builder.joinable() || (pending.empty() && !isBuilding); });
+	}
+
+	void LodPyramid::buildLoop()
+	{
+		std::unique_lock lock{ mutex };
+		std::vector<NodeRef> batch;
+		std::vector<Record> records;
+		while (true) {
+			wake.wait(lock, [this]() { return stopping || !pending.empty(); });
+			if (stopping)
+				return;
+
+			batch.clear();
+			batch.swap(pending);
+			isBuilding = true;
+			// Filhos antes dos pais (o pai reduz os agregados já refeitos dos filhos)
+			std::stable_sort(batch.begin(), batch.end(), [](const NodeRef& a, const NodeRef& b) {
+				return a.level < b.level;
+			});
+
+			for (const NodeRef& ref : batch) {
+				auto found = levels[ref.level].find(key(ref.x, ref.y));
+				if (found == levels[ref.level].end())
+					continue; // apagado depois de entrar na fila
+
+				// Cópia do estado atual do nó; edições durante a construção o sujam de novo
+				found->second.isDirty = false;
+				records = found->second.records;
+				std::array<std::shared_ptr<const Aggregate>, 4> children;
+				if (ref.level > 0)
+					for (int child = 0; child < 4; ++child) {
+						auto node = levels[ref.level - 1].find(key(2 * ref.x + (child & 1), 2 * ref.y + (child >> 1)));
+						if (node != levels[ref.level - 1].end())
+							children[child] = node->second.aggregate;
+					}
+
+				lock.unlock();
+				std::shared_ptr<const Aggregate> aggregate = build(ref.level, ref.x, ref.y, records, children);
+				lock.lock();
+
+				found = levels[ref.level].find(key(ref.x, ref.y));
+				if (found != levels[ref.level].end())
+					found->second.aggregate = std::move(aggregate);
+			}
+			isBuilding = false;
+			if (pending.empty())
+				idle.notify_all();
+		}
+	}
+
+	std::shared_ptr<const LodPyramid::Aggregate> LodPyramid::build(int level, std::int32_t x, std::int32_t y,
+			const std::vector<Record>& records, const std::array<std::shared_ptr<const Aggregate>, 4>& children)
+	{
+		constexpr int HALF = NODE_CELLS / 2;
+		std::array<Aggregate::Cell, NODE_CELLS * NODE_CELLS> cells{}; // id 0: vazia
+
+		auto merge = [&cells](int index, std::uint64_t id, Color color, float size) {
+			Aggregate::Cell& cell = cells[index];
+			if (id > cell.id) { // o item mais acima cobre os demais
+				cell.id = id;
+				cell.color = color;
+			}
+			cell.size = std::max(cell.size, size);
+		};
+
+		// Redução 2x2 dos filhos (cada filho ocupa um quadrante)
+		for (int child = 0; child < 4; ++child) {
+			if (!children[child])
+				continue;
+			const int offsetX = (child & 1) * HALF, offsetY = (child >> 1) * HALF;
+			for (const Aggregate::Cell& cell : children[child]->cells) {
+				int cx = cell.index % NODE_CELLS, cy = cell.index / NODE_CELLS;
+				merge((offsetY + cy / 2) * NODE_CELLS + offsetX + cx / 2, cell.id, cell.color, cell.size);
+			}
+		}
+
+		// Itens deste nível, pela célula do centro
+		const std::int32_t originX = x * NODE_CELLS, originY = y * NODE_CELLS;
+		for (const Record& record : records) {
+			int cx = std::clamp(cellOf(record.center.x, level) - originX, 0, NODE_CELLS - 1);
+			int cy = std::clamp(cellOf(record.center.y, level) - originY, 0, NODE_CELLS - 1);
+			merge(cy * NODE_CELLS + cx, record.id, record.color, record.size);
+		}
+
+		auto aggregate = std::make_shared<Aggregate>();
+		for (int index = 0; index < NODE_CELLS * NODE_CELLS; ++index)
+			if (cells[index].id != 0) {
+				cells[index].index = (std::uint16_t)index;
+				aggregate->cells.push_back(cells[index]);
+			}
+
+		// Agrupa os pontos por cor e tamanho, para uma chamada de desenho por grupo
+		std::vector<const Aggregate::Cell*> sorted;
+		sorted.reserve(aggregate->cells.size());
+		for (const Aggregate::Cell& cell : aggregate->cells)
+			sorted.push_back(&cell);
+		auto tie = [](const Aggregate::Cell* c) {
+			return std::make_tuple(c->color.r, c->color.g, c->color.b, c->color.a, c->size);
+		};
+		std::sort(sorted.begin(), sorted.end(), [&tie](const Aggregate::Cell* a, const Aggregate::Cell* b) {
+			return tie(a) < tie(b);
+		});
+
+		const float size = cellSize(level);
+		aggregate->points.reserve(sorted.size());
+		for (const Aggregate::Cell* cell : sorted) {
+			if (aggregate->batches.empty() || tie(cell) != tie(sorted[aggregate->points.size() - 1]))
+				aggregate->batches.push_back({ cell->color, std::max(cell->size, 1.0f), (std::uint32_t)aggregate->points.size(), 0 });
+			++aggregate->batches.back().count;
+			aggregate->points.push_back({
+				(originX + cell->index % NODE_CELLS + 0.5f) * size,
+				(originY + cell->index / NODE_CELLS + 0.5f) * size,
+			});
+		}
+		return aggregate;
+	}
+
+} // namespace cg
@@ -0,0 +1,143 @@
+﻿#pragma once
+/* Pirâmide de níveis de detalhe dos itens do Canvas, para a visão geral (zoom distante).
+ * Cada item fica num nó de uma quadtree esparsa conforme o centro dos seus limites e o seu tamanho:
+ * no nível ℓ as células medem 2^ℓ unidades do mundo, cada nó tem NODE_CELLS² células e o item
+ * entra no menor nível cuja célula o contém. Cada nó guarda um agregado: por célula, a cor do item
+ * mais acima (maior id) da sua subárvore, como um ponto — o mesmo esquema de um mipmap.
+ *
+ * Ao desenhar com células de no máximo um pixel, os itens menores que uma célula são substituídos
+ * pelos pontos dos agregados, e só os maiores são desenhados inteiros. Os agregados são refeitos
+ * numa thread em segundo plano, a partir de cópias dos registros, e só para os nós no caminho
+ * até a raiz de um item alterado; enquanto um nó não tem agregado, seus itens são desenhados inteiros.
+ */
+
+#include <array>
+#include <mutex>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <cstdint>
+#include <unordered_map>
+#include <condition_variable>
+
+#include "math.hpp"
+
+
+namespace cg {
+
+    class CanvasItem;
+
+    class LodPyramid {
+    public:
+        static constexpr int NODE_CELLS = 16; // células por lado de um nó
+        static constexpr int MAX_LEVEL = 20; // itens maiores que 2^MAX_LEVEL nunca são agregados
+        static constexpr float OVERVIEW_ZOOM = 0.25f; // pixels por unidade a partir dos quais os agregados são usados
+
+        // Pontos de um agregado com a mesma cor e tamanho (uma chamada de desenho).
+        struct Batch {
+            Color color;
+            float size;
+            std::uint32_t first, count;
+        };
+
+        struct Aggregate {
+            struct Cell {
+                std::uint16_t index; // y * NODE_CELLS + x
+                std::uint64_t id; // item mais acima da célula
+                Color color;
+                float size; // maior traço (pixels) entre os itens da célula
+            };
+            std::vector<Cell> cells; // só as ocupadas, em ordem de índice
+            std::vector<Vector2> points; // centros das células, agrupados por `batches`
+            std::vector<Batch> batches;
+        };
+
+        LodPyramid() = default;
+        ~LodPyramid();
+
+        LodPyramid(const LodPyramid&) = delete;
+        LodPyramid& operator=(const LodPyramid&) = delete;
+
+        /** Insere ou reposiciona o item (limites vazios removem o item).
+         * @param color Cor do item quando ele ocupa menos de uma célula
+         * @param size Traço do item, em pixels (tamanho mínimo do seu ponto)
+         */
+        void update(CanvasItem* item, std::uint64_t id, const Rect2& bounds, Color color, float size);
+        void remove(CanvasItem* item);
+        void clear();
+
+        /* Nível cujas células medem no máximo um pixel (-1: zoom próximo demais para agregar). */
+        static int levelFor(float pixels_per_unit);
+
+        /** Consulta a área no nível dado (de `levelFor`).
+         * @param items Saída: itens a desenhar inteiros (maiores que uma célula, ou de nós ainda sem agregado);
+         *  pode ter repetições, sem ordem definida
+         * @param aggregates Saída: agregados dos nós do nível que tocam a área
+         */
+        void query(const Rect2& area, int level, std::vector<CanvasItem*>& items,
+            std::vector<std::shared_ptr<const Aggregate>>& aggregates) const;
+
+        /* Bloqueia até a thread de construção esvaziar a fila (exportação e medições). */
+        void waitIdle();
+
+        inline std::size_t size() const {
+            return placements.size();
+        }
+
+    private:
+        struct Record {
+            CanvasItem* item;
+            std::uint64_t id;
+            Vector2 center;
+            Color color;
+            float size;
+        };
+
+        struct Node {
+            std::vector<Record> records; // itens deste nível com o centro no nó
+            std::size_t subtreeCount = 0; // registros no nó e abaixo dele (0: o nó é apagado)
+            std::shared_ptr<const Aggregate> aggregate; // último agregado construído
+            bool isDirty = false; // na fila de construção
+        };
+
+        struct NodeRef {
+            int level;
+            std::int32_t x, y;
+        };
+
+        struct Placement {
+            int level; // -1: sem limites finitos ou grande demais (`unbounded`)
+            std::int32_t x, y; // nó
+        };
+
+        using Level = std::unordered_map<std::uint64_t, Node>;
+
+        static inline std::uint64_t key(std::int32_t x, std::int32_t y) {
+            return ((std::uint64_t)(std::uint32_t)x << 32) | (std::uint32_t)y;
+        }
+
+        // Funções abaixo assumem `mutex` travado
+        void insertRecord(const Placement& placement, const Record& record);
+        void eraseRecord(const Placement& placement, CanvasItem* item);
+        void markDirty(int level, std::int32_t x, std::int32_t y);
+        void collectSubtree(int level, std::int32_t x, std::int32_t y, std::vector<CanvasItem*>& out) const;
+
+        void buildLoop();
+        static std::shared_ptr<const Aggregate> build(int level, std::int32_t x, std::int32_t y,
+            const std::vector<Record>& records, const std::array<std::shared_ptr<const Aggregate>, 4>& children);
+
+    private:
+        std::array<Level, MAX_LEVEL + 1> levels;
+        std::unordered_map<CanvasItem*, Placement> placements;
+        std::vector<CanvasItem*> unbounded;
+
+        // Construção em segundo plano (iniciada na primeira inserção)
+        mutable std::mutex mutex;
+        std::condition_variable wake, idle;
+        std::vector<NodeRef> pending; // nós sujos, a construir
+        std::thread builder;
+        bool isBuilding = false;
+        bool stopping = false;
+    };
+
+} // namespace cg
@@ -17,6 +17,8 @@
 #include <type_traits>
 #include <fstream>
 #include <concepts>
+#include <limits>
+#include <algorithm>
 
 
 namespace cg
@@ -822,6 +824,69 @@ inline Transf2x3<LargerType<T, U>>& operator*=(Transf2x3<T>& a, const Transf2x3<
 using Transform2D = Transf2x3<float>;
 
 
+// Retângulo alinhado aos eixos (AABB), em coordenadas de mundo ou locais.
+struct Rect2 {
+    Vector2 min{ std::numeric_limits<float>::infinity() };
+    Vector2 max{ -std::numeric_limits<float>::infinity() };
+
+    constexpr Rect2() = default; // vazio: `expand` define o primeiro ponto
+    constexpr Rect2(Vector2 min, Vector2 max) : min{ min }, max{ max } {}
+
+    // Cobre todo o plano (itens sem limites conhecidos nunca são descartados).
+    static constexpr Rect2 infinite() {
+        return { Vector2{ -std::numeric_limits<float>::infinity() }, Vector2{ std::numeric_limits<float>::infinity() } };
+    }
+
+    constexpr inline bool isEmpty() const {
+        return min.x > max.x || min.y > max.y;
+    }
+
+    inline bool isFinite() const {
+        return std::isfinite(min.x) && std::isfinite(min.y) && std::isfinite(max.x) && std::isfinite(max.y);
+    }
+
+    constexpr inline Vector2 getSize() const {
+        return max - min;
+    }
+
+    constexpr inline Vector2 getCenter() const {
+        return (min + max) / 2.0f;
+    }
+
+    constexpr inline void expand(Vector2 point) {
+        min = { std::min(min.x, point.x), std::min(min.y, point.y) };
+        max = { std::max(max.x, point.x), std::max(max.y, point.y) };
+    }
+
+    // Cresce `by` em todas as direções.
+    constexpr inline Rect2 grown(float by) const {
+        return { min - Vector2{ by }, max + Vector2{ by } };
+    }
+
+    constexpr inline bool contains(Vector2 point) const {
+        return point.x >= min.x && point.x <= max.x && point.y >= min.y && point.y <= max.y;
+    }
+
+    constexpr inline bool contains(const Rect2& other) const {
+        return other.min.x >= min.x && other.max.x <= max.x && other.min.y >= min.y && other.max.y <= max.y;
+    }
+
+    constexpr inline bool intersects(const Rect2& other) const {
+        return min.x <= other.max.x && other.min.x <= max.x && min.y <= other.max.y && other.min.y <= max.y;
+    }
+
+    // Caixa envolvente do retângulo transformado (os 4 cantos).
+    inline Rect2 transformed(const Transform2D& by) const {
+        if (isEmpty() || !isFinite())
+            return *this;
+        Rect2 result;
+        for (Vector2 corner : { min, Vector2{ max.x, min.y }, max, Vector2{ min.x, max.y } })
+            result.expand(by * corner);
+        return result;
+    }
+};
+
+
 struct ColorRgb {
     unsigned char r = 0, g = 0, b = 0;
 
@@ -874,13 +939,13 @@ namespace colors {
     constexpr ColorRgb RGB_GREEN { 0, 1, 0 };
     constexpr ColorRgb RGB_BLUE  { 0, 0, 1 };
 
-    inline void glRandomize()
+    inline Color random()
     {
-        glColor3ub(
-            (std::rand() % 256),
-            (std::rand() % 256),
-            (std::rand() % 256)
-        );
+        return ColorRgb{
+            (unsigned char)(std::rand() % 256),
+            (unsigned char)(std::rand() % 256),
+            (unsigned char)(std::rand() % 256)
+        }.normalized();
     }
 }
 
@@ -0,0 +1,119 @@
+﻿#include "render_backend.hpp"
+
+#include <cmath>
+#include <cstring>
+#include <atomic>
+#include <algorithm>
+
+
+namespace cg {
+
+	const Transform2D RenderBackend::IDENTITY{};
+
+	static thread_local RenderBackend* currentBackend = nullptr;
+
+	std::uint64_t Image::newId()
+	{
+		static std::atomic<std::uint64_t> last{ 0 };
+		return ++last;
+	}
+
+	RenderBackend& RenderBackend::current()
+	{
+		static thread_local NullBackend fallback;
+		return currentBackend ? *currentBackend : fallback;
+	}
+
+	const Image& RenderBackend::pointMask()
+	{
+		static const Image mask = [] {
+			constexpr int SIZE = 32;
+			constexpr float RADIUS = SIZE / 2.0f;
+			Image image;
+			image.width = image.height = SIZE;
+			image.pixels.resize((std::size_t)SIZE * SIZE);
+			image.isSmooth = true;
+			for (int y = 0; y < SIZE; ++y)
+				for (int x = 0; x < SIZE; ++x) {
+					// Rampa de um texel centrada no raio, pelo centro do texel
+					const float dx = x + 0.5f - RADIUS, dy = y + 0.5f - RADIUS;
+					const float coverage = std::clamp(RADIUS + 0.5f - std::sqrt(dx * dx + dy * dy), 0.0f, 1.0f);
+					const std::uint8_t texel[4] = { 255, 255, 255, (std::uint8_t)(coverage * 255.0f + 0.5f) };
+					std::memcpy(&image.pixels[(std::size_t)y * SIZE + x], texel, sizeof(texel));
+				}
+			return image;
+		}();
+		return mask;
+	}
+
+	RenderBackend* RenderBackend::bind(RenderBackend* backend)
+	{
+		RenderBackend* previous = currentBackend;
+		currentBackend = backend;
+		return previous;
+	}
+
+
+	const Transform2D& RecordingBackend::appendVertices(std::span<const Vector2> source, const Transform2D& model)
+	{
+		if (!isPretransformed) {
+			vertices.insert(vertices.end(), source.begin(), source.end());
+			return model;
+		}
+		const std::size_t first = vertices.size();
+		vertices.resize(first + source.size());
+		for (std::size_t i = 0; i < source.size(); ++i)
+			vertices[first + i] = model * source[i];
+		return IDENTITY;
+	}
+
+	void RecordingBackend::draw(Primitive primitive, std::span<const Vector2> vertices,
+		const Transform2D& model, Color color, float size)
+	{
+		const std::size_t first = this->vertices.size();
+		const Transform2D& recorded = appendVertices(vertices, model);
+		commands.push_back({ primitive, recorded, color, size, first, vertices.size() });
+	}
+
+	void RecordingBackend::drawMaskedTriangles(const Image& mask, std::span<const Vector2> vertices,
+		std::span<const Vector2> texcoords, const Transform2D& model, Color color)
+	{
+		const std::size_t n = std::min(vertices.size(), texcoords.size());
+		const std::size_t first = this->vertices.size(), texcoordFirst = this->texcoords.size();
+		const Transform2D& recorded = appendVertices(vertices.first(n), model);
+		this->texcoords.insert(this->texcoords.end(), texcoords.begin(), texcoords.begin() + n);
+		commands.push_back({ Primitive::TRIANGLES, recorded, color, 0.0f, first, n,
+			Kind::MASKED_TRIANGLES, &mask, texcoordFirst });
+	}
+
+	void RecordingBackend::drawPointSprites(std::span<const Vector2> points, const Transform2D& model, Color color, float size)
+	{
+		const std::size_t first = vertices.size();
+		const Transform2D& recorded = appendVertices(points, model);
+		commands.push_back({ Primitive::POINTS, recorded, color, size, first, points.size(), Kind::POINT_SPRITES });
+	}
+
+	void RecordingBackend::replay(RenderBackend& target) const
+	{
+		replay(target, 0, commands.size());
+	}
+
+	void RecordingBackend::replay(RenderBackend& target, std::size_t first_command, std::size_t end_command) const
+	{
+		for (std::size_t i = first_command; i < end_command; ++i) {
+			const Command& command = commands[i];
+			switch (command.kind) {
+			case Kind::PRIMITIVE:
+				target.draw(command.primitive, verticesOf(command), command.model, command.color, command.size);
+				break;
+			case Kind::MASKED_TRIANGLES:
+				target.drawMaskedTriangles(*command.mask, verticesOf(command), texcoordsOf(command), command.model, command.color);
+				break;
+			case Kind::POINT_SPRITES:
+				target.drawPointSprites(verticesOf(command), command.model, command.color, command.size);
+				break;
+			}
+		}
+	}
+
+} // namespace cg
@@ -0,0 +1,245 @@
+﻿#pragma once
+/* Interface de desenho usada pelos itens e ferramentas do Canvas.
+ * O núcleo (cgcore) não conhece OpenGL: cada `_render` submete geometria em coordenadas locais,
+ * com a matriz de modelo, para o backend atual da thread. A aplicação instala o backend OpenGL
+ * (facade/gl_backend.hpp); ferramentas sem janela usam o NullBackend ou o RecordingBackend.
+ */
+
+#include <span>
+#include <vector>
+#include <cstdint>
+
+#include "math.hpp"
+
+
+namespace cg {
+
+    enum class Primitive {
+        POINTS,
+        LINES,
+        LINE_STRIP,
+        LINE_LOOP,
+        TRIANGLES,
+        TRIANGLE_STRIP,
+        TRIANGLE_FAN,
+    };
+
+    /* Imagem RGBA8 desenhada pelo backend (bytes R, G, B, A; linha 0 no topo). */
+    struct Image {
+        int width = 0, height = 0;
+        std::vector<std::uint32_t> pixels;
+        std::uint64_t id = newId(); // chave dos caches de textura dos backends
+        std::uint32_t revision = 0; // incremente ao mudar os pixels (o backend reenvia a textura)
+        bool isSmooth = false; // filtragem linear ao desenhar ampliada ou reduzida (atlas de texto)
+
+        static std::uint64_t newId();
+    };
+
+    enum class Cursor {
+        INHERIT,
+        NONE,
+        CROSSHAIR,
+        INFO,
+    };
+
+    class RenderBackend {
+    public:
+        virtual ~RenderBackend() = default;
+
+        /** Submete uma primitiva.
+         * @param vertices Vértices em coordenadas locais (transformados por `model` no backend)
+         * @param size Tamanho do ponto ou largura da linha, em pixels (ignorado para triângulos)
+         */
+        virtual void draw(Primitive primitive, std::span<const Vector2> vertices,
+            const Transform2D& model, Color color, float size = 1.0f) = 0;
+
+        /** Desenha a imagem esticada sobre um retângulo do mundo, sem filtragem (vizinho mais próximo).
+         * Ocupa a ordem de desenho como as demais primitivas.
+         */
+        virtual void drawImage(const Image& image, const Rect2& world_area) {}
+        /* A imagem não será mais desenhada (libera a textura em cache, se houver). */
+        virtual void releaseImage(std::uint64_t image_id) {}
+        /** Copia o destino inteiro, como desenhado até aqui, para a imagem (que passa a ter o tamanho dele).
+         * A cópia pode ficar só no backend (textura, sem `pixels`): desenhe-a de volta com `drawImage` no mesmo backend.
+         * @return `false` se o backend não lê o próprio destino
+         */
+        virtual bool captureImage(Image& image) { return false; }
+
+        /** Triângulos com a cor dada e a opacidade lida do canal alpha da imagem (máscara), como o texto.
+         * @param vertices Vértices em coordenadas locais, três por triângulo
+         * @param texcoords Posição de cada vértice na máscara, em [0, 1] (linha 0 da imagem em v = 0)
+         * A máscara deve continuar existindo até o fim do quadro.
+         */
+        virtual void drawMaskedTriangles(const Image& mask, std::span<const Vector2> vertices,
+            std::span<const Vector2> texcoords, const Transform2D& model, Color color) {}
+
+        /** Conclui os desenhos que o backend acumulou em lotes (o Canvas chama ao fim de cada quadro).
+         * Os demais comandos já concluem os lotes pendentes antes de desenhar, mantendo a ordem.
+         */
+        virtual void flush() {}
+
+        /** Pontos redondos de `size` pixels de diâmetro, com a borda dada pela cobertura de um disco
+         * (`pointMask`, sem GL_POINT_SMOOTH). Chamadas seguidas com o mesmo tamanho formam um só lote
+         * nos backends que agrupam desenhos. O padrão desenha pontos quadrados (`draw`).
+         */
+        virtual void drawPointSprites(std::span<const Vector2> points, const Transform2D& model, Color color, float size) {
+            draw(Primitive::POINTS, points, model, color, size);
+        }
+
+        /* Cursor do mouse sobre o Canvas (sem efeito fora de uma janela). */
+        virtual void setCursor(Cursor cursor) {}
+
+        /** Projeção da câmera, definida pelo Canvas no início de cada quadro.
+         * @param world_to_screen Mundo -> pixels da janela (origem no canto superior esquerdo, y para baixo)
+         */
+        virtual void setProjection(const Transform2D& world_to_screen, Vector2 viewport_size) {}
+
+        /** Área do mundo que pode aparecer no destino (o Canvas a define ao desenhar os itens; infinita por padrão).
+         * Itens com muitos vértices recortam a própria geometria a ela em vez de submeter tudo.
+         */
+        inline void setClipRect(const Rect2& area) { clipRect = area; }
+        inline const Rect2& getClipRect() const { return clipRect; }
+
+        /* Pixels do destino por unidade do mundo (zoom da câmera; escala da imagem na exportação). */
+        inline void setPixelsPerUnit(float scale) { pixelsPerUnit = scale; }
+        inline float getPixelsPerUnit() const { return pixelsPerUnit; }
+
+        inline void draw(Primitive primitive, std::span<const Vector2> vertices, Color color, float size = 1.0f) {
+            draw(primitive, vertices, IDENTITY, color, size);
+        }
+
+        /* Backend usado pelos `_render` da thread atual (nunca nulo: cai no NullBackend). */
+        static RenderBackend& current();
+
+        /* Troca o backend da thread atual e retorna o anterior (`nullptr` volta ao padrão). */
+        static RenderBackend* bind(RenderBackend* backend);
+
+    protected:
+        /* Disco branco com a cobertura no alpha (meia opacidade no raio), máscara dos pontos. */
+        static const Image& pointMask();
+
+        static const Transform2D IDENTITY;
+
+    private:
+        Rect2 clipRect = Rect2::infinite();
+        float pixelsPerUnit = 1.0f;
+    };
+
+
+    /* Instala um backend enquanto o escopo existir. */
+    class ScopedBackend {
+    public:
+        ScopedBackend(RenderBackend& backend) : previous{ RenderBackend::bind(&backend) } {}
+        ~ScopedBackend() { RenderBackend::bind(previous); }
+
+        ScopedBackend(const ScopedBackend&) = delete;
+        ScopedBackend& operator=(const ScopedBackend&) = delete;
+
+    private:
+        RenderBackend* previous;
+    };
+
+
+    /* Descarta a geometria, apenas contando o que foi submetido (medição de throughput). */
+    class NullBackend : public RenderBackend {
+    public:
+        void draw(Primitive primitive, std::span<const Vector2> vertices,
+            const Transform2D& model, Color color, float size) override {
+            ++drawCalls;
+            vertexCount += vertices.size();
+        }
+        using RenderBackend::draw;
+
+        void drawImage(const Image& image, const Rect2& world_area) override {
+            ++imageCount;
+        }
+        void drawMaskedTriangles(const Image& mask, std::span<const Vector2> vertices,
+            std::span<const Vector2> texcoords, const Transform2D& model, Color color) override {
+            ++drawCalls;
+            vertexCount += vertices.size();
+        }
+        bool captureImage(Image& image) override {
+            return true; // nada a copiar: a imagem vale como se tivesse sido lida
+        }
+
+        inline void reset() {
+            drawCalls = vertexCount = imageCount = 0;
+        }
+
+    public:
+        std::uint64_t drawCalls = 0;
+        std::uint64_t vertexCount = 0;
+        std::uint64_t imageCount = 0;
+    };
+
+
+    /* Guarda uma cópia de cada comando (para reprodução posterior, testes e preparação fora da thread de desenho).
+     * Imagens não são gravadas; as máscaras são guardadas por endereço e devem existir até a reprodução.
+     */
+    class RecordingBackend : public RenderBackend {
+    public:
+        enum class Kind {
+            PRIMITIVE,
+            MASKED_TRIANGLES,
+            POINT_SPRITES,
+        };
+
+        struct Command {
+            Primitive primitive;
+            Transform2D model;
+            Color color;
+            float size;
+            std::size_t first; // índice do primeiro vértice em `vertices`
+            std::size_t count;
+            Kind kind = Kind::PRIMITIVE;
+            const Image* mask = nullptr; // MASKED_TRIANGLES
+            std::size_t texcoordFirst = 0; // índice em `texcoords` (MASKED_TRIANGLES)
+        };
+
+        void draw(Primitive primitive, std::span<const Vector2> vertices,
+            const Transform2D& model, Color color, float size) override;
+        using RenderBackend::draw;
+
+        void drawMaskedTriangles(const Image& mask, std::span<const Vector2> vertices,
+            std::span<const Vector2> texcoords, const Transform2D& model, Color color) override;
+        void drawPointSprites(std::span<const Vector2> points, const Transform2D& model, Color color, float size) override;
+
+        void setCursor(Cursor to) override {
+            cursor = to;
+        }
+
+        /* Reenvia os comandos gravados para outro backend, na mesma ordem. */
+        void replay(RenderBackend& target) const;
+        /* Reenvia os comandos [first_command, end_command). */
+        void replay(RenderBackend& target, std::size_t first_command, std::size_t end_command) const;
+
+        inline std::span<const Vector2> verticesOf(const Command& command) const {
+            return { vertices.data() + command.first, command.count };
+        }
+
+        inline std::span<const Vector2> texcoordsOf(const Command& command) const {
+            if (command.kind != Kind::MASKED_TRIANGLES)
+                return {};
+            return { texcoords.data() + command.texcoordFirst, command.count };
+        }
+
+        inline void clear() {
+            commands.clear();
+            vertices.clear();
+            texcoords.clear();
+        }
+
+    private:
+        // Copia os vértices (no mundo, com `isPretransformed`) e retorna o modelo a gravar
+        const Transform2D& appendVertices(std::span<const Vector2> source, const Transform2D& model);
+
+    public:
+        std::vector<Command> commands;
+        std::vector<Vector2> vertices;
+        std::vector<Vector2> texcoords;
+        Cursor cursor = Cursor::INHERIT;
+        // Grava os vértices já transformados pelo modelo (a reprodução usa a identidade)
+        bool isPretransformed = false;
+    };
+
+} // namespace cg
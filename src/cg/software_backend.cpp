@@ -0,0 +1,398 @@
+﻿#include "software_backend.hpp"
+
+#include <cmath>
+#include <cstring>
+#include <algorithm>
+
+#if !defined(CG_NO_SIMD) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+	#define CG_SSE2 1
+	#include <emmintrin.h>
+#endif
+
+
+namespace cg {
+
+	// Primeiro / último pixel cujo centro (i + 0.5) está em [v, ...] / [..., v], limitado a [-1, limit].
+	static inline int first_center(float v, int limit) {
+		return (int)std::ceil(std::clamp(v - 0.5f, -1.0f, (float)limit));
+	}
+	static inline int last_center(float v, int limit) {
+		return (int)std::floor(std::clamp(v - 0.5f, -1.0f, (float)limit));
+	}
+
+	SoftwareBackend::SoftwareBackend(int width, int height, unsigned threads)
+	{
+		resize(width, height);
+
+		if (threads == 0)
+			pool = &ThreadPool::shared();
+		else if (threads > 1) { // a thread que chama `flush` é a primeira
+			ownPool = std::make_unique<ThreadPool>(threads - 1);
+			pool = ownPool.get();
+		}
+	}
+
+	SoftwareBackend::~SoftwareBackend() = default;
+
+	void SoftwareBackend::resize(int width, int height)
+	{
+		this->width = std::max(width, 0);
+		this->height = std::max(height, 0);
+		tilesX = (this->width + TILE_SIZE - 1) / TILE_SIZE;
+		tilesY = (this->height + TILE_SIZE - 1) / TILE_SIZE;
+		pixels.assign((std::size_t)this->width * this->height, 0);
+		bins.resize((std::size_t)tilesX * tilesY);
+		triangles.clear();
+		mappings.clear();
+
+		// Inverso de `Canvas::screenToWorld`: x + w/2, h/2 - y
+		view = Transform2D{ { 1.0f, 0.0f }, { 0.0f, -1.0f }, { this->width / 2.0f, this->height / 2.0f } };
+		sizeScale = 1.0f;
+	}
+
+	std::uint32_t SoftwareBackend::pack(Color color)
+	{
+		auto unorm8 = [](float c) {
+			return (std::uint8_t)std::floor(std::clamp(c, 0.0f, 1.0f) * 255.0f + 0.5f);
+		};
+		const std::uint8_t bytes[4] = { unorm8(color.r), unorm8(color.g), unorm8(color.b), unorm8(color.a) };
+		std::uint32_t packed;
+		std::memcpy(&packed, bytes, sizeof(packed));
+		return packed;
+	}
+
+	void SoftwareBackend::clear(Color color)
+	{
+		triangles.clear();
+		mappings.clear();
+		lastTriangleCount = 0;
+		std::fill(pixels.begin(), pixels.end(), pack(color));
+	}
+
+	void SoftwareBackend::drawImage(const Image& image, const Rect2& world_area)
+	{
+		if (image.width <= 0 || image.height <= 0 || world_area.isEmpty() || !world_area.isFinite())
+			return;
+		flush(); // mantém a ordem com os triângulos pendentes
+
+		// Retângulo na tela (a vista não rotaciona: só escala e translação)
+		const Vector2 a = view * world_area.min, b = view * world_area.max;
+		const float x0 = std::min(a.x, b.x), x1 = std::max(a.x, b.x);
+		const float y0 = std::min(a.y, b.y), y1 = std::max(a.y, b.y);
+		const int xmin = std::max(first_center(x0, width), 0), xmax = std::min(last_center(x1 - 1e-4f, width), width - 1);
+		const int ymin = std::max(first_center(y0, height), 0), ymax = std::min(last_center(y1 - 1e-4f, height), height - 1);
+		if (xmin > xmax || ymin > ymax)
+			return;
+
+		// Vizinho mais próximo pelo centro de cada pixel de destino
+		const float scaleX = image.width / (x1 - x0), scaleY = image.height / (y1 - y0);
+		std::vector<int> columns((std::size_t)(xmax - xmin + 1));
+		for (int x = xmin; x <= xmax; ++x)
+			columns[x - xmin] = std::clamp((int)((x + 0.5f - x0) * scaleX), 0, image.width - 1);
+		for (int y = ymin; y <= ymax; ++y) {
+			const int row = std::clamp((int)((y + 0.5f - y0) * scaleY), 0, image.height - 1);
+			const std::uint32_t* source = image.pixels.data() + (std::size_t)row * image.width;
+			std::uint32_t* target = pixels.data() + (std::size_t)y * width;
+			for (int x = xmin; x <= xmax; ++x)
+				target[x] = source[columns[x - xmin]];
+		}
+	}
+
+	bool SoftwareBackend::captureImage(Image& image)
+	{
+		flush();
+		image.width = width;
+		image.height = height;
+		image.pixels = pixels;
+		++image.revision;
+		return true;
+	}
+
+
+	bool SoftwareBackend::pushTriangle(Vector2 a, Vector2 b, Vector2 c, std::uint32_t color, std::uint32_t mapping)
+	{
+		if (!std::isfinite(a.x + a.y + b.x + b.y + c.x + c.y))
+			return false;
+
+		// Caixa envolvente em centros de pixel, limitada ao framebuffer
+		int xmin = std::max(first_center(std::min({ a.x, b.x, c.x }), width), 0);
+		int xmax = std::min(last_center(std::max({ a.x, b.x, c.x }), width), width - 1);
+		int ymin = std::max(first_center(std::min({ a.y, b.y, c.y }), height), 0);
+		int ymax = std::min(last_center(std::max({ a.y, b.y, c.y }), height), height - 1);
+		if (xmin > xmax || ymin > ymax)
+			return false;
+
+		auto index = (std::uint32_t)triangles.size();
+		triangles.push_back({ { a, b, c }, color, mapping });
+
+		for (int ty = ymin / TILE_SIZE; ty <= ymax / TILE_SIZE; ++ty)
+			for (int tx = xmin / TILE_SIZE; tx <= xmax / TILE_SIZE; ++tx)
+				bins[(std::size_t)ty * tilesX + tx].push_back(index);
+		return true;
+	}
+
+	void SoftwareBackend::pushQuad(Vector2 a, Vector2 b, Vector2 c, Vector2 d, std::uint32_t color)
+	{
+		pushTriangle(a, b, c, color);
+		pushTriangle(a, c, d, color);
+	}
+
+	void SoftwareBackend::pushSegment(Vector2 from, Vector2 to, float width, std::uint32_t color)
+	{
+		Vector2 direction = to - from;
+		float length = std::sqrt(direction.x * direction.x + direction.y * direction.y);
+		if (length == 0.0f)
+			return; // o GL também não desenha segmentos degenerados
+
+		// Retângulo de largura `width` centrado no segmento
+		float half = std::max(width, 1.0f) * 0.5f / length;
+		Vector2 normal{ -direction.y * half, direction.x * half };
+		pushQuad(from + normal, to + normal, to - normal, from - normal, color);
+	}
+
+	void SoftwareBackend::draw(Primitive primitive, std::span<const Vector2> vertices,
+		const Transform2D& model, Color color, float size)
+	{
+		if (vertices.empty() || width == 0 || height == 0)
+			return;
+
+		const Transform2D transform = view * model;
+		const std::uint32_t packed = pack(color);
+		size *= sizeScale;
+		auto at = [&](std::size_t i) -> Vector2 { return transform * vertices[i]; };
+		const std::size_t n = vertices.size();
+
+		switch (primitive) {
+		case Primitive::POINTS: {
+			// Quadrado de lado `size` centrado no ponto (pontos sem suavização do GL)
+			float half = std::max(size, 1.0f) * 0.5f;
+			for (std::size_t i = 0; i < n; ++i) {
+				Vector2 p = at(i);
+				pushQuad({ p.x - half, p.y - half }, { p.x + half, p.y - half },
+					{ p.x + half, p.y + half }, { p.x - half, p.y + half }, packed);
+			}
+		} break;
+		case Primitive::LINES:
+			for (std::size_t i = 0; i + 1 < n; i += 2)
+				pushSegment(at(i), at(i + 1), size, packed);
+			break;
+		case Primitive::LINE_STRIP:
+		case Primitive::LINE_LOOP: {
+			Vector2 previous = at(0);
+			for (std::size_t i = 1; i < n; ++i) {
+				Vector2 current = at(i);
+				pushSegment(previous, current, size, packed);
+				previous = current;
+			}
+			if (primitive == Primitive::LINE_LOOP && n > 2)
+				pushSegment(previous, at(0), size, packed);
+		} break;
+		case Primitive::TRIANGLES:
+			for (std::size_t i = 0; i + 2 < n; i += 3)
+				pushTriangle(at(i), at(i + 1), at(i + 2), packed);
+			break;
+		case Primitive::TRIANGLE_STRIP:
+			for (std::size_t i = 0; i + 2 < n; ++i)
+				pushTriangle(at(i), at(i + 1), at(i + 2), packed);
+			break;
+		case Primitive::TRIANGLE_FAN: {
+			if (n < 3)
+				break;
+			Vector2 center = at(0), previous = at(1);
+			for (std::size_t i = 2; i < n; ++i) {
+				Vector2 current = at(i);
+				pushTriangle(center, previous, current, packed);
+				previous = current;
+			}
+		} break;
+		}
+	}
+
+
+	void SoftwareBackend::drawMaskedTriangles(const Image& mask, std::span<const Vector2> vertices,
+		std::span<const Vector2> texcoords, const Transform2D& model, Color color)
+	{
+		if (vertices.empty() || width == 0 || height == 0 || mask.width <= 0 || mask.height <= 0
+				|| mask.pixels.size() < (std::size_t)mask.width * mask.height)
+			return;
+
+		const Transform2D transform = view * model;
+		const std::uint32_t packed = pack(color);
+		const std::size_t n = std::min(vertices.size(), texcoords.size());
+		for (std::size_t i = 0; i + 2 < n; i += 3) {
+			mappings.push_back({ &mask, { texcoords[i], texcoords[i + 1], texcoords[i + 2] } });
+			if (!pushTriangle(transform * vertices[i], transform * vertices[i + 1], transform * vertices[i + 2],
+					packed, (std::uint32_t)(mappings.size() - 1)))
+				mappings.pop_back(); // fora da tela
+		}
+	}
+
+
+	void SoftwareBackend::drawPointSprites(std::span<const Vector2> points, const Transform2D& model, Color color, float size)
+	{
+		if (points.empty() || width == 0 || height == 0)
+			return;
+
+		const Image& mask = pointMask();
+		const Transform2D transform = view * model;
+		const std::uint32_t packed = pack(color);
+		const float half = std::max(size * sizeScale, 1.0f) * 0.5f;
+		for (const Vector2& point : points) {
+			const Vector2 p = transform * point;
+			const Vector2 a{ p.x - half, p.y - half }, b{ p.x + half, p.y - half };
+			const Vector2 c{ p.x + half, p.y + half }, d{ p.x - half, p.y + half };
+			mappings.push_back({ &mask, { { 0.0f, 0.0f }, { 1.0f, 0.0f }, { 1.0f, 1.0f } } });
+			if (!pushTriangle(a, b, c, packed, (std::uint32_t)(mappings.size() - 1)))
+				mappings.pop_back();
+			mappings.push_back({ &mask, { { 0.0f, 0.0f }, { 1.0f, 1.0f }, { 0.0f, 1.0f } } });
+			if (!pushTriangle(a, c, d, packed, (std::uint32_t)(mappings.size() - 1)))
+				mappings.pop_back();
+		}
+	}
+
+
+	void SoftwareBackend::flush()
+	{
+		lastTriangleCount += triangles.size();
+		if (!triangles.empty()) {
+			auto rasterize = [this](std::size_t begin, std::size_t end) {
+				for (std::size_t tile = begin; tile < end; ++tile)
+					if (!bins[tile].empty())
+						rasterizeTile(tile);
+			};
+			if (pool)
+				pool->parallelFor(bins.size(), 1, rasterize);
+			else
+				rasterize(0, bins.size());
+		}
+
+		triangles.clear();
+		mappings.clear();
+		for (auto& bin : bins)
+			bin.clear();
+	}
+
+
+	namespace {
+		// E(p) = A (p.x - x) + B (p.y - y): positiva no interior de um triângulo com área positiva.
+		struct EdgeFunction {
+			float a, b;
+			float x, y;
+			bool topLeft; // pixels exatamente sobre a aresta só pertencem às arestas superior/esquerda
+
+			EdgeFunction(Vector2 from, Vector2 to)
+				: a{ from.y - to.y }, b{ to.x - from.x }, x{ from.x }, y{ from.y },
+				topLeft{ a > 0.0f || (a == 0.0f && b > 0.0f) } {}
+
+			inline float at(float px, float py) const {
+				return a * (px - x) + b * (py - y);
+			}
+
+			inline bool covers(float px, float py) const {
+				float e = at(px, py);
+				return e > 0.0f || (e == 0.0f && topLeft);
+			}
+		};
+	} // namespace
+
+	void SoftwareBackend::rasterizeTile(std::size_t tile)
+	{
+		const int tileX0 = (int)(tile % tilesX) * TILE_SIZE;
+		const int tileY0 = (int)(tile / tilesX) * TILE_SIZE;
+		const int tileX1 = std::min(tileX0 + TILE_SIZE, width) - 1;
+		const int tileY1 = std::min(tileY0 + TILE_SIZE, height) - 1;
+
+		for (std::uint32_t index : bins[tile]) {
+			const Triangle& triangle = triangles[index];
+			Vector2 a = triangle.v[0], b = triangle.v[1], c = triangle.v[2];
+
+			float area = (b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x);
+			if (area == 0.0f)
+				continue;
+			if (area < 0.0f)
+				std::swap(b, c); // orientação única: interior com E > 0
+
+			const EdgeFunction edges[3] = { { b, c }, { c, a }, { a, b } };
+
+			int xmin = std::max(tileX0, first_center(std::min({ a.x, b.x, c.x }), width));
+			int xmax = std::min(tileX1, last_center(std::max({ a.x, b.x, c.x }), width));
+			int ymin = std::max(tileY0, first_center(std::min({ a.y, b.y, c.y }), height));
+			int ymax = std::min(tileY1, last_center(std::max({ a.y, b.y, c.y }), height));
+
+			if (triangle.mapping != NO_MAPPING) {
+				// Máscara: coordenadas baricêntricas (E de cada aresta / área) e o texel mais próximo
+				const Mapping& mapping = mappings[triangle.mapping];
+				const Image& mask = *mapping.mask;
+				Vector2 uvA = mapping.uv[0], uvB = mapping.uv[1], uvC = mapping.uv[2];
+				if (area < 0.0f)
+					std::swap(uvB, uvC);
+				const float inverseArea = 1.0f / std::abs(area);
+				for (int y = ymin; y <= ymax; ++y) {
+					const float py = y + 0.5f;
+					std::uint32_t* row = pixels.data() + (std::size_t)y * width;
+					for (int x = xmin; x <= xmax; ++x) {
+						const float px = x + 0.5f;
+						if (!(edges[0].covers(px, py) && edges[1].covers(px, py) && edges[2].covers(px, py)))
+							continue;
+						const float wa = edges[0].at(px, py) * inverseArea, wb = edges[1].at(px, py) * inverseArea;
+						const Vector2 uv = uvA * wa + uvB * wb + uvC * (1.0f - wa - wb);
+						const int tx = std::clamp((int)(uv.x * mask.width), 0, mask.width - 1);
+						const int ty = std::clamp((int)(uv.y * mask.height), 0, mask.height - 1);
+						const std::uint32_t& texel = mask.pixels[(std::size_t)ty * mask.width + tx];
+						if (reinterpret_cast<const std::uint8_t*>(&texel)[3] >= 128) // alpha
+							row[x] = triangle.color;
+					}
+				}
+				continue;
+			}
+
+#ifdef CG_SSE2
+			const __m128 zero = _mm_setzero_ps();
+			const __m128 lane = _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f); // centros de 4 pixels vizinhos
+			const __m128i color = _mm_set1_epi32((int)triangle.color);
+			__m128 edgeA[3], edgeX[3], topLeft[3];
+			for (int e = 0; e < 3; ++e) {
+				edgeA[e] = _mm_set1_ps(edges[e].a);
+				edgeX[e] = _mm_set1_ps(edges[e].x);
+				topLeft[e] = _mm_castsi128_ps(_mm_set1_epi32(edges[e].topLeft ? -1 : 0));
+			}
+#endif
+
+			for (int y = ymin; y <= ymax; ++y) {
+				const float py = y + 0.5f;
+				std::uint32_t* row = pixels.data() + (std::size_t)y * width;
+				int x = xmin;
+
+#ifdef CG_SSE2
+				__m128 edgeRow[3];
+				for (int e = 0; e < 3; ++e)
+					edgeRow[e] = _mm_set1_ps(edges[e].b * (py - edges[e].y));
+
+				for (; x + 3 <= xmax; x += 4) {
+					const __m128 px = _mm_add_ps(_mm_set1_ps((float)x), lane);
+					__m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+					for (int e = 0; e < 3; ++e) {
+						__m128 value = _mm_add_ps(_mm_mul_ps(edgeA[e], _mm_sub_ps(px, edgeX[e])), edgeRow[e]);
+						__m128 covered = _mm_or_ps(_mm_cmpgt_ps(value, zero),
+							_mm_and_ps(_mm_cmpeq_ps(value, zero), topLeft[e]));
+						inside = _mm_and_ps(inside, covered);
+					}
+					const __m128i mask = _mm_castps_si128(inside);
+					if (_mm_movemask_epi8(mask) == 0)
+						continue;
+					__m128i* target = (__m128i*)(row + x);
+					const __m128i destination = _mm_loadu_si128(target);
+					_mm_storeu_si128(target, _mm_or_si128(_mm_and_si128(mask, color), _mm_andnot_si128(mask, destination)));
+				}
+#endif
+				// Restante da linha (ou a linha toda, sem SIMD)
+				for (; x <= xmax; ++x) {
+					const float px = x + 0.5f;
+					if (edges[0].covers(px, py) && edges[1].covers(px, py) && edges[2].covers(px, py))
+						row[x] = triangle.color;
+				}
+			}
+		}
+	}
+
+} // namespace cg
@@ -0,0 +1,132 @@
+﻿#pragma once
+/* Rasterizador em CPU: desenha as primitivas do Canvas num framebuffer RGBA8 em memória,
+ * sem GPU nem contexto OpenGL (servidores, testes de imagem pixel a pixel).
+ *
+ * Os comandos são convertidos em triângulos de tela e distribuídos em blocos (tiles) de
+ * TILE_SIZE² pixels; cada bloco é rasterizado por um job do `ThreadPool`, na ordem de submissão, com funções
+ * de aresta avaliadas em 4 pixels por vez (SSE2) ou na versão escalar (defina CG_NO_SIMD para forçá-la).
+ * A cobertura segue a regra top-left e os centros de pixel do OpenGL, e a cor substitui o destino
+ * (sem mistura de alpha), como o estado do GL usado pela aplicação. Triângulos com máscara (texto)
+ * amostram o vizinho mais próximo e cobrem o pixel quando o alpha do texel passa da metade
+ * (os pontos redondos também).
+ */
+
+#include <span>
+#include <memory>
+#include <vector>
+#include <cstdint>
+
+#include "math.hpp"
+#include "render_backend.hpp"
+#include "thread_pool.hpp"
+
+
+namespace cg {
+
+    class SoftwareBackend : public RenderBackend {
+    public:
+        static constexpr int TILE_SIZE = 64;
+
+        /** @param threads Quantidade de threads de rasterização, contando a que chama `flush`
+         * (0: as do `ThreadPool::shared`; senão, um pool próprio).
+         */
+        explicit SoftwareBackend(int width = 0, int height = 0, unsigned threads = 0);
+        ~SoftwareBackend();
+
+        SoftwareBackend(const SoftwareBackend&) = delete;
+        SoftwareBackend& operator=(const SoftwareBackend&) = delete;
+
+        /* Redimensiona o framebuffer e restaura a projeção padrão do Canvas. */
+        void resize(int width, int height);
+
+        /** Projeção do mundo para a tela (pixels, y para baixo).
+         * O padrão equivale a `gluOrtho2D(-w/2, w/2, -h/2, h/2)` com o viewport da janela inteira,
+         * o inverso de `Canvas::screenToWorld`.
+         * `size_scale` multiplica tamanhos de ponto e larguras de linha (exportação ampliada).
+         */
+        inline void setView(const Transform2D& world_to_screen, float size_scale = 1.0f) {
+            view = world_to_screen;
+            sizeScale = size_scale;
+        }
+        inline const Transform2D& getView() const {
+            return view;
+        }
+
+        // Projeção da câmera (mantém a escala dos traços definida em `setView`).
+        inline void setProjection(const Transform2D& world_to_screen, Vector2 viewport_size) override {
+            view = world_to_screen;
+        }
+
+        /* Descarta os comandos pendentes e preenche o framebuffer com a cor. */
+        void clear(Color color);
+
+        void draw(Primitive primitive, std::span<const Vector2> vertices,
+            const Transform2D& model, Color color, float size) override;
+        using RenderBackend::draw;
+
+        /* Copia a imagem sobre a área (rasteriza antes os triângulos pendentes, para manter a ordem). */
+        void drawImage(const Image& image, const Rect2& world_area) override;
+        void drawMaskedTriangles(const Image& mask, std::span<const Vector2> vertices,
+            std::span<const Vector2> texcoords, const Transform2D& model, Color color) override;
+        // Dois triângulos com a máscara do disco por ponto.
+        void drawPointSprites(std::span<const Vector2> points, const Transform2D& model, Color color, float size) override;
+        /* Rasteriza os triângulos pendentes e copia o framebuffer. */
+        bool captureImage(Image& image) override;
+
+        /* Rasteriza os comandos pendentes (chame ao final do quadro, antes de ler os pixels). */
+        void flush() override;
+
+        inline int getWidth() const { return width; }
+        inline int getHeight() const { return height; }
+
+        // Pixels RGBA8 (bytes na ordem R, G, B, A), linha 0 no topo, sem espaçamento entre linhas.
+        inline const std::uint32_t* getPixels() const { return pixels.data(); }
+
+        inline std::uint32_t getPixel(int x, int y) const {
+            return pixels[(std::size_t)y * width + x];
+        }
+
+        // Triângulos rasterizados desde o último `clear`.
+        inline std::size_t getTriangleCount() const { return lastTriangleCount; }
+
+        /* Empacota uma cor no formato do framebuffer (arredondamento do GL para unorm8). */
+        static std::uint32_t pack(Color color);
+
+    private:
+        static constexpr std::uint32_t NO_MAPPING = ~0u;
+
+        struct Triangle {
+            Vector2 v[3]; // tela
+            std::uint32_t color;
+            std::uint32_t mapping = NO_MAPPING; // índice em `mappings` (triângulos com máscara)
+        };
+
+        struct Mapping {
+            const Image* mask;
+            Vector2 uv[3];
+        };
+
+        bool pushTriangle(Vector2 a, Vector2 b, Vector2 c, std::uint32_t color, std::uint32_t mapping = NO_MAPPING);
+        void pushQuad(Vector2 a, Vector2 b, Vector2 c, Vector2 d, std::uint32_t color);
+        void pushSegment(Vector2 from, Vector2 to, float width, std::uint32_t color);
+
+        void rasterizeTile(std::size_t tile);
+
+    private:
+        int width = 0, height = 0;
+        int tilesX = 0, tilesY = 0;
+        Transform2D view;
+        float sizeScale = 1.0f;
+        std::vector<std::uint32_t> pixels;
+
+        std::vector<Triangle> triangles; // pendentes, em ordem de submissão
+        std::vector<Mapping> mappings; // dos triângulos pendentes com máscara
+        std::vector<std::vector<std::uint32_t>> bins; // índices dos triângulos que tocam cada bloco
+        std::size_t lastTriangleCount = 0;
+
+        // Threads de rasterização (a thread que chama `flush` também trabalha; nulo: só ela)
+        std::unique_ptr<ThreadPool> ownPool;
+        ThreadPool* pool = nullptr;
+    };
+
+} // namespace cg
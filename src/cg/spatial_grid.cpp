@@ -0,0 +1,116 @@
+﻿#include "spatial_grid.hpp"
+
+#include <cmath>
+#include <algorithm>
+
+
+namespace cg {
+
+	bool SpatialGrid::toCells(const Rect2& area, CellRange& range) const
+	{
+		if (area.isEmpty())
+			return false;
+
+		// Limita às coordenadas representáveis (áreas infinitas cobrem tudo)
+		static constexpr float LIMIT = 1e9f;
+		auto cell = [this](float v) {
+			return (std::int32_t)std::floor(std::clamp(v / cellSize, -LIMIT, LIMIT));
+		};
+		range = { cell(area.min.x), cell(area.min.y), cell(area.max.x), cell(area.max.y), false };
+
+		std::int64_t count = ((std::int64_t)range.x1 - range.x0 + 1) * ((std::int64_t)range.y1 - range.y0 + 1);
+		range.isUnbounded = !area.isFinite() || count > MAX_CELLS_PER_ITEM;
+		return true;
+	}
+
+	void SpatialGrid::erase(std::vector<CanvasItem*>& from, CanvasItem* item)
+	{
+		auto found = std::find(from.begin(), from.end(), item);
+		if (found != from.end()) {
+			*found = from.back();
+			from.pop_back();
+		}
+	}
+
+	void SpatialGrid::update(CanvasItem* item, const Rect2& bounds)
+	{
+		CellRange range;
+		if (!toCells(bounds, range)) {
+			remove(item);
+			return;
+		}
+
+		auto placed = placements.find(item);
+		if (placed != placements.end()) {
+			const CellRange& old = placed->second;
+			if (old.isUnbounded == range.isUnbounded && (range.isUnbounded ||
+					(old.x0 == range.x0 && old.y0 == range.y0 && old.x1 == range.x1 && old.y1 == range.y1)))
+				return; // mesmas células (movimentos pequenos)
+			remove(item);
+		}
+
+		placements[item] = range;
+		if (range.isUnbounded) {
+			unbounded.push_back(item);
+			return;
+		}
+		for (std::int32_t y = range.y0; y <= range.y1; ++y)
+			for (std::int32_t x = range.x0; x <= range.x1; ++x)
+				cells[key(x, y)].push_back(item);
+	}
+
+	void SpatialGrid::remove(CanvasItem* item)
+	{
+		auto placed = placements.find(item);
+		if (placed == placements.end())
+			return;
+
+		const CellRange range = placed->second;
+		placements.erase(placed);
+		if (range.isUnbounded) {
+			erase(unbounded, item);
+			return;
+		}
+		for (std::int32_t y = range.y0; y <= range.y1; ++y)
+			for (std::int32_t x = range.x0; x <= range.x1; ++x) {
+				auto cell = cells.find(key(x, y));
+				if (cell == cells.end())
+					continue;
+				erase(cell->second, item);
+				if (cell->second.empty())
+					cells.erase(cell);
+			}
+	}
+
+	void SpatialGrid::clear()
+	{
+		cells.clear();
+		placements.clear();
+		unbounded.clear();
+	}
+
+	void SpatialGrid::query(const Rect2& area, std::vector<CanvasItem*>& out) const
+	{
+		out.insert(out.end(), unbounded.begin(), unbounded.end());
+
+		CellRange range;
+		if (!toCells(area, range))
+			return;
+
+		std::int64_t count = ((std::int64_t)range.x1 - range.x0 + 1) * ((std::int64_t)range.y1 - range.y0 + 1);
+		if (count > (std::int64_t)cells.size()) {
+			// Área maior que o conjunto ocupado: percorre só as células existentes
+			for (const auto& [cell_key, items] : cells) {
+				auto x = (std::int32_t)(cell_key >> 32), y = (std::int32_t)(std::uint32_t)cell_key;
+				if (x >= range.x0 && x <= range.x1 && y >= range.y0 && y <= range.y1)
+					out.insert(out.end(), items.begin(), items.end());
+			}
+			return;
+		}
+		for (std::int32_t y = range.y0; y <= range.y1; ++y)
+			for (std::int32_t x = range.x0; x <= range.x1; ++x)
+				if (auto cell = cells.find(key(x, y)); cell != cells.end())
+					out.insert(out.end(), cell->second.begin(), cell->second.end());
+	}
+
+} // namespace cg
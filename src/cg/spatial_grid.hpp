@@ -0,0 +1,58 @@
+﻿#pragma once
+/* Índice espacial uniforme dos itens do Canvas, para descarte (culling) e seleção.
+ * Cada item fica nas células cobertas pelos seus limites de mundo; itens grandes demais (ou sem limites)
+ * ficam numa lista à parte, sempre candidata. Uma consulta visita só as células da área pedida,
+ * ou apenas as células ocupadas quando a área é maior que elas (zoom distante).
+ */
+
+#include <vector>
+#include <cstdint>
+#include <unordered_map>
+
+#include "math.hpp"
+
+
+namespace cg {
+
+    class CanvasItem;
+
+    class SpatialGrid {
+    public:
+        static constexpr float DEFAULT_CELL_SIZE = 128.0f; // unidades do mundo
+        static constexpr std::int64_t MAX_CELLS_PER_ITEM = 64; // acima disso o item vai para `unbounded`
+
+        explicit SpatialGrid(float cell_size = DEFAULT_CELL_SIZE) : cellSize{ cell_size } {}
+
+        /* Insere ou reposiciona o item (limites vazios removem o item do índice). */
+        void update(CanvasItem* item, const Rect2& bounds);
+        void remove(CanvasItem* item);
+        void clear();
+
+        /** Acrescenta a `out` os itens cujas células tocam `area`.
+         * Um item pode aparecer mais de uma vez; a ordem não é definida.
+         */
+        void query(const Rect2& area, std::vector<CanvasItem*>& out) const;
+
+        inline std::size_t size() const {
+            return placements.size();
+        }
+
+    private:
+        struct CellRange {
+            std::int32_t x0, y0, x1, y1;
+            bool isUnbounded;
+        };
+
+        bool toCells(const Rect2& area, CellRange& range) const; // `false` se vazia
+        static inline std::uint64_t key(std::int32_t x, std::int32_t y) {
+            return ((std::uint64_t)(std::uint32_t)x << 32) | (std::uint32_t)y;
+        }
+        static void erase(std::vector<CanvasItem*>& from, CanvasItem* item);
+
+        float cellSize;
+        std::unordered_map<std::uint64_t, std::vector<CanvasItem*>> cells;
+        std::unordered_map<CanvasItem*, CellRange> placements;
+        std::vector<CanvasItem*> unbounded;
+    };
+
+} // namespace cg
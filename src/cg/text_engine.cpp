@@ -0,0 +1,313 @@
+﻿#include "text_engine.hpp"
+
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <algorithm>
+
+#include <util.hpp>
+
+// Implementação privada deste arquivo (a da GUI fica em imgui_draw.cpp, também estática)
+#define STBTT_STATIC
+#define STB_TRUETYPE_IMPLEMENTATION
+#include <vendor/imgui/imstb_truetype.h>
+// Fonte embutida da GUI (ProggyClean), último recurso quando não há fonte no sistema
+#include <vendor/proggy_clean.h>
+
+
+namespace cg {
+
+	struct TextEngine::Face {
+		std::vector<unsigned char> data; // o stb_truetype lê direto do arquivo em memória
+		stbtt_fontinfo info{};
+		float scale = 0.0f; // unidades da fonte -> pixels do atlas
+	};
+
+	namespace {
+		// Fontes tentadas quando nenhuma foi carregada (depois de CG_FONT)
+		constexpr const char* DEFAULT_FONTS[] = {
+			"/usr/share/fonts/truetype/dejavu/DejaVuSans.ttf",
+			"/usr/share/fonts/TTF/DejaVuSans.ttf",
+			"/usr/share/fonts/dejavu/DejaVuSans.ttf",
+			"/System/Library/Fonts/Supplemental/Arial.ttf",
+			"/Library/Fonts/Arial.ttf",
+			"C:/Windows/Fonts/arial.ttf",
+		};
+
+		// Decodifica UTF-8 (sequências inválidas viram U+FFFD).
+		std::vector<std::uint32_t> decodeUtf8(std::string_view text)
+		{
+			std::vector<std::uint32_t> codepoints;
+			codepoints.reserve(text.size());
+			for (std::size_t i = 0; i < text.size();) {
+				const auto lead = (unsigned char)text[i];
+				int length = lead < 0x80 ? 1 : (lead >> 5) == 0x6 ? 2 : (lead >> 4) == 0xE ? 3 : (lead >> 3) == 0x1E ? 4 : 0;
+				if (length == 0 || i + length > text.size()) {
+					codepoints.push_back(0xFFFD);
+					++i;
+					continue;
+				}
+				std::uint32_t codepoint = length == 1 ? lead : lead & (0x7F >> length);
+				bool isValid = true;
+				for (int k = 1; k < length; ++k) {
+					const auto next = (unsigned char)text[i + k];
+					isValid = isValid && (next >> 6) == 0x2;
+					codepoint = (codepoint << 6) | (next & 0x3F);
+				}
+				codepoints.push_back(isValid ? codepoint : 0xFFFD);
+				i += isValid ? length : 1;
+			}
+			return codepoints;
+		}
+
+		// Dois triângulos do retângulo `quad` (local) com o retângulo `uv` do atlas.
+		template <typename Map>
+		void pushQuad(TextEngine::Layout& layout, const Rect2& quad, Vector2 uv_min, Vector2 uv_max, Map&& map)
+		{
+			const Vector2 corners[4] = {
+				map(Vector2{ quad.min.x, quad.max.y }), map(quad.max), map(Vector2{ quad.max.x, quad.min.y }), map(quad.min),
+			};
+			const Vector2 uvs[4] = { uv_min, { uv_max.x, uv_min.y }, uv_max, { uv_min.x, uv_max.y } };
+			for (int i : { 0, 1, 2, 0, 2, 3 }) {
+				layout.vertices.push_back(corners[i]);
+				layout.texcoords.push_back(uvs[i]);
+			}
+			for (const Vector2& corner : corners)
+				layout.bounds.expand(corner);
+		}
+	} // namespace
+
+	TextEngine& TextEngine::instance()
+	{
+		static TextEngine engine;
+		return engine;
+	}
+
+	TextEngine::TextEngine()
+	{
+		atlas.isSmooth = true;
+	}
+
+	TextEngine::~TextEngine() = default;
+
+	bool TextEngine::loadFont(const std::string& path)
+	{
+		std::ifstream file{ path, std::ios::binary };
+		if (!file) {
+			print_error("Fonte não encontrada: %s", path.c_str());
+			return false;
+		}
+		return useFont({ std::istreambuf_iterator<char>{ file }, std::istreambuf_iterator<char>{} }, path.c_str());
+	}
+
+	bool TextEngine::loadEmbeddedFont()
+	{
+		std::vector<unsigned char> data(stb_decompress_length(proggy_clean_ttf_compressed_data));
+		if (stb_decompress(data.data(), proggy_clean_ttf_compressed_data, proggy_clean_ttf_compressed_size) != data.size()) {
+			print_error("Falha ao descompactar a fonte embutida (ProggyClean).");
+			return false;
+		}
+		return useFont(std::move(data), "ProggyClean.ttf");
+	}
+
+	bool TextEngine::useFont(std::vector<unsigned char> data, const char* name)
+	{
+		auto loaded = std::make_unique<Face>();
+		loaded->data = std::move(data);
+		const int offset = loaded->data.empty() ? -1 : stbtt_GetFontOffsetForIndex(loaded->data.data(), 0);
+		if (offset < 0 || !stbtt_InitFont(&loaded->info, loaded->data.data(), offset)) {
+			print_error("Fonte TrueType inválida: %s", name);
+			return false;
+		}
+		loaded->scale = stbtt_ScaleForPixelHeight(&loaded->info, GLYPH_PIXELS);
+
+		face = std::move(loaded);
+		triedDefaultFont = true;
+		reset();
+		return true;
+	}
+
+	bool TextEngine::hasFont()
+	{
+		if (face || triedDefaultFont)
+			return face != nullptr;
+		triedDefaultFont = true;
+
+		if (const char* path = std::getenv("CG_FONT"); path && *path && loadFont(path))
+			return true;
+		for (const char* path : DEFAULT_FONTS)
+			if (std::ifstream{ path, std::ios::binary } && loadFont(path))
+				return true;
+		print_warning("Nenhuma fonte TrueType encontrada (defina CG_FONT): usando a fonte embutida da GUI.");
+		return loadEmbeddedFont();
+	}
+
+	void TextEngine::reset()
+	{
+		const std::uint8_t clear[4] = { 255, 255, 255, 0 }; // branco transparente: a cor vem do texto
+		std::uint32_t texel;
+		std::memcpy(&texel, clear, sizeof(texel));
+
+		atlas.width = atlas.height = ATLAS_SIZE;
+		atlas.pixels.assign((std::size_t)ATLAS_SIZE * ATLAS_SIZE, texel);
+		++atlas.revision;
+		++generation;
+		glyphs.clear();
+		shelfX = shelfY = shelfHeight = 0;
+		layouts.clear();
+	}
+
+	const TextEngine::Glyph* TextEngine::glyph(std::uint32_t codepoint)
+	{
+		if (auto found = glyphs.find(codepoint); found != glyphs.end())
+			return &found->second;
+		if (!face)
+			return nullptr;
+
+		const stbtt_fontinfo& info = face->info;
+		const float scale = face->scale;
+		int advance, bearing, x0, y0, x1, y1;
+		stbtt_GetCodepointHMetrics(&info, (int)codepoint, &advance, &bearing);
+		stbtt_GetCodepointBitmapBox(&info, (int)codepoint, scale, scale, &x0, &y0, &x1, &y1);
+
+		Glyph glyph;
+		glyph.advance = advance * scale;
+		const int width = x1 - x0, height = y1 - y0;
+		if (width > 0 && height > 0) {
+			// Próxima posição livre da prateleira atual, ou de uma nova abaixo dela
+			if (shelfX + width + 2 * GLYPH_PADDING > ATLAS_SIZE) {
+				shelfY += shelfHeight;
+				shelfX = shelfHeight = 0;
+			}
+			if (shelfY + height + 2 * GLYPH_PADDING > ATLAS_SIZE || width + 2 * GLYPH_PADDING > ATLAS_SIZE)
+				return nullptr; // atlas cheio
+
+			const int x = shelfX + GLYPH_PADDING, y = shelfY + GLYPH_PADDING;
+			std::vector<unsigned char> coverage((std::size_t)width * height);
+			stbtt_MakeCodepointBitmap(&info, coverage.data(), width, height, width, scale, scale, (int)codepoint);
+			for (int row = 0; row < height; ++row) {
+				auto* target = reinterpret_cast<std::uint8_t*>(atlas.pixels.data() + (std::size_t)(y + row) * ATLAS_SIZE + x);
+				for (int column = 0; column < width; ++column)
+					target[column * 4 + 3] = coverage[(std::size_t)row * width + column];
+			}
+			++atlas.revision;
+			shelfX += width + 2 * GLYPH_PADDING;
+			shelfHeight = std::max(shelfHeight, height + 2 * GLYPH_PADDING);
+
+			// O stb_truetype usa y para baixo a partir da linha de base
+			glyph.quad = { { (float)x0, (float)-y1 }, { (float)x1, (float)-y0 } };
+			glyph.uvMin = Vector2{ (float)x, (float)y } / (float)ATLAS_SIZE;
+			glyph.uvMax = Vector2{ (float)(x + width), (float)(y + height) } / (float)ATLAS_SIZE;
+		}
+		return &glyphs.emplace(codepoint, glyph).first->second;
+	}
+
+	float TextEngine::kerning(std::uint32_t previous, std::uint32_t codepoint) const
+	{
+		return stbtt_GetCodepointKernAdvance(&face->info, (int)previous, (int)codepoint) * face->scale;
+	}
+
+	std::size_t TextEngine::KeyHash::operator()(const Key& key) const
+	{
+		std::size_t hash = std::hash<std::string>{}(key.text);
+		for (float value : { key.size, key.radius, key.start, key.end })
+			hash = hash * 31 + std::hash<float>{}(value);
+		return hash * 2 + key.isArc;
+	}
+
+	bool TextEngine::build(const Key& key, Layout& layout)
+	{
+		// Posição de cada glifo na linha, em pixels do atlas
+		struct Placed {
+			const Glyph* glyph;
+			float x;
+		};
+		std::vector<Placed> placed;
+		float pen = 0.0f;
+		std::uint32_t previous = 0;
+		const std::uint64_t started = generation;
+		for (std::uint32_t codepoint : decodeUtf8(key.text)) {
+			const Glyph* found = glyph(codepoint);
+			if (!found) {
+				if (generation != started)
+					continue; // não cabe nem num atlas vazio
+				reset();
+				return false;
+			}
+			if (previous)
+				pen += kerning(previous, codepoint);
+			placed.push_back({ found, pen });
+			pen += found->advance;
+			previous = codepoint;
+		}
+
+		const float scale = key.size / GLYPH_PIXELS;
+		layout.advance = pen * scale;
+		layout.generation = generation;
+		if (!key.isArc) {
+			for (const Placed& item : placed)
+				if (!item.glyph->quad.isEmpty())
+					pushQuad(layout, item.glyph->quad, item.glyph->uvMin, item.glyph->uvMax,
+						[&](Vector2 p) { return Vector2{ item.x + p.x, p.y } * scale; });
+			return true;
+		}
+
+		if (pen <= 0.0f)
+			return true;
+		// Cada glifo centrado no seu ângulo, em pé sobre o arco
+		const float arc = key.end - key.start;
+		for (const Placed& item : placed) {
+			const Glyph& found = *item.glyph;
+			if (found.quad.isEmpty())
+				continue;
+			const float angle = key.start + arc * (item.x + found.advance / 2.0f) / pen;
+			const float rotation = angle + PI<float> / 2.0f + (arc < 0.0f ? PI<float> : 0.0f);
+			const Vector2 origin{ key.radius * std::cos(angle), key.radius * std::sin(angle) };
+			const float cosine = std::cos(rotation), sine = std::sin(rotation);
+			pushQuad(layout, found.quad, found.uvMin, found.uvMax, [&](Vector2 p) {
+				const Vector2 local = Vector2{ p.x - found.advance / 2.0f, p.y } * scale;
+				return origin + Vector2{ local.x * cosine - local.y * sine, local.x * sine + local.y * cosine };
+			});
+		}
+		return true;
+	}
+
+	std::shared_ptr<const TextEngine::Layout> TextEngine::cached(Key&& key)
+	{
+		if (auto found = layouts.find(key); found != layouts.end())
+			return found->second;
+
+		auto layout = std::make_shared<Layout>();
+		if (hasFont() && !build(key, *layout)) {
+			*layout = {};
+			build(key, *layout); // atlas refeito: os glifos do texto cabem no vazio
+		}
+		layout->generation = generation;
+
+		if (layouts.size() >= MAX_LAYOUTS)
+			layouts.clear();
+		layouts.emplace(std::move(key), layout);
+		return layout;
+	}
+
+	std::shared_ptr<const TextEngine::Layout> TextEngine::layout(std::string_view text, float size)
+	{
+		return cached({ std::string{ text }, size, 0.0f, 0.0f, 0.0f, false });
+	}
+
+	std::shared_ptr<const TextEngine::Layout> TextEngine::layoutArc(std::string_view text, float size,
+		float radius, float start_angle, float end_angle)
+	{
+		return cached({ std::string{ text }, size, radius, start_angle, end_angle, true });
+	}
+
+	void TextEngine::draw(const Layout& layout, const Transform2D& model, Color color)
+	{
+		if (layout.vertices.empty() || !isCurrent(layout))
+			return;
+		RenderBackend::current().drawMaskedTriangles(atlas, layout.vertices, layout.texcoords, model, color);
+	}
+
+} // namespace cg
@@ -0,0 +1,120 @@
+﻿#pragma once
+/* Texto por atlas de glifos (substitui os caracteres vetoriais do GLUT).
+ * Os glifos de uma fonte TrueType (stb_truetype, de src/vendor/imgui) são rasterizados uma única vez,
+ * sob demanda, numa imagem compartilhada: branca, com a cobertura no alpha. Cada texto vira uma lista
+ * de triângulos texturizados (dois por glifo), guardada em cache pela string e pelos parâmetros do layout,
+ * e é desenhado numa só chamada (`RenderBackend::drawMaskedTriangles`), qualquer que seja o tamanho.
+ *
+ * A fonte vem de `loadFont`, da variável de ambiente CG_FONT ou das fontes do sistema (DejaVu Sans, Arial);
+ * sem nenhuma, da fonte embutida do Dear ImGui (ProggyClean, em src/vendor/proggy_clean.h).
+ * Quando o atlas enche ele é refeito do zero, numa nova geração, e os layouts em cache são descartados
+ * (quem guarda um layout confere `isCurrent`).
+ */
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <string_view>
+#include <unordered_map>
+
+#include "math.hpp"
+#include "render_backend.hpp"
+
+
+namespace cg {
+
+    class TextEngine {
+    public:
+        static constexpr int ATLAS_SIZE = 1024; // pixels por lado
+        static constexpr float GLYPH_PIXELS = 48.0f; // altura de uma linha no atlas (ascendente até descendente)
+        static constexpr int GLYPH_PADDING = 2; // pixels vazios em volta de cada glifo (filtragem linear)
+        static constexpr std::size_t MAX_LAYOUTS = 4096; // layouts em cache antes de descartar todos
+
+        // Texto pronto para desenhar, no sistema local: linha de base em y = 0, começando em x = 0, y para cima.
+        struct Layout {
+            std::vector<Vector2> vertices; // dois triângulos por glifo visível
+            std::vector<Vector2> texcoords; // no atlas
+            Rect2 bounds; // dos glifos (vazio sem glifos visíveis)
+            float advance = 0.0f; // largura do texto, com espaços
+            std::uint64_t generation = 0; // do atlas em que as coordenadas de textura valem
+        };
+
+        /* Atlas da aplicação (usado pela thread de desenho). */
+        static TextEngine& instance();
+
+        TextEngine();
+        ~TextEngine();
+
+        TextEngine(const TextEngine&) = delete;
+        TextEngine& operator=(const TextEngine&) = delete;
+
+        /* Troca a fonte por um arquivo TrueType; descarta o atlas e os layouts em cache. */
+        bool loadFont(const std::string& path);
+        /* Carrega a fonte padrão na primeira chamada (CG_FONT, do sistema ou a embutida). */
+        bool hasFont();
+
+        /** Texto em uma linha (UTF-8), com `size` unidades entre o topo dos ascendentes e o fundo dos descendentes. */
+        std::shared_ptr<const Layout> layout(std::string_view text, float size);
+
+        /** Texto ao longo de um arco centrado na origem, com a linha de base no raio `radius`, centrado entre os ângulos.
+         * Os glifos seguem de `start_angle` a `end_angle` (radianos): no sentido anti-horário ficam com o topo para o centro,
+         * no horário (`end_angle < start_angle`) com o topo para fora.
+         */
+        std::shared_ptr<const Layout> layoutArc(std::string_view text, float size,
+            float radius, float start_angle, float end_angle);
+
+        /* Submete o layout ao backend atual, numa chamada (sem efeito se o atlas mudou de geração desde o layout). */
+        void draw(const Layout& layout, const Transform2D& model, Color color);
+
+        inline const Image& getAtlas() const { return atlas; }
+        inline bool isCurrent(const Layout& layout) const { return layout.generation == generation; }
+        inline std::size_t getGlyphCount() const { return glyphs.size(); }
+
+    private:
+        struct Glyph {
+            Rect2 quad; // retângulo do bitmap em pixels do atlas, relativo à origem do glifo (y para cima)
+            Vector2 uvMin, uvMax; // canto superior esquerdo / inferior direito no atlas
+            float advance = 0.0f; // pixels do atlas
+        };
+
+        struct Key {
+            std::string text;
+            float size, radius, start, end;
+            bool isArc;
+
+            bool operator==(const Key&) const = default;
+        };
+        struct KeyHash {
+            std::size_t operator()(const Key& key) const;
+        };
+
+        struct Face; // fonte do stb_truetype
+
+        // Adota o arquivo TrueType em memória (`name` só para as mensagens de erro).
+        bool useFont(std::vector<unsigned char> data, const char* name);
+        bool loadEmbeddedFont();
+
+        // Glifo do código Unicode, rasterizado no atlas na primeira vez (nulo sem fonte ou sem espaço no atlas).
+        const Glyph* glyph(std::uint32_t codepoint);
+        float kerning(std::uint32_t previous, std::uint32_t codepoint) const;
+        // Esvazia o atlas e os layouts, numa nova geração.
+        void reset();
+
+        std::shared_ptr<const Layout> cached(Key&& key);
+        // Preenche o layout; `false` se o atlas foi refeito no meio (refaça o layout)
+        bool build(const Key& key, Layout& layout);
+
+    private:
+        std::unique_ptr<Face> face;
+        bool triedDefaultFont = false;
+
+        Image atlas;
+        std::uint64_t generation = 1;
+        std::unordered_map<std::uint32_t, Glyph> glyphs;
+        int shelfX = 0, shelfY = 0, shelfHeight = 0; // empacotamento em prateleiras
+
+        std::unordered_map<Key, std::shared_ptr<const Layout>, KeyHash> layouts;
+    };
+
+} // namespace cg
@@ -0,0 +1,210 @@
+﻿#include "thread_pool.hpp"
+
+#include <algorithm>
+
+
+namespace cg {
+
+	// Thread do pool em execução (para achar a própria fila)
+	static thread_local const ThreadPool* currentPool = nullptr;
+	static thread_local std::size_t currentQueue = 0;
+
+	ThreadPool::ThreadPool(unsigned threads)
+	{
+		unsigned count = threads ? threads : std::max(1u, std::thread::hardware_concurrency()) - 1;
+		for (unsigned i = 0; i <= count; ++i)
+			queues.push_back(std::make_unique<Queue>());
+		for (unsigned i = 0; i < count; ++i)
+			workers.emplace_back(&ThreadPool::workerLoop, this, i);
+	}
+
+	ThreadPool::~ThreadPool()
+	{
+		{
+			std::lock_guard lock{ sleepMutex };
+			stopping = true;
+		}
+		wake.notify_all();
+		for (std::thread& worker : workers)
+			worker.join();
+	}
+
+	ThreadPool& ThreadPool::shared()
+	{
+		static ThreadPool pool;
+		return pool;
+	}
+
+	std::size_t ThreadPool::queueOfThisThread() const
+	{
+		return currentPool == this ? currentQueue : queues.size() - 1;
+	}
+
+	void ThreadPool::push(std::size_t queue, Task task)
+	{
+		Queue& own = *queues[queue];
+		(task.job ? own.jobs : own.blocks).fetch_add(1, std::memory_order_relaxed);
+		std::lock_guard lock{ own.mutex };
+		own.tasks.push_back(std::move(task));
+		queued.fetch_add(1, std::memory_order_release);
+	}
+
+	void ThreadPool::notify()
+	{
+		{
+			std::lock_guard lock{ sleepMutex }; // quem viu as filas vazias já está esperando
+		}
+		wake.notify_all();
+	}
+
+	bool ThreadPool::pop(std::size_t queue, Task& task)
+	{
+		Queue& own = *queues[queue];
+		std::lock_guard lock{ own.mutex };
+		if (own.tasks.empty())
+			return false;
+		task = std::move(own.tasks.back());
+		own.tasks.pop_back();
+		queued.fetch_sub(1, std::memory_order_relaxed);
+		return true;
+	}
+
+	bool ThreadPool::steal(std::size_t thief, Task& task)
+	{
+		const std::size_t count = queues.size();
+		for (std::size_t offset = 1; offset < count; ++offset) {
+			Queue& victim = *queues[(thief + offset) % count];
+			std::lock_guard lock{ victim.mutex };
+			if (victim.tasks.empty())
+				continue;
+			task = std::move(victim.tasks.front());
+			victim.tasks.pop_front();
+			queued.fetch_sub(1, std::memory_order_relaxed);
+			queues[thief]->stolen.fetch_add(1, std::memory_order_relaxed);
+			return true;
+		}
+		return false;
+	}
+
+	bool ThreadPool::runOne(std::size_t queue)
+	{
+		Task task;
+		if (!pop(queue, task) && !steal(queue, task))
+			return false;
+		if (task.job) {
+			task.job->work();
+			task.job->work = nullptr; // libera o que a função capturou
+			finish(std::move(task.job));
+		}
+		else {
+			(*task.body)(task.begin, task.end);
+			task.pending->fetch_sub(1, std::memory_order_acq_rel);
+		}
+		queues[queue]->executed.fetch_add(1, std::memory_order_relaxed);
+		return true;
+	}
+
+	void ThreadPool::help(std::size_t queue)
+	{
+		if (runOne(queue))
+			queues[queue]->helped.fetch_add(1, std::memory_order_relaxed);
+		else
+			std::this_thread::yield();
+	}
+
+	void ThreadPool::finish(JobHandle job)
+	{
+		// O último a terminar (o trabalho ou um filho) conclui o job e avisa o pai
+		while (job && job->unfinished.fetch_sub(1, std::memory_order_acq_rel) == 1)
+			job = std::move(job->parent);
+	}
+
+	void ThreadPool::parallelFor(std::size_t count, std::size_t grain, const RangeFunction& body)
+	{
+		if (count == 0)
+			return;
+		grain = std::max<std::size_t>(grain, 1);
+		if (workers.empty() || count <= grain) {
+			body(0, count);
+			return;
+		}
+
+		// Blocos na fila de quem chama (roubados do começo pelas demais); o primeiro fica para esta thread
+		const std::size_t queue = queueOfThisThread();
+		const std::size_t blocks = (count + grain - 1) / grain;
+		std::atomic<std::size_t> pending{ blocks - 1 };
+		for (std::size_t block = blocks - 1; block > 0; --block)
+			push(queue, { &body, block * grain, std::min(count, (block + 1) * grain), &pending });
+		notify();
+
+		body(0, std::min(count, grain));
+		// Ajuda enquanto espera: executa qualquer tarefa disponível (inclusive de outros `parallelFor`)
+		while (pending.load(std::memory_order_acquire) != 0)
+			help(queue);
+	}
+
+	ThreadPool::JobHandle ThreadPool::spawn(std::function<void()> work, const JobHandle& parent)
+	{
+		auto job = std::make_shared<Job>();
+		job->work = std::move(work);
+		if (parent) {
+			parent->unfinished.fetch_add(1, std::memory_order_relaxed);
+			job->parent = parent;
+		}
+
+		if (workers.empty()) {
+			// Sem threads no pool: executa já (os filhos criados dentro dele também)
+			job->work();
+			job->work = nullptr;
+			finish(job);
+			queues.back()->jobs.fetch_add(1, std::memory_order_relaxed);
+			queues.back()->executed.fetch_add(1, std::memory_order_relaxed);
+			return job;
+		}
+		push(queueOfThisThread(), { .job = job });
+		notify();
+		return job;
+	}
+
+	void ThreadPool::wait(const JobHandle& job)
+	{
+		const std::size_t queue = queueOfThisThread();
+		while (job && !job->isDone())
+			help(queue);
+	}
+
+	profiler::JobCounters ThreadPool::getCounters() const
+	{
+		profiler::JobCounters counters;
+		for (const auto& queue : queues) {
+			counters.jobs += queue->jobs.load(std::memory_order_relaxed);
+			counters.blocks += queue->blocks.load(std::memory_order_relaxed);
+			counters.executed += queue->executed.load(std::memory_order_relaxed);
+			counters.stolen += queue->stolen.load(std::memory_order_relaxed);
+			counters.helped += queue->helped.load(std::memory_order_relaxed);
+		}
+		return counters;
+	}
+
+	void ThreadPool::resetCounters()
+	{
+		for (const auto& queue : queues)
+			for (auto* counter : { &queue->jobs, &queue->blocks, &queue->executed, &queue->stolen, &queue->helped })
+				counter->store(0, std::memory_order_relaxed);
+	}
+
+	void ThreadPool::workerLoop(std::size_t index)
+	{
+		currentPool = this;
+		currentQueue = index;
+		while (true) {
+			if (runOne(index))
+				continue;
+			std::unique_lock lock{ sleepMutex };
+			wake.wait(lock, [this] { return stopping || queued.load(std::memory_order_acquire) > 0; });
+			if (stopping)
+				return;
+		}
+	}
+
+} // namespace cg
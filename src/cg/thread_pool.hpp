@@ -0,0 +1,122 @@
+﻿#pragma once
+/* Sistema de jobs com roubo de trabalho (work stealing), compartilhado pelo desenho, carga de cenas
+ * e rasterização em CPU (a tesselação dos polígonos visíveis roda no preparo paralelo do desenho).
+ * Cada thread do pool tem a própria fila: a dona tira do fim (as tarefas que ela mesma acabou de criar,
+ * ainda no cache) e as demais, sem trabalho, roubam do começo. Tarefas vindas de fora do pool entram
+ * numa fila externa, que todas as threads também esvaziam.
+ *
+ * Há dois tipos de tarefa: blocos de um `parallelFor` e jobs avulsos (`spawn`), que podem ter um pai:
+ * o pai só termina quando o próprio trabalho e todos os filhos terminam.
+ * Quem espera (`parallelFor` e `wait`) executa tarefas enquanto isso, então chamadas aninhadas (de dentro
+ * de uma tarefa) não travam o pool e a thread da GLUT nunca fica parada esperando.
+ */
+
+#include <span>
+#include <deque>
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <condition_variable>
+
+#include "profiler.hpp"
+
+
+namespace cg {
+
+    class ThreadPool {
+    public:
+        using RangeFunction = std::function<void(std::size_t begin, std::size_t end)>;
+
+        struct Job {
+            std::function<void()> work;
+            std::shared_ptr<Job> parent;
+            std::atomic<std::size_t> unfinished{ 1 }; // o próprio trabalho e os filhos pendentes
+
+            inline bool isDone() const {
+                return unfinished.load(std::memory_order_acquire) == 0;
+            }
+        };
+        using JobHandle = std::shared_ptr<Job>;
+
+        /** @param threads Threads do pool (0: uma por núcleo, menos a thread que chama). */
+        explicit ThreadPool(unsigned threads = 0);
+        ~ThreadPool();
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        /* Pool compartilhado da aplicação (criado no primeiro uso). */
+        static ThreadPool& shared();
+
+        /** Executa `body(begin, end)` sobre blocos de até `grain` índices de [0, count), em paralelo,
+         * e retorna quando todos terminam. A thread que chama também executa blocos.
+         */
+        void parallelFor(std::size_t count, std::size_t grain, const RangeFunction& body);
+
+        /* `parallelFor` sobre os elementos: `body` recebe subintervalos de até `grain` elementos. */
+        template <typename T, typename Body>
+        inline void parallelFor(std::span<T> items, std::size_t grain, Body&& body) {
+            parallelFor(items.size(), grain, [&](std::size_t begin, std::size_t end) {
+                body(items.subspan(begin, end - begin));
+            });
+        }
+
+        /** Agenda `work` para alguma thread do pool.
+         * Com `parent`, o pai só termina depois deste filho; crie os filhos antes de o pai terminar
+         * (por exemplo, dentro do trabalho dele).
+         */
+        JobHandle spawn(std::function<void()> work, const JobHandle& parent = nullptr);
+
+        /* Espera o job e os filhos dele, executando outras tarefas enquanto isso. */
+        void wait(const JobHandle& job);
+
+        // Threads do pool (sem contar quem chama `parallelFor`).
+        inline unsigned getThreadCount() const {
+            return (unsigned)workers.size();
+        }
+
+        /* Contadores desde a criação ou o último `resetCounters` (aproximados com tarefas em andamento). */
+        profiler::JobCounters getCounters() const;
+        void resetCounters();
+
+    private:
+        struct Task {
+            const RangeFunction* body = nullptr; // bloco de `parallelFor` (sem `job`)
+            std::size_t begin = 0, end = 0;
+            std::atomic<std::size_t>* pending = nullptr; // blocos restantes do `parallelFor`
+            JobHandle job; // job avulso
+        };
+
+        // Uma linha de cache por fila: os contadores são escritos por threads diferentes
+        struct alignas(64) Queue {
+            std::mutex mutex;
+            std::deque<Task> tasks;
+            std::atomic<std::uint64_t> jobs{ 0 }, blocks{ 0 }, executed{ 0 }, stolen{ 0 }, helped{ 0 };
+        };
+
+        void push(std::size_t queue, Task task);
+        bool pop(std::size_t queue, Task& task); // fim da própria fila
+        bool steal(std::size_t thief, Task& task); // começo das filas das outras threads
+        bool runOne(std::size_t queue); // executa uma tarefa, se houver
+        void help(std::size_t queue); // executa uma tarefa enquanto espera (ou cede a vez)
+        void finish(JobHandle job); // trabalho ou filho concluído
+        void notify();
+        std::size_t queueOfThisThread() const;
+        void workerLoop(std::size_t index);
+
+    private:
+        std::vector<std::unique_ptr<Queue>> queues; // uma por thread do pool e a externa (a última)
+        std::vector<std::thread> workers;
+
+        std::mutex sleepMutex;
+        std::condition_variable wake;
+        std::atomic<std::size_t> queued{ 0 }; // tarefas nas filas
+        bool stopping = false;
+    };
+
+} // namespace cg
@@ -0,0 +1,103 @@
+﻿#include "tile_cache.hpp"
+
+#include <bit>
+#include <cmath>
+#include <algorithm>
+
+
+namespace cg {
+
+	std::size_t TileCache::KeyHash::operator()(const Key& key) const
+	{
+		std::uint64_t h = std::bit_cast<std::uint32_t>(key.grid.zoom);
+		for (std::uint32_t v : { std::bit_cast<std::uint32_t>(key.grid.phase.x), std::bit_cast<std::uint32_t>(key.grid.phase.y),
+				(std::uint32_t)key.x, (std::uint32_t)key.y })
+			h = (h ^ v) * 0x9E3779B97F4A7C15ull;
+		return (std::size_t)(h ^ (h >> 29));
+	}
+
+	TileCache::Grid TileCache::gridOf(const Transform2D& world_to_screen)
+	{
+		// Quantiza a fase: arrastos por pixels inteiros acumulam erro de arredondamento na posição da câmera
+		auto phase = [](float v) {
+			float fraction = std::round((v - std::floor(v)) * 64.0f) / 64.0f;
+			return fraction >= 1.0f ? 0.0f : fraction;
+		};
+		const Vector2 origin = world_to_screen * Vector2{};
+		return { world_to_screen.get(0, 0), { phase(origin.x), phase(origin.y) } };
+	}
+
+	// Coordenadas da grade: u = x * zoom + fase.x, v = fase.y - y * zoom (pixels, y para baixo)
+
+	Rect2 TileCache::tileArea(const Grid& grid, std::int32_t x, std::int32_t y)
+	{
+		const float z = grid.zoom;
+		return {
+			{ ((float)x * TILE_SIZE - grid.phase.x) / z, (grid.phase.y - (float)(y + 1) * TILE_SIZE) / z },
+			{ ((float)(x + 1) * TILE_SIZE - grid.phase.x) / z, (grid.phase.y - (float)y * TILE_SIZE) / z },
+		};
+	}
+
+	Transform2D TileCache::tileView(const Grid& grid, std::int32_t x, std::int32_t y)
+	{
+		return { { grid.zoom, 0.0f }, { 0.0f, -grid.zoom },
+			{ grid.phase.x - (float)x * TILE_SIZE, grid.phase.y - (float)y * TILE_SIZE } };
+	}
+
+	void TileCache::tileRange(const Grid& grid, const Rect2& area,
+			std::int32_t& x0, std::int32_t& y0, std::int32_t& x1, std::int32_t& y1)
+	{
+		static constexpr float LIMIT = 1e9f;
+		auto tile = [](float pixels) {
+			return (std::int32_t)std::floor(std::clamp(pixels / TILE_SIZE, -LIMIT, LIMIT));
+		};
+		x0 = tile(area.min.x * grid.zoom + grid.phase.x);
+		x1 = tile(area.max.x * grid.zoom + grid.phase.x);
+		y0 = tile(grid.phase.y - area.max.y * grid.zoom);
+		y1 = tile(grid.phase.y - area.min.y * grid.zoom);
+	}
+
+	TileCache::Tile& TileCache::acquire(const Grid& grid, std::int32_t x, std::int32_t y, std::uint64_t frame, RenderBackend& backend)
+	{
+		auto [found, inserted] = tiles.try_emplace(Key{ grid, x, y });
+		Tile& tile = found->second;
+		tile.lastUsed = frame;
+		if (!inserted)
+			return tile;
+
+		tile.image.width = tile.image.height = TILE_SIZE;
+		tile.image.pixels.resize((std::size_t)TILE_SIZE * TILE_SIZE);
+		tile.area = tileArea(grid, x, y);
+		tile.grid = grid;
+
+		// Descarta os menos usados (nunca os do quadro atual)
+		while (tiles.size() > MAX_TILES) {
+			auto oldest = tiles.end();
+			for (auto it = tiles.begin(); it != tiles.end(); ++it)
+				if (it->second.lastUsed < frame && (oldest == tiles.end() || it->second.lastUsed < oldest->second.lastUsed))
+					oldest = it;
+			if (oldest == tiles.end())
+				break; // a vista precisa de todos
+			backend.releaseImage(oldest->second.image.id);
+			tiles.erase(oldest);
+		}
+		return tile;
+	}
+
+	void TileCache::invalidate(const Rect2& world_area, float margin_pixels)
+	{
+		if (world_area.isEmpty())
+			return;
+		for (auto& [key, tile] : tiles)
+			if (tile.isValid && tile.area.intersects(world_area.grown(margin_pixels / tile.grid.zoom)))
+				tile.isValid = false;
+	}
+
+	void TileCache::clear(RenderBackend& backend)
+	{
+		for (auto& [key, tile] : tiles)
+			backend.releaseImage(tile.image.id);
+		tiles.clear();
+	}
+
+} // namespace cg
@@ -0,0 +1,78 @@
+﻿#pragma once
+/* Cache de blocos rasterizados (tiles) com o conteúdo estático do Canvas.
+ * Cada bloco cobre TILE_SIZE² pixels da tela, alinhados à grade de pixels da câmera (zoom exato e fase
+ * sub-pixel da origem), e guarda a imagem dos itens que não mudaram nos últimos quadros: arrastar a vista
+ * por pixels inteiros reaproveita os blocos sem reamostragem; o quadro compõe as imagens e desenha por cima só os itens
+ * alterados recentemente. Uma edição invalida apenas os blocos sob os limites de mundo do item
+ * (antes e depois da mudança). Os blocos menos usados são descartados além de MAX_TILES.
+ */
+
+#include <vector>
+#include <cstdint>
+#include <unordered_map>
+
+#include "math.hpp"
+#include "render_backend.hpp"
+
+
+namespace cg {
+
+    class TileCache {
+    public:
+        static constexpr int TILE_SIZE = 256; // pixels
+        static constexpr std::size_t MAX_TILES = 128; // 32 MiB de pixels
+        static constexpr std::uint64_t LIVE_FRAMES = 30; // quadros sem mudança até o item voltar aos blocos
+        static constexpr int BAKES_PER_FRAME = 4; // os demais blocos inválidos são desenhados direto
+
+        // Grade de pixels de uma projeção: zoom e fração de pixel da origem do mundo na tela.
+        struct Grid {
+            float zoom = 1.0f;
+            Vector2 phase; // [0, 1), quantizada em 1/64 de pixel
+            bool operator==(const Grid&) const = default;
+        };
+
+        struct Tile {
+            Image image;
+            Rect2 area; // mundo
+            Grid grid;
+            std::uint64_t lastUsed = 0; // quadro
+            bool isValid = false; // a imagem corresponde aos itens estáticos atuais
+        };
+
+        /* Grade de `world_to_screen` (só escala uniforme e translação, como a da câmera). */
+        static Grid gridOf(const Transform2D& world_to_screen);
+        /* Área de mundo do bloco (x, y); y cresce para baixo, como na tela. */
+        static Rect2 tileArea(const Grid& grid, std::int32_t x, std::int32_t y);
+        /* Mundo -> pixels do bloco (x, y). */
+        static Transform2D tileView(const Grid& grid, std::int32_t x, std::int32_t y);
+        /* Blocos que cobrem a área. */
+        static void tileRange(const Grid& grid, const Rect2& area, std::int32_t& x0, std::int32_t& y0, std::int32_t& x1, std::int32_t& y1);
+
+        /** Bloco (grade, x, y), criado inválido se ainda não existir.
+         * Ao passar de MAX_TILES, descarta os blocos menos usados (e as texturas deles em `backend`).
+         */
+        Tile& acquire(const Grid& grid, std::int32_t x, std::int32_t y, std::uint64_t frame, RenderBackend& backend);
+
+        /* Invalida os blocos (de todos os zooms) que tocam a área, crescida de `margin_pixels` no zoom de cada um. */
+        void invalidate(const Rect2& world_area, float margin_pixels);
+        /* Descarta todos os blocos e as texturas deles em `backend`. */
+        void clear(RenderBackend& backend);
+
+        inline std::size_t size() const {
+            return tiles.size();
+        }
+
+    private:
+        struct Key {
+            Grid grid;
+            std::int32_t x, y;
+            bool operator==(const Key&) const = default;
+        };
+        struct KeyHash {
+            std::size_t operator()(const Key& key) const;
+        };
+
+        std::unordered_map<Key, Tile, KeyHash> tiles;
+    };
+
+} // namespace cg
@@ -1,20 +1,17 @@
-﻿#include <string>
-#include <sstream>
-
-#include "tool_box.hpp"
+﻿#include "tool_box.hpp"
 
 #include "canvas.hpp"
 
 #include "canvas_itens/point.hpp"
 #include "canvas_itens/line.hpp"
 #include "canvas_itens/polygon.hpp"
+#include "canvas_itens/text.hpp"
 
 #include "tools/point_tool.hpp"
 #include "tools/line_tool.hpp"
 #include "tools/polygon_tool.hpp"
 #include "tools/select_tool.hpp" 
 
-#include <facade/gui.hpp>
 #include "tools/gizmo.hpp"
 
 
@@ -50,217 +47,40 @@ namespace cg {
 		guideLines[1] = new GuideLine(Vector2::right(), canvas->getWindowSize() / 2.0f);
 	}
 
-	static unsigned tool_cursor = GLUT_CURSOR_INHERIT;
-	static unsigned last_cursor = GLUT_CURSOR_INHERIT;
-
-	static inline bool is_scalar_inside_bounds(Vector2 scale, Vector2 increment) {
-		return !(increment < Vector2::zero() && scale < Vector2(1e-3f) + increment ||
-			increment > Vector2::zero() && scale > Vector2(16.0f) - increment);
-	}
-
 	void ToolBox::_render()
 	{
-		constexpr float window_margin = 15.0f;
-		// Cada janela deve ser criada num escopo separado para
-		// invocar os construtores/ destrutores necessários
-		{
-			Window settings("Settings", {window_margin, window_margin});
-
-			static bool showGuideLines = true;
-			if (settings.showCheckBox(&showGuideLines, "Show Guide Lines")) {}
-			if (showGuideLines)
-				for (auto* guide : guideLines)
-					guide->_render();
-
-			settings.showText("Application average %.3f ms/frame (%.1f FPS)", 1000.0f / Gui::getFps(), Gui::getFps());
-		}
-
-		enum { NONE, SAVE, LOAD } clicked = NONE;
-		{  // ToolBox Window
-			static int counter = 0;
-			static float f = 0.0f;
-
-			constexpr float estimate_x = 123.0f;
-			Window toolBox("ToolBox", { canvas->getWindowSize().x - estimate_x - window_margin, window_margin });
-			// TODO -> Use Icon buttons for each tool
-
-			// toolBox.showCheckBox(&check, "Active
-
-			// glut cursor
-			unsigned current_cursor = GLUT_CURSOR_INHERIT;
-
-			int _currentTool = currentTool;
-			if (toolBox.showRadioButton(&_currentTool, Tools::POINT, "Point [F1]")) {
-				tool_cursor = GLUT_CURSOR_NONE;
-			} // use point
-			if (toolBox.showRadioButton(&_currentTool, Tools::LINE, "Line [F2]")) {
-				tool_cursor = GLUT_CURSOR_CROSSHAIR;
-			} // use line
-			if (toolBox.showRadioButton(&_currentTool, Tools::POLYGON, "Polygon [F3]")) {
-				tool_cursor = GLUT_CURSOR_CROSSHAIR;
-			} // use polygon
-			if (toolBox.showRadioButton(&_currentTool, Tools::SELECT, "Select [F4]")) {
-				tool_cursor = GLUT_CURSOR_INHERIT;
-			} // selection tool
-			if (_currentTool != currentTool) {
-				currentTool = _currentTool;
-				// Do something on tool change
-			}
-
-			if (!isInsideGui)
-				current_cursor = tool_cursor;
-
-			if (current_cursor != last_cursor) {
-				glutSetCursor(current_cursor);
-				last_cursor = current_cursor;
-			}
-
-			// TODO [Extra] -> Polígono regular
-			// switch (canvas.toolBox._currentTool) {
-			// case cg::ToolBox::Primitives::REGULAR_POLYGON: {
-			//     toolBox.sameLine();
-			//     toolBox.showSliderInt(&canvas.toolBox.polygonEdges, 1, 255, "Edges");
-			//     toolBox.sameLine();
-			//     toolBox.showText("[%d]", canvas.toolBox.polygonEdges);
-			// } break;
-			// default: break;
-			// }
-		}
-
-		{ // Controls Window
-			constexpr Vector2 estimate_size = {414.0f, 192.0f};
-			Window controls("Controls", {canvas->getWindowSize().x - estimate_size.x - window_margin , canvas->getWindowSize().y - estimate_size.y - window_margin});
-
-			controls.show2ColorEdit(getColorPtr(), &secondaryColor, "[x: toggle]");
-
-			// Update translation
-			{
-				Vector2 translation = tools[Tools::SELECT]->getPosition();
-				cg::Vector2 increment = controls.showIncrementalSliderVector2(
-					&translation,
-					canvas->getUpperLeft(),
-					canvas->getBottomRight(),
-					1.0f,
-					"X", "<", ">",
-					"Y", "V", "^"
-				);
-
-				if (increment) {
-					tools[Tools::SELECT]->translate(increment);
-				}
-				else {
-					if (translation != tools[Tools::SELECT]->getPosition())
-						tools[Tools::SELECT]->setPosition(translation);
-				}
-				//controls.showSliderVector2(&translation, canvas->getUpperLeft(), canvas->getBottomRight(), "X", "Y");
-
-			}
-			// Update rotation
-			{
-				float rotation_deg = rad_to_deg(tools[Tools::SELECT]->getRotation()); // degrees
-				int increment_unit = controls.showIncrementalFloatSlider(
-					&rotation_deg, -180.0f, 180.0f, 1.0f,
-					"Rotation", "-1 deg", "+1 deg", "[", "]");
-
-				if (increment_unit) // Apply negative / positive rotation
-					tools[Tools::SELECT]->rotate(deg_to_rad((float)increment_unit));
-				else {
-					float rotation_rad = deg_to_rad(rotation_deg); // radians
-					if (fabsf(rotation_rad - tools[Tools::SELECT]->getRotation()) > ZERO_PRECISION_ERROR)
-						tools[Tools::SELECT]->setRotation(rotation_rad);
-				}
-			}
-			// Update scale
-			{
-				Vector2 scale = tools[Tools::SELECT]->getScale();
-				Vector2 increment = controls.showIncrementalSliderVector2(&scale, 1e-3f, 16.0f, .1f,
-					"Sx", "*.9x", "*1.1x", "Sy [Shift]", "*.9y", "*1.1y");
-				//controls.showSliderVector2(&scale, 1e-3f, 16.0f, "Sx", "Sy");
-
-				if (increment) {
-					if (is_scalar_inside_bounds(tools[Tools::SELECT]->getScale(), increment))
-						tools[Tools::SELECT]->scale(Vector2::one() + increment);
-				}
-				else if ((scale - tools[Tools::SELECT]->getScale()).abs() > Vector2(ZERO_PRECISION_ERROR))
-					tools[Tools::SELECT]->setScale(scale);
-			}
-			// Reflexão
-			{
-				if (controls.showButton("Mirror X"))
-					tools[Tools::SELECT]->mirrorX();
-				controls.sameLine();
-				controls.showText("[\\]");
-				controls.sameLine();
-				if (controls.showButton("Mirror Y"))
-					tools[Tools::SELECT]->mirrorY();
-				controls.sameLine();
-				controls.showText("[/]");
-				controls.sameLine();
-				if (controls.showButton("Mirror Origin"))
-					tools[Tools::SELECT]->mirrorOrigin();
-				controls.sameLine();
-				controls.showText("[']");
-			}
-			// Cisalhamento
-			{
-				if (controls.showButton("ShX+"))
-					tools[Tools::SELECT]->shearH(1.0f);
-				controls.sameLine();
-				controls.showText("[<]");
-				controls.sameLine();
-				if (controls.showButton("ShX-"))
-					tools[Tools::SELECT]->shearH(-1.0f);
-				controls.sameLine();
-				controls.showText("[>]");
-				controls.sameLine();
-				if (controls.showButton("ShY+"))
-					tools[Tools::SELECT]->shearV(1.0f);
-				controls.sameLine();
-				controls.showText("[^]");
-				controls.sameLine();
-				if (controls.showButton("ShY-"))
-					tools[Tools::SELECT]->shearV(-1.0f);
-				controls.sameLine();
-				controls.showText("[v]");
-				controls.sameLine();
-				controls.showText("Shear [Ctrl]");
-			}
-
-			// Save / Load / Clear / Delete
-			{
-				if (controls.showButton("Save to file"))
-					clicked = SAVE;
-				controls.sameLine();
-				if (controls.showButton("Load from file"))
-					clicked = LOAD;
-				controls.sameLine();
-				if (controls.showButton("Clear screen"))
-					clearScreen();
-				if (((SelectTool *)tools[Tools::SELECT])->hasSelection()) {
-					controls.sameLine();
-					if (controls.showButton("Delete"))
-						((SelectTool *)tools[Tools::SELECT])->deleteSelected();
-					controls.sameLine();
-					controls.showText("[del]");
-				}
-			}
+		if (showGuideLines)
+			for (auto* guide : guideLines)
+				guide->_render();
+
+		if (frontend)
+			frontend->render(*this);
+
+		// Cursor da ferramenta, exceto sobre a interface
+		Cursor current_cursor = isInsideGui ? Cursor::INHERIT : toolCursor;
+		if (current_cursor != lastCursor) {
+			RenderBackend::current().setCursor(current_cursor);
+			lastCursor = current_cursor;
 		}
 
-		switch (clicked) {
-		case SAVE: {
-			save();
-		} break;
-		case LOAD: {
-			load();
-		} break;
-		default:
-			break;
-		}
 		if (currentTool >= N_PRIMITIVES)
 			return;
 		tools[currentTool]->_render();
 	}
 
+	void ToolBox::setCurrentTool(int tool)
+	{
+		assert_err(tool >= 0 && tool < (int)N_PRIMITIVES, "Invalid tool.");
+		static constexpr Cursor tool_cursors[N_PRIMITIVES] = {
+			Cursor::NONE, // POINT
+			Cursor::CROSSHAIR, // LINE
+			Cursor::CROSSHAIR, // POLYGON
+			Cursor::INHERIT, // SELECT
+		};
+		currentTool = tool;
+		toolCursor = tool_cursors[tool];
+	}
+
 	void ToolBox::_reshape(Canvas& canvas)
 	{
 		for (auto* guides : guideLines)
@@ -310,46 +130,47 @@ namespace cg {
 
 	void ToolBox::captureInput(io::SpecialKeyInputEvent input_event)
 	{
-		if (Gui::isDialogOpen())
+		if (frontend && frontend->isDialogOpen())
 			return;
+		const bool isUsingKeyboard = frontend && frontend->isUsingKeyboard();
 
 		switch (input_event.mods) {
-		case GLUT_ACTIVE_SHIFT:
-			if (!Gui::isUsingKeyboardInput()) {
+		case io::mods::SHIFT:
+			if (!isUsingKeyboard) {
 				switch (input_event.key) {
-				case GLUT_KEY_RIGHT: {
-					if (is_scalar_inside_bounds(tools[Tools::SELECT]->getScale(), Vector2::right()))
+				case io::keys::RIGHT: {
+					if (isScaleInsideBounds(tools[Tools::SELECT]->getScale(), Vector2::right()))
 						tools[Tools::SELECT]->scale(Vector2::one() + Vector2::right() * .1f);
 				} break;
-				case GLUT_KEY_LEFT: {
-					if (is_scalar_inside_bounds(tools[Tools::SELECT]->getScale(), Vector2::left()))
+				case io::keys::LEFT: {
+					if (isScaleInsideBounds(tools[Tools::SELECT]->getScale(), Vector2::left()))
 						tools[Tools::SELECT]->scale(Vector2::one() + Vector2::left() * .1f);
 				} break;
-				case GLUT_KEY_UP: {
-					if (is_scalar_inside_bounds(tools[Tools::SELECT]->getScale(), Vector2::up()))
+				case io::keys::UP: {
+					if (isScaleInsideBounds(tools[Tools::SELECT]->getScale(), Vector2::up()))
 						tools[Tools::SELECT]->scale(Vector2::one() + Vector2::up() * .1f);
 				} break;
-				case GLUT_KEY_DOWN: {
-					if (is_scalar_inside_bounds(tools[Tools::SELECT]->getScale(), Vector2::down()))
+				case io::keys::DOWN: {
+					if (isScaleInsideBounds(tools[Tools::SELECT]->getScale(), Vector2::down()))
 						tools[Tools::SELECT]->scale(Vector2::one() + Vector2::down() * .1f);
 				} break;
 				default:
 					break;
 				}
 			} break;
-		case GLUT_ACTIVE_CTRL:
-			if (!Gui::isUsingKeyboardInput()) {
+		case io::mods::CTRL:
+			if (!isUsingKeyboard) {
 				switch (input_event.key) {
-				case GLUT_KEY_RIGHT:
+				case io::keys::RIGHT:
 					tools[Tools::SELECT]->shearH(1.0f);
 					break;
-				case GLUT_KEY_LEFT:
+				case io::keys::LEFT:
 					tools[Tools::SELECT]->shearH(-1.0f);
 					break;
-				case GLUT_KEY_UP:
+				case io::keys::UP:
 					tools[Tools::SELECT]->shearV(1.0f);
 					break;
-				case GLUT_KEY_DOWN:
+				case io::keys::DOWN:
 					tools[Tools::SELECT]->shearV(-1.0f);
 					break;
 				default:
@@ -358,38 +179,34 @@ namespace cg {
 			}
 		default:
 			switch (input_event.key) {
-			case GLUT_KEY_F1: {
-				tool_cursor = GLUT_CURSOR_NONE;
-				currentTool = Tools::POINT;
-			} break;
-			case GLUT_KEY_F2: {
-				tool_cursor = GLUT_CURSOR_CROSSHAIR;
-				currentTool = Tools::LINE;
-			} break;
-			case GLUT_KEY_F3: {
-				tool_cursor = GLUT_CURSOR_CROSSHAIR;
-				currentTool = Tools::POLYGON;
-			} break;
-			case GLUT_KEY_F4: {
-				tool_cursor = GLUT_CURSOR_INHERIT;
-				currentTool = Tools::SELECT;
-			} break;
-			case GLUT_KEY_DELETE:
+			case io::keys::F1:
+				setCurrentTool(Tools::POINT);
+				break;
+			case io::keys::F2:
+				setCurrentTool(Tools::LINE);
+				break;
+			case io::keys::F3:
+				setCurrentTool(Tools::POLYGON);
+				break;
+			case io::keys::F4:
+				setCurrentTool(Tools::SELECT);
+				break;
+			case io::keys::DEL:
 				((SelectTool *)tools[Tools::SELECT])->deleteSelected();
 				break;
 			default:
-				if (!Gui::isUsingKeyboardInput()) {
+				if (!isUsingKeyboard) {
 					switch (input_event.key) {
-					case GLUT_KEY_RIGHT:
+					case io::keys::RIGHT:
 						tools[Tools::SELECT]->translate(Vector2::right());
 						break;
-					case GLUT_KEY_LEFT:
+					case io::keys::LEFT:
 						tools[Tools::SELECT]->translate(Vector2::left());
 						break;
-					case GLUT_KEY_UP:
+					case io::keys::UP:
 						tools[Tools::SELECT]->translate(Vector2::up());
 						break;
-					case GLUT_KEY_DOWN:
+					case io::keys::DOWN:
 						tools[Tools::SELECT]->translate(Vector2::down());
 						break;
 					default:
@@ -402,7 +219,7 @@ namespace cg {
 
 	void ToolBox::captureInput(io::KeyboardInputEvent input_event)
 	{
-		if (Gui::isDialogOpen())
+		if (frontend && frontend->isDialogOpen())
 			return;
 
 		const unsigned char ESC = 27;
@@ -427,12 +244,13 @@ namespace cg {
 			Color tmp_color = *colorPtr;
 			*colorPtr = secondaryColor;
 			secondaryColor = tmp_color;
+			colorChanged();
 		} break;
 		default:
 			break;
 		}
 
-		if (input_event.mods & GLUT_ACTIVE_CTRL) {
+		if (input_event.mods & io::mods::CTRL) {
 			switch (input_event.key) {
 			case 's':
 				save();
@@ -463,59 +281,20 @@ namespace cg {
 
 	void ToolBox::save()
 	{
-		Gui::saveFileDialog("SaveFile", "Salvando arquivo...", ".tcgp,.cgp", [&](std::ofstream& ofs) {
-			for (auto& item : canvas->getItens())
-				ofs << *item << '\n';
-		});
+		if (frontend)
+			frontend->save(*this);
 	}
 
 	void ToolBox::load()
 	{
-		Gui::openFileDialog("OpenFile", "Escolha um arquivo...", ".tcgp,.cgp", [&](std::ifstream& ifs) {
-			if (ifs.eof()) {
-				print_warning("File is empty or not found.");
-				return;
-			}
-
-			canvas->clear(); // Clear the canvas before loading new items
+		if (frontend)
+			frontend->load(*this);
+	}
 
-			while (!ifs.eof()) {
-				std::string word = peek_word(ifs);
-				if (word == "Point") {
-					Point point;
-					if (!(ifs >> point)) {
-						print_error("Failed to deserialize point.");
-						canvas->clear();
-						return;
-					}
-					canvas->insert(std::make_unique<Point>(point));
-				}
-				else if (word == "Line") {
-					Line line;
-					if (!(ifs >> line)) {
-						print_error("Failed to deserialize line.");
-						canvas->clear();
-						return;
-					}
-					canvas->insert(std::make_unique<Line>(line));
-				}
-				else if (word == "Polygon") {
-					Polygon polygon;
-					if (!(ifs >> polygon)) {
-						print_error("Failed to deserialize polygon.");
-						canvas->clear();
-						return;
-					}
-					canvas->insert(std::make_unique<Polygon>(polygon));
-				}
-				else if (word.empty()) {
-					break;
-				}
-				else {
-					print_warning("Invalid file format. Expected 'Point', 'Line' or 'Polygon' but got '%s', continuing...", word.c_str());
-				}
-			}
-		});
+	void ToolBox::colorChanged()
+	{
+		if (colorOwner)
+			canvas->invalidate(colorOwner);
 	}
 
 	void ToolBox::clearScreen()
@@ -524,4 +303,12 @@ namespace cg {
 		canvas->clear();
 	}
 
+	void ToolBox::addText(const std::string& text)
+	{
+		if (text.empty())
+			return;
+		Vector2 center = canvas->screenToWorld(canvas->getWindowSize() / 2.0f);
+		canvas->insert(std::make_unique<Text>(center, text, getColor()));
+	}
+
 } // namespace cg
@@ -1,14 +1,17 @@
 ﻿#pragma once
 
 #include <array>
+#include <string>
 
 #include "math.hpp"
 #include "input_event.hpp"
+#include "render_backend.hpp"
 
 
 namespace cg {
 	// Forward Declarations
 	class Canvas;
+	class CanvasItem;
 	class Painter;
 	class PointTool;
 	class LineTool;
@@ -16,11 +19,36 @@ namespace cg {
 
 	/** Gerencia as ferramentas atuais usadas no Canvas.
 	 * Simplesmente delega os eventos de entrada para a ferramenta atual.
+	 * Os painéis e diálogos de arquivo ficam na interface da aplicação (`Frontend`), fora do núcleo.
 	 */
 	class ToolBox {
 		friend class Tool;
 		// Altere aqui o tamanho do array para adicionar mais ferramentas.
 		static constexpr std::size_t N_PRIMITIVES = 4;
+	public:
+		enum Tools {
+			POINT = 0,
+			LINE = 1,
+			POLYGON = 2,
+			SELECT = 3,
+		};
+
+		/* Interface gráfica da caixa de ferramentas (implementada pela aplicação). */
+		class Frontend {
+		public:
+			virtual ~Frontend() = default;
+
+			// Desenha os painéis da caixa de ferramentas.
+			virtual void render(ToolBox& tool_box) = 0;
+			// A interface está usando o teclado (ex.: editando um campo de texto).
+			virtual bool isUsingKeyboard() const = 0;
+			// Há um diálogo modal aberto, a entrada não deve chegar às ferramentas.
+			virtual bool isDialogOpen() const = 0;
+
+			virtual void save(ToolBox& tool_box) = 0;
+			virtual void load(ToolBox& tool_box) = 0;
+		};
+
 	public:
 		ToolBox();
 		~ToolBox();
@@ -45,9 +73,10 @@ namespace cg {
 		void captureInput(io::FocusIn _input_event);
 		void captureInput(io::FocusOut _input_event);
 
-		void save();
+		void save(); // delega ao frontend (diálogo de arquivo)
 		void load();
 		void clearScreen();
+		void addText(const std::string& text); // no centro da vista, com a cor atual
 
 		inline Color getColor() const {
 			return *colorPtr;
@@ -55,37 +84,57 @@ namespace cg {
 		inline Color* getColorPtr() {
 			return colorPtr;
 		}
-		inline void bindColorPtr(Color* to) {
+		/* @param owner Item dono da cor (redesenhado pelos caches do Canvas quando ela muda) */
+		inline void bindColorPtr(Color* to, CanvasItem* owner = nullptr) {
 			assert_err(to != nullptr, "Must not bind to a nullptr");
 			colorPtr = to;
+			colorOwner = owner;
 		}
 		inline void unbindColorPtr() {
 			//warn(colorPtr == &currentColor, "color was not bind before");
 			currentColor = *colorPtr;
 			colorPtr = &currentColor;
+			colorOwner = nullptr;
+		}
+		/* Chame após editar a cor por `getColorPtr` (a GUI escreve direto nela). */
+		void colorChanged();
+
+		inline Color* getSecondaryColorPtr() {
+			return &secondaryColor;
 		}
 
 		inline SelectTool& getSelectorTool() {
 			return *(SelectTool *)tools[Tools::SELECT];
 		}
 
+		inline int getCurrentTool() const {
+			return currentTool;
+		}
+		void setCurrentTool(int tool);
+
+		// Limites da escala aplicada pelos controles incrementais.
+		static inline bool isScaleInsideBounds(Vector2 scale, Vector2 increment) {
+			return !(increment < Vector2::zero() && scale < Vector2(1e-3f) + increment ||
+				increment > Vector2::zero() && scale > Vector2(16.0f) - increment);
+		}
+
 	public:
 		Canvas* canvas = nullptr;
+		Frontend* frontend = nullptr; // sem frontend: nenhum painel, teclado livre e sem diálogos
 		bool isInsideGui = false;
-    private:
-		enum Tools {
-			POINT = 0,
-			LINE = 1,
-			POLYGON = 2,
-			SELECT = 3,
-		};
+		bool showGuideLines = true;
+		bool outlinePolygons = false; // novos polígonos com contorno na cor secundária
 	private:
 		int currentTool = POINT;
 		std::array<Painter *, N_PRIMITIVES> tools;
 
+		Cursor toolCursor = Cursor::INHERIT;
+		Cursor lastCursor = Cursor::INHERIT;
+
 		Color currentColor = cg::colors::WHITE;
 		Color secondaryColor = cg::colors::BLACK;
 		Color *colorPtr = &currentColor; // Define a cor atual para pintura.
+		CanvasItem *colorOwner = nullptr; // item de `colorPtr`, se houver
 	};
 
 }
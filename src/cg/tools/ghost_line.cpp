@@ -2,6 +2,7 @@
 
 #include <cg/canvas.hpp>
 #include <cg/math.hpp>
+#include <cg/render_backend.hpp>
 
 
 namespace cg {
@@ -25,44 +26,17 @@ namespace cg {
         if (from == to)
             return;
 
-        GLdebug() {
-            const float SEGMENT_LENGTH = DASH_LENGTH + GAP_LENGTH;
+        float screenDistance = from.distance(to);
+        if (screenDistance < 1e-5f)
+            return; // avoid low precision issues
 
-            float screenDistance = from.distance(to);
-            if (screenDistance < 1e-5f)
-                return; // avoid low precision issues
+        // Padrão em pixels, constante na tela: só as pontas dos traços são calculadas
+        RenderBackend& backend = RenderBackend::current();
+        const float pixel = 1.0f / backend.getPixelsPerUnit();
+        const Vector2 line[2] = { from, to };
+        dashSegments(line, DashPattern{ DASH_LENGTH * pixel, GAP_LENGTH * pixel }, segments);
 
-            Vec2Interpolator interpolator(from, to, DASH_LENGTH);
-
-            glBegin(GL_LINES);
-            glColor4f(color.r, color.g, color.b, color.a);
-
-            bool drawSegment = true;
-            Vector2 prev = from;
-            int segmentCount = 0;
-
-            for (Vector2 current : interpolator) {
-
-                // Alterna entre tra�o e espa�o a cada DASH_LENGTH
-                if (drawSegment) {
-                    Vector2 ndcPrev = prev;
-                    Vector2 ndcCurrent = current;
-
-                    glVertex2f(ndcPrev.x, ndcPrev.y);
-                    glVertex2f(ndcCurrent.x, ndcCurrent.y);
-                }
-
-                // A cada DASH_LENGTH percorrida, alterna o estado
-                segmentCount++;
-                if (segmentCount % 2 == 0) {
-                    drawSegment = !drawSegment;
-                }
-
-                prev = current;
-            }
-
-            glEnd();
-        }
+        backend.draw(Primitive::LINES, segments, color);
 	}
 
 }
\ No newline at end of file
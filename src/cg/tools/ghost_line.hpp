@@ -1,5 +1,6 @@
 ﻿#pragma once
 
+#include <vector>
 #include <functional>
 #include <cg/math.hpp>
 #include <cg/geometry.hpp>
@@ -23,8 +24,9 @@ namespace cg {
 	private:
 		Canvas* canvas;
 		static constexpr Color DEFAULT_COLOR = { 0.15f, 0.35f, .75f, 0.66f }; // Azul claro semi-transparente
-		static constexpr float DASH_LENGTH = 2.5f; // Comprimento do tracejado em pixels
-		static constexpr float GAP_LENGTH = 1.0f;  // Comprimento do espaçamento em pixels
+		static constexpr float DASH_LENGTH = 5.0f; // Comprimento do tracejado em pixels
+		static constexpr float GAP_LENGTH = 5.0f;  // Comprimento do espaçamento em pixels
+		std::vector<Vector2> segments; // pontas dos traços (reaproveitado entre quadros)
 	};
 
 }
\ No newline at end of file
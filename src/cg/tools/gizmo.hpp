@@ -50,8 +50,11 @@ public:
         noSerialize();
     }
     void _reshape(Canvas& canvas) override {
-        auto [x, y] = canvas.getWindowSize();
+        // Cobre a área visível da câmera, sempre passando pela origem do mundo
+        Rect2 visible = canvas.getCamera().getVisibleRect();
+        auto [x, y] = visible.getSize();
         model = Transform2D(x, 0, 0, y);
+        model.setOrigin(direction * direction.dot(visible.getCenter()));
     }
 private:
     Vector2 direction;
@@ -46,7 +46,7 @@ namespace cg {
 			line = new Line(mouse_event.position, toolBox.getColor());
 			appendToCanvas(line);
 
-			toolBox.bindColorPtr(&line->getColor());
+			toolBox.bindColorPtr(&line->getColor(), line);
 			toolBox.getSelectorTool().select(line); // auto select the new line
 			enableDraw();
 		}
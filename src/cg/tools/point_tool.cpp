@@ -4,6 +4,7 @@
 
 #include "select_tool.hpp"
 #include <cg/canvas_itens/point.hpp>
+#include <cg/render_backend.hpp>
 
 
 namespace cg {
@@ -16,25 +17,11 @@ namespace cg {
         if (toolBox.isInsideGui || isDrawing())
             return;
 
-        auto [x, y] = model * Vector2{};
-        GLdebug() {
-            glPointSize(Point::SIZE + 1.0f);
-            glColor3ub(255, 255, 255);
-        }
-        GLdebug() {
-        glBegin(GL_POINTS);
-            glVertex2f(x, y);
-        glEnd();
-        }
-        GLdebug() {
-            glPointSize(Point::SIZE);
-            glColor3ub(0, 0, 0);
-        }
-        GLdebug() {
-        glBegin(GL_POINTS);
-            glVertex2f(x, y);
-        glEnd();
-        }
+        // Contorno branco sob o ponto preto, para ser visível sobre qualquer cor.
+        static constexpr Vector2 ORIGIN{};
+        RenderBackend& backend = RenderBackend::current();
+        backend.drawPointSprites({ &ORIGIN, 1 }, model, Color{ 1.0f, 1.0f, 1.0f }, Point::SIZE + 2.0f);
+        backend.drawPointSprites({ &ORIGIN, 1 }, model, Color{ 0.0f, 0.0f, 0.0f }, Point::SIZE);
     }
 
     void PointTool::_input(io::MouseMove mouse_event)
@@ -55,7 +42,7 @@ namespace cg {
     {
         // New point primitive
         point = new Point(mouse_event.position, toolBox.getColor());
-        toolBox.bindColorPtr(&point->getColor());
+        toolBox.bindColorPtr(&point->getColor(), point);
         appendToCanvas(point);
 
 		toolBox.getSelectorTool().select(point);
@@ -51,9 +51,13 @@ namespace cg {
         else {
             // new Polygon primitive
             polygon = new Polygon(mouse_event.position, toolBox.getColor());
+            if (toolBox.outlinePolygons) {
+                polygon->setContourColor(*toolBox.getSecondaryColorPtr());
+                polygon->setContoured(true);
+            }
             appendToCanvas(polygon); // add to canvas even if just one vertice (shown as a point)
 
-            toolBox.bindColorPtr(&polygon->getColor());
+            toolBox.bindColorPtr(&polygon->getColor(), polygon);
 
             setPosition(mouse_event.position); // update position to the first vertice
             toolBox.getSelectorTool().select(polygon); // auto select the new polygon
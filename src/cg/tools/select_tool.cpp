@@ -1,6 +1,8 @@
 #include <cg/canvas_itens/point.hpp>
 #include <cg/canvas_itens/line.hpp>
 #include <cg/canvas_itens/polygon.hpp>
+#include <cg/canvas_itens/text.hpp>
+#include <cg/render_backend.hpp>
 
 #include "select_tool.hpp"
 
@@ -9,9 +11,9 @@ namespace cg {
 
     void SelectTool::_input(io::MouseMove mouse_event) {
         if (auto* item = toolBox.canvas->pick(mouse_event.position); item != nullptr)
-            glutSetCursor(GLUT_CURSOR_INFO);
+            RenderBackend::current().setCursor(Cursor::INFO);
         else
-            glutSetCursor(GLUT_CURSOR_INHERIT);
+            RenderBackend::current().setCursor(Cursor::INHERIT);
     }
 
     void SelectTool::select(CanvasItem *item) {
@@ -24,13 +26,16 @@ namespace cg {
 
         switch (item->typeInfo) {
             case CanvasItem::TypeInfo::POINT:
-                toolBox.bindColorPtr(&((Point *)(item))->getColor());
+                toolBox.bindColorPtr(&((Point *)(item))->getColor(), item);
                 break;
             case CanvasItem::TypeInfo::LINE:
-                toolBox.bindColorPtr(&((Line *)(item))->getColor());
+                toolBox.bindColorPtr(&((Line *)(item))->getColor(), item);
                 break;
             case CanvasItem::TypeInfo::POLYGON:
-                toolBox.bindColorPtr(&((Polygon *)(item))->getColor());
+                toolBox.bindColorPtr(&((Polygon *)(item))->getColor(), item);
+                break;
+            case CanvasItem::TypeInfo::TEXT:
+                toolBox.bindColorPtr(&((Text *)(item))->getColor(), item);
                 break;
             default:
                 break;
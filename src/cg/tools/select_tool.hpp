@@ -71,6 +71,10 @@ namespace cg {
             return selectedItem != nullptr;
         }
 
+        inline CanvasItem* getSelected() const {
+            return selectedItem;
+        }
+
         inline void setPosition(const Vector2& position) override {
 			translateSelected(position - getPosition()); // delta △translation
 			Tool::setPosition(position);
@@ -0,0 +1,307 @@
+#include "gl_backend.hpp"
+
+#include <api.hpp>
+#include <cg/input_event.hpp>
+
+#include <algorithm>
+
+#ifndef GL_POINT_SPRITE // OpenGL 2.0 (ausente do gl.h 1.1 do Windows)
+#define GL_POINT_SPRITE 0x8861
+#define GL_COORD_REPLACE 0x8862
+#endif
+
+
+namespace cg {
+
+	// As constantes de tecla do núcleo espelham as do GLUT (ver io::keys).
+	static_assert(io::keys::F1 == GLUT_KEY_F1 && io::keys::F4 == GLUT_KEY_F4);
+	static_assert(io::keys::LEFT == GLUT_KEY_LEFT && io::keys::UP == GLUT_KEY_UP);
+	static_assert(io::keys::RIGHT == GLUT_KEY_RIGHT && io::keys::DOWN == GLUT_KEY_DOWN);
+	static_assert(io::keys::DEL == GLUT_KEY_DELETE);
+	static_assert(io::mods::SHIFT == GLUT_ACTIVE_SHIFT && io::mods::CTRL == GLUT_ACTIVE_CTRL && io::mods::ALT == GLUT_ACTIVE_ALT);
+
+	static inline GLubyte to_unorm8(float channel)
+	{
+		return (GLubyte)(std::clamp(channel, 0.0f, 1.0f) * 255.0f + 0.5f);
+	}
+
+	void GLBackend::draw(Primitive primitive, std::span<const Vector2> vertices,
+		const Transform2D& model, Color color, float size)
+	{
+		if (vertices.empty())
+			return;
+
+		// Faixas e leques viram primitivas separadas, para lotes de várias chamadas não se ligarem
+		const std::size_t n = vertices.size();
+		switch (primitive) {
+		case Primitive::POINTS:
+			beginBatch(GL_POINTS, nullptr, size);
+			break;
+		case Primitive::LINES:
+			beginBatch(GL_LINES, nullptr, size);
+			vertices = vertices.first(n / 2 * 2);
+			break;
+		case Primitive::LINE_STRIP:
+		case Primitive::LINE_LOOP:
+			beginBatch(GL_LINES, nullptr, size);
+			expanded.clear();
+			for (std::size_t i = 1; i < n; ++i)
+				expanded.insert(expanded.end(), { vertices[i - 1], vertices[i] });
+			if (primitive == Primitive::LINE_LOOP && n > 2)
+				expanded.insert(expanded.end(), { vertices[n - 1], vertices[0] });
+			vertices = expanded;
+			break;
+		case Primitive::TRIANGLES:
+			beginBatch(GL_TRIANGLES, nullptr, 0.0f);
+			vertices = vertices.first(n / 3 * 3);
+			break;
+		case Primitive::TRIANGLE_STRIP:
+		case Primitive::TRIANGLE_FAN:
+			beginBatch(GL_TRIANGLES, nullptr, 0.0f);
+			expanded.clear();
+			for (std::size_t i = 2; i < n; ++i) {
+				const Vector2 first = primitive == Primitive::TRIANGLE_FAN ? vertices[0] : vertices[i - 2];
+				expanded.insert(expanded.end(), { first, vertices[i - 1], vertices[i] });
+			}
+			vertices = expanded;
+			break;
+		}
+		appendBatch(vertices, {}, model, color);
+	}
+
+	GLBackend::Texture& GLBackend::bindTexture(const Image& image, bool& created)
+	{
+		auto [found, inserted] = textures.try_emplace(image.id);
+		Texture& texture = found->second;
+		if (inserted) {
+			GLdebug() {
+				const GLint filter = image.isSmooth ? GL_LINEAR : GL_NEAREST;
+				glGenTextures(1, &texture.name);
+				glBindTexture(GL_TEXTURE_2D, texture.name);
+				glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, filter);
+				glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, filter);
+				glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP);
+				glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP);
+			}
+		}
+		else {
+			GLdebug() {
+				glBindTexture(GL_TEXTURE_2D, texture.name);
+			}
+		}
+
+		created = texture.width != image.width || texture.height != image.height;
+		if (created) {
+			texture.width = image.width;
+			texture.height = image.height;
+			GLdebug() {
+				glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, image.width, image.height, 0,
+					GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+			}
+		}
+		return texture;
+	}
+
+	GLBackend::Texture& GLBackend::uploadTexture(const Image& image)
+	{
+		bool created;
+		Texture& texture = bindTexture(image, created);
+		if ((created || texture.revision != image.revision) && !image.pixels.empty()) {
+			texture.revision = image.revision;
+			texture.isFlipped = false;
+			GLdebug() {
+				glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+				glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, image.width, image.height,
+					GL_RGBA, GL_UNSIGNED_BYTE, image.pixels.data());
+			}
+		}
+		return texture;
+	}
+
+	void GLBackend::drawImage(const Image& image, const Rect2& world_area)
+	{
+		if (image.width <= 0 || image.height <= 0)
+			return;
+		flush();
+
+		Texture& texture = uploadTexture(image);
+
+		// Linha 0 da imagem no topo (y máximo do mundo); a cor branca não altera os texels
+		const float top = texture.isFlipped ? 1.0f : 0.0f, bottom = 1.0f - top;
+		GLdebug() {
+			glEnable(GL_TEXTURE_2D);
+			glTexEnvi(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_REPLACE);
+			glBegin(GL_QUADS);
+				glColor4f(1.0f, 1.0f, 1.0f, 1.0f);
+				glTexCoord2f(0.0f, top); glVertex2f(world_area.min.x, world_area.max.y);
+				glTexCoord2f(1.0f, top); glVertex2f(world_area.max.x, world_area.max.y);
+				glTexCoord2f(1.0f, bottom); glVertex2f(world_area.max.x, world_area.min.y);
+				glTexCoord2f(0.0f, bottom); glVertex2f(world_area.min.x, world_area.min.y);
+			glEnd();
+			glTexEnvi(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_MODULATE); // padrão do GL
+			glBindTexture(GL_TEXTURE_2D, 0);
+			glDisable(GL_TEXTURE_2D);
+		}
+	}
+
+	void GLBackend::drawMaskedTriangles(const Image& mask, std::span<const Vector2> vertices,
+		std::span<const Vector2> texcoords, const Transform2D& model, Color color)
+	{
+		if (vertices.empty() || mask.width <= 0 || mask.height <= 0)
+			return;
+		const std::size_t n = std::min(vertices.size(), texcoords.size()) / 3 * 3;
+		beginBatch(GL_TRIANGLES, &mask, 0.0f);
+		appendBatch(vertices.first(n), texcoords.first(n), model, color);
+	}
+
+	void GLBackend::drawPointSprites(std::span<const Vector2> points, const Transform2D& model, Color color, float size)
+	{
+		if (points.empty())
+			return;
+		beginBatch(GL_POINTS, &pointMask(), std::max(size, 1.0f));
+		appendBatch(points, {}, model, color);
+	}
+
+	void GLBackend::beginBatch(unsigned int mode, const Image* mask, float size)
+	{
+		if (mode != batchMode || mask != batchMask || size != batchSize)
+			flush();
+		batchMode = mode;
+		batchMask = mask;
+		batchSize = size;
+	}
+
+	void GLBackend::appendBatch(std::span<const Vector2> vertices, std::span<const Vector2> texcoords,
+		const Transform2D& model, Color color)
+	{
+		// O alpha da cor é ignorado, como nas demais primitivas (sem mistura fora da máscara)
+		const GLubyte rgba[4] = { to_unorm8(color.r), to_unorm8(color.g), to_unorm8(color.b), 255 };
+		// Gravações preparadas em paralelo já chegam no mundo (ver `Canvas::renderItems`)
+		const bool isWorld = model.columns[0] == Vector2{ 1.0f, 0.0f } && model.columns[1] == Vector2{ 0.0f, 1.0f } &&
+			model.columns[2] == Vector2{};
+		const std::size_t first = batch.size();
+		batch.resize(first + vertices.size());
+		BatchVertex* out = batch.data() + first;
+		for (std::size_t i = 0; i < vertices.size(); ++i) {
+			auto [x, y] = isWorld ? vertices[i] : model * vertices[i];
+			const Vector2 uv = texcoords.empty() ? Vector2{} : texcoords[i];
+			out[i] = { uv.x, uv.y, { rgba[0], rgba[1], rgba[2], rgba[3] }, x, y, 0.0f };
+		}
+	}
+
+	void GLBackend::flush()
+	{
+		static_assert(sizeof(BatchVertex) == 24, "layout de GL_T2F_C4UB_V3F");
+		if (batch.empty())
+			return;
+
+		if (batchMask)
+			uploadTexture(*batchMask);
+		const bool isSprites = batchMode == GL_POINTS && batchMask;
+		// Sem espaço livre no anel, os vertex arrays leem da CPU (o driver copia na chamada)
+		const std::ptrdiff_t offset = stream.upload(batch.data(), batch.size() * sizeof(BatchVertex));
+		const void* data = offset < 0 ? (const void*)batch.data() : (const void*)offset;
+		// Cor do vértice vezes o texel (branco com a cobertura no alpha), misturada ao destino.
+		GLdebug() {
+			if (batchMask) {
+				glEnable(GL_TEXTURE_2D);
+				glEnable(GL_BLEND);
+				glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+			}
+			if (isSprites) {
+				// Coordenadas de textura geradas sobre o quadrado do ponto: a borda vem do disco
+				glEnable(GL_POINT_SPRITE);
+				glTexEnvi(GL_POINT_SPRITE, GL_COORD_REPLACE, GL_TRUE);
+			}
+			if (batchMode == GL_POINTS)
+				glPointSize(batchSize);
+			else if (batchMode == GL_LINES)
+				glLineWidth(batchSize);
+			glInterleavedArrays(GL_T2F_C4UB_V3F, 0, data);
+			glDrawArrays(batchMode, 0, (GLsizei)batch.size());
+			glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+			glDisableClientState(GL_COLOR_ARRAY);
+			glDisableClientState(GL_VERTEX_ARRAY);
+			if (isSprites) {
+				glTexEnvi(GL_POINT_SPRITE, GL_COORD_REPLACE, GL_FALSE);
+				glDisable(GL_POINT_SPRITE);
+			}
+			if (batchMask) {
+				glDisable(GL_BLEND);
+				glBindTexture(GL_TEXTURE_2D, 0);
+				glDisable(GL_TEXTURE_2D);
+			}
+		}
+		if (offset >= 0)
+			stream.unbind();
+		batch.clear();
+		batchMode = 0;
+		batchMask = nullptr;
+		batchSize = 0.0f;
+	}
+
+	bool GLBackend::captureImage(Image& image)
+	{
+		if (viewportSize.x < 1.0f || viewportSize.y < 1.0f)
+			return false;
+		flush(); // a cópia inclui o lote pendente
+		image.width = (int)viewportSize.x;
+		image.height = (int)viewportSize.y;
+		image.pixels.clear(); // a cópia fica só na textura
+		++image.revision;
+
+		bool created;
+		Texture& texture = bindTexture(image, created);
+		texture.revision = image.revision;
+		texture.isFlipped = true;
+		GLdebug() {
+			glCopyTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, 0, 0, image.width, image.height);
+			glBindTexture(GL_TEXTURE_2D, 0);
+		}
+		return true;
+	}
+
+	void GLBackend::releaseImage(std::uint64_t image_id)
+	{
+		auto found = textures.find(image_id);
+		if (found == textures.end())
+			return;
+		flush(); // o lote pode usar a textura
+		GLdebug() {
+			glDeleteTextures(1, &found->second.name);
+		}
+		textures.erase(found);
+	}
+
+	void GLBackend::setProjection(const Transform2D& world_to_screen, Vector2 viewport_size)
+	{
+		flush();
+		stream.beginFrame(); // início do quadro: próxima região do anel
+		viewportSize = viewport_size;
+		// Pixels da janela -> NDC, seguido da câmera (mundo -> pixels)
+		const GLfloat view[16] = {
+			world_to_screen.get(0, 0), world_to_screen.get(0, 1), 0.0f, 0.0f,
+			world_to_screen.get(1, 0), world_to_screen.get(1, 1), 0.0f, 0.0f,
+			0.0f, 0.0f, 1.0f, 0.0f,
+			world_to_screen.get(2, 0), world_to_screen.get(2, 1), 0.0f, 1.0f,
+		};
+		GLdebug() {
+			glMatrixMode(GL_PROJECTION);
+			glLoadIdentity();
+			gluOrtho2D(0.0, viewport_size.x, viewport_size.y, 0.0);
+			glMultMatrixf(view);
+			glMatrixMode(GL_MODELVIEW);
+		}
+	}
+
+	void GLBackend::setCursor(Cursor cursor)
+	{
+		switch (cursor) {
+		case Cursor::NONE: glutSetCursor(GLUT_CURSOR_NONE); break;
+		case Cursor::CROSSHAIR: glutSetCursor(GLUT_CURSOR_CROSSHAIR); break;
+		case Cursor::INFO: glutSetCursor(GLUT_CURSOR_INFO); break;
+		default: glutSetCursor(GLUT_CURSOR_INHERIT); break;
+		}
+	}
+
+} // namespace cg
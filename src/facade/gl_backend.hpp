@@ -0,0 +1,71 @@
+#pragma once
+// Backend de desenho em OpenGL (pipeline fixo), usado pela aplicação.
+// Primitivas consecutivas do mesmo tipo (triângulos com a mesma máscara, linhas da mesma largura,
+// pontos do mesmo tamanho) são acumuladas num lote, em coordenadas do mundo, e enviadas numa única
+// chamada (vertex arrays) a partir do buffer em anel do quadro, até outro comando ou o `flush` do quadro.
+
+#include <cg/render_backend.hpp>
+
+#include "gl_stream_buffer.hpp"
+
+#include <vector>
+#include <unordered_map>
+
+
+namespace cg {
+
+    class GLBackend : public RenderBackend {
+    public:
+        void draw(Primitive primitive, std::span<const Vector2> vertices,
+            const Transform2D& model, Color color, float size) override;
+        using RenderBackend::draw;
+
+        // Texturas em cache por `Image::id`, reenviadas quando a revisão muda.
+        void drawImage(const Image& image, const Rect2& world_area) override;
+        void releaseImage(std::uint64_t image_id) override;
+        // Máscara em GL_MODULATE com mistura de alpha (texto e traços).
+        void drawMaskedTriangles(const Image& mask, std::span<const Vector2> vertices,
+            std::span<const Vector2> texcoords, const Transform2D& model, Color color) override;
+        // Point sprites (GL_COORD_REPLACE) texturizados com o disco: um vértice por ponto.
+        void drawPointSprites(std::span<const Vector2> points, const Transform2D& model, Color color, float size) override;
+        void flush() override;
+        // Copia o buffer de desenho atual para a textura da imagem (glCopyTexSubImage2D), sem ler de volta para a CPU.
+        bool captureImage(Image& image) override;
+
+        void setCursor(Cursor cursor) override;
+        void setProjection(const Transform2D& world_to_screen, Vector2 viewport_size) override;
+
+    private:
+        struct Texture {
+            unsigned int name = 0; // GLuint
+            std::uint32_t revision = 0;
+            int width = 0, height = 0;
+            bool isFlipped = false; // copiada do framebuffer: linha 0 embaixo
+        };
+        // Textura da imagem, ligada e com o tamanho dela (criada se preciso).
+        Texture& bindTexture(const Image& image, bool& created);
+        // Liga a textura e reenvia os pixels se a imagem mudou.
+        Texture& uploadTexture(const Image& image);
+
+        // Formato GL_T2F_C4UB_V3F de glInterleavedArrays
+        struct BatchVertex {
+            float u, v;
+            std::uint8_t color[4];
+            float x, y, z;
+        };
+        // Conclui o lote atual se ele for de outro modo (GLenum), máscara (`nullptr`: sem textura) ou tamanho.
+        void beginBatch(unsigned int mode, const Image* mask, float size);
+        void appendBatch(std::span<const Vector2> vertices, std::span<const Vector2> texcoords,
+            const Transform2D& model, Color color);
+
+        std::unordered_map<std::uint64_t, Texture> textures;
+        Vector2 viewportSize;
+        std::vector<BatchVertex> batch; // mundo, na ordem de submissão
+        unsigned int batchMode = 0; // GL_TRIANGLES, GL_LINES ou GL_POINTS (com máscara: point sprites)
+        const Image* batchMask = nullptr;
+        float batchSize = 0.0f; // largura das linhas ou tamanho dos pontos
+        std::vector<Vector2> expanded; // faixas, leques e laços convertidos em primitivas separadas
+        GLStreamBuffer stream;
+    };
+
+} // namespace cg
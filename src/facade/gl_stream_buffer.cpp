@@ -0,0 +1,209 @@
+#include "gl_stream_buffer.hpp"
+
+#include <api.hpp>
+
+#include <bit>
+#include <cstdio>
+#include <cstring>
+#include <algorithm>
+
+#ifndef APIENTRY
+#define APIENTRY
+#endif
+
+// Constantes do GL 1.5 ao 4.4 (ausentes do gl.h 1.1 do Windows)
+#ifndef GL_ARRAY_BUFFER
+#define GL_ARRAY_BUFFER 0x8892
+#define GL_STREAM_DRAW 0x88E0
+#endif
+#ifndef GL_MAP_WRITE_BIT
+#define GL_MAP_WRITE_BIT 0x0002
+#endif
+#ifndef GL_MAP_PERSISTENT_BIT
+#define GL_MAP_PERSISTENT_BIT 0x0040
+#define GL_MAP_COHERENT_BIT 0x0080
+#endif
+#ifndef GL_SYNC_GPU_COMMANDS_COMPLETE
+#define GL_SYNC_GPU_COMMANDS_COMPLETE 0x9117
+#define GL_TIMEOUT_EXPIRED 0x911B
+#endif
+
+
+namespace cg {
+
+	namespace {
+		// Assinaturas com tipos equivalentes aos do glext.h (GLsizeiptr/GLintptr: ptrdiff_t; GLsync: ponteiro)
+		struct Functions {
+			void (APIENTRY* genBuffers)(GLsizei, GLuint*) = nullptr;
+			void (APIENTRY* deleteBuffers)(GLsizei, const GLuint*) = nullptr;
+			void (APIENTRY* bindBuffer)(GLenum, GLuint) = nullptr;
+			void (APIENTRY* bufferData)(GLenum, std::ptrdiff_t, const void*, GLenum) = nullptr;
+			void (APIENTRY* bufferSubData)(GLenum, std::ptrdiff_t, std::ptrdiff_t, const void*) = nullptr;
+			void (APIENTRY* bufferStorage)(GLenum, std::ptrdiff_t, const void*, GLbitfield) = nullptr;
+			void* (APIENTRY* mapBufferRange)(GLenum, std::ptrdiff_t, std::ptrdiff_t, GLbitfield) = nullptr;
+			void* (APIENTRY* fenceSync)(GLenum, GLbitfield) = nullptr;
+			GLenum (APIENTRY* clientWaitSync)(void*, GLbitfield, std::uint64_t) = nullptr;
+			void (APIENTRY* deleteSync)(void*) = nullptr;
+		} gl;
+
+		template <typename Function>
+		bool load(Function& function, const char* name)
+		{
+			function = reinterpret_cast<Function>(glutGetProcAddress(name));
+			return function != nullptr;
+		}
+
+		bool hasExtension(const char* name)
+		{
+			const char* extensions = (const char*)glGetString(GL_EXTENSIONS);
+			const std::size_t length = std::strlen(name);
+			for (const char* found = extensions; found && (found = std::strstr(found, name)); found += length)
+				if ((found == extensions || found[-1] == ' ') && (found[length] == ' ' || found[length] == '\0'))
+					return true;
+			return false;
+		}
+
+		constexpr GLbitfield PERSISTENT_FLAGS = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+	}
+
+	void GLStreamBuffer::init()
+	{
+		int major = 0, minor = 0;
+		if (const char* version = (const char*)glGetString(GL_VERSION))
+			std::sscanf(version, "%d.%d", &major, &minor);
+		auto atLeast = [&](int required_major, int required_minor) {
+			return major > required_major || (major == required_major && minor >= required_minor);
+		};
+
+		const bool hasBuffers = atLeast(1, 5) && load(gl.genBuffers, "glGenBuffers") &&
+			load(gl.deleteBuffers, "glDeleteBuffers") && load(gl.bindBuffer, "glBindBuffer") &&
+			load(gl.bufferData, "glBufferData") && load(gl.bufferSubData, "glBufferSubData");
+		if (!hasBuffers) {
+			print_warning("Vertex buffers indisponíveis: os lotes são lidos da CPU");
+			mode = Mode::NONE;
+			return;
+		}
+
+		const bool hasPersistent = (atLeast(4, 4) || hasExtension("GL_ARB_buffer_storage")) &&
+			(atLeast(3, 2) || hasExtension("GL_ARB_sync")) &&
+			(atLeast(3, 0) || hasExtension("GL_ARB_map_buffer_range")) &&
+			load(gl.bufferStorage, atLeast(4, 4) ? "glBufferStorage" : "glBufferStorageARB") &&
+			load(gl.mapBufferRange, "glMapBufferRange") && load(gl.fenceSync, "glFenceSync") &&
+			load(gl.clientWaitSync, "glClientWaitSync") && load(gl.deleteSync, "glDeleteSync");
+		mode = hasPersistent ? Mode::PERSISTENT : Mode::ORPHAN;
+		allocate(MIN_CAPACITY);
+	}
+
+	void GLStreamBuffer::allocate(std::size_t region_capacity)
+	{
+		for (void*& fence : fences) {
+			if (fence)
+				gl.deleteSync(fence);
+			fence = nullptr;
+		}
+		capacity = region_capacity;
+		used = 0;
+		region = 0;
+		isRegionFree = true;
+
+		// O armazenamento não muda de tamanho: troca o buffer (o driver libera o antigo quando a GPU terminar de lê-lo)
+		if (name)
+			gl.deleteBuffers(1, &name);
+		gl.genBuffers(1, &name);
+		gl.bindBuffer(GL_ARRAY_BUFFER, name);
+
+		if (mode == Mode::PERSISTENT) {
+			const auto total = (std::ptrdiff_t)(REGIONS * capacity);
+			gl.bufferStorage(GL_ARRAY_BUFFER, total, nullptr, PERSISTENT_FLAGS);
+			mapped = (std::uint8_t*)gl.mapBufferRange(GL_ARRAY_BUFFER, 0, total, PERSISTENT_FLAGS);
+			if (!mapped) {
+				print_warning("Falha ao mapear o buffer de vértices: usando glBufferData");
+				mode = Mode::ORPHAN;
+				gl.deleteBuffers(1, &name);
+				gl.genBuffers(1, &name);
+				gl.bindBuffer(GL_ARRAY_BUFFER, name);
+			}
+		}
+		if (mode == Mode::ORPHAN)
+			gl.bufferData(GL_ARRAY_BUFFER, (std::ptrdiff_t)capacity, nullptr, GL_STREAM_DRAW);
+		gl.bindBuffer(GL_ARRAY_BUFFER, 0);
+	}
+
+	void GLStreamBuffer::beginFrame()
+	{
+		if (mode == Mode::UNKNOWN)
+			init();
+		if (mode == Mode::NONE)
+			return;
+
+		// Algum lote não coube no quadro anterior: cresce para o próximo
+		if (peak > capacity && capacity < MAX_CAPACITY) {
+			allocate(std::min(std::bit_ceil(peak), MAX_CAPACITY));
+			peak = 0;
+			return;
+		}
+		peak = 0;
+		if (mode != Mode::PERSISTENT)
+			return;
+
+		// A fence fica depois do último desenho que leu a região
+		if (used > 0)
+			fences[region] = gl.fenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+		region = (region + 1) % REGIONS;
+		used = 0;
+
+		// Só consulta a fence (timeout zero): se a GPU está REGIONS quadros atrás, este quadro usa a CPU
+		isRegionFree = true;
+		if (void* fence = fences[region]) {
+			if (gl.clientWaitSync(fence, 0, 0) == GL_TIMEOUT_EXPIRED)
+				isRegionFree = false;
+			else {
+				gl.deleteSync(fence);
+				fences[region] = nullptr;
+			}
+		}
+	}
+
+	std::ptrdiff_t GLStreamBuffer::upload(const void* data, std::size_t bytes)
+	{
+		if (mode == Mode::UNKNOWN || mode == Mode::NONE || bytes == 0)
+			return -1;
+
+		const std::size_t offset = (used + 15) & ~std::size_t(15);
+		if (mode == Mode::PERSISTENT) {
+			if (!isRegionFree)
+				return -1;
+			if (offset + bytes > capacity) {
+				peak = std::max(peak, offset + bytes);
+				return -1;
+			}
+			const std::size_t start = (std::size_t)region * capacity + offset;
+			std::memcpy(mapped + start, data, bytes); // mapeamento coerente: visível sem glFlushMappedBufferRange
+			used = offset + bytes;
+			gl.bindBuffer(GL_ARRAY_BUFFER, name);
+			return (std::ptrdiff_t)start;
+		}
+
+		// Órfão: ao encher, pede um armazenamento novo em vez de esperar a GPU liberar o atual
+		if (bytes > capacity) {
+			peak = std::max(peak, bytes);
+			return -1;
+		}
+		gl.bindBuffer(GL_ARRAY_BUFFER, name);
+		std::size_t start = offset;
+		if (start + bytes > capacity) {
+			gl.bufferData(GL_ARRAY_BUFFER, (std::ptrdiff_t)capacity, nullptr, GL_STREAM_DRAW);
+			start = 0;
+		}
+		gl.bufferSubData(GL_ARRAY_BUFFER, (std::ptrdiff_t)start, (std::ptrdiff_t)bytes, data);
+		used = start + bytes;
+		return (std::ptrdiff_t)start;
+	}
+
+	void GLStreamBuffer::unbind()
+	{
+		if (gl.bindBuffer)
+			gl.bindBuffer(GL_ARRAY_BUFFER, 0);
+	}
+
+} // namespace cg
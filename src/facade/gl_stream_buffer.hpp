@@ -0,0 +1,52 @@
+#pragma once
+// Buffer de vértices em anel para a geometria refeita a cada quadro (itens em edição, guias, gizmo e traços).
+// Com GL 4.4 (ou ARB_buffer_storage + ARB_sync) o buffer fica mapeado permanentemente em REGIONS regiões,
+// uma por quadro, e uma fence marca quando a GPU terminou de ler cada uma; sem isso, o buffer é
+// órfão (glBufferData nulo) ao encher. Em nenhum dos modos a CPU espera pela GPU: se a região do quadro
+// ainda está em uso, ou não cabe o lote, `upload` falha e o lote sai dos arrays da CPU, como antes.
+
+#include <cstddef>
+#include <cstdint>
+
+
+namespace cg {
+
+    class GLStreamBuffer {
+    public:
+        static constexpr int REGIONS = 3; // quadros em voo
+        static constexpr std::size_t MIN_CAPACITY = std::size_t(1) << 20; // bytes por região
+        static constexpr std::size_t MAX_CAPACITY = std::size_t(1) << 24; // quadros maiores (sem cache de blocos) usam a CPU
+
+        /* Passa para a região do próximo quadro (chame uma vez por quadro, antes dos desenhos). */
+        void beginFrame();
+
+        /** Copia os dados para a região do quadro e deixa o buffer ligado em GL_ARRAY_BUFFER.
+         * @return Deslocamento dos dados no buffer, ou -1 se não há espaço ou suporte (nada fica ligado)
+         */
+        std::ptrdiff_t upload(const void* data, std::size_t bytes);
+
+        /* Desliga o GL_ARRAY_BUFFER (os vertex arrays voltam a ler da CPU). */
+        void unbind();
+
+        inline bool isPersistent() const {
+            return mode == Mode::PERSISTENT;
+        }
+
+    private:
+        enum class Mode { UNKNOWN, PERSISTENT, ORPHAN, NONE };
+
+        void init(); // escolhe o modo pelo contexto atual e carrega as funções
+        void allocate(std::size_t region_capacity);
+
+        Mode mode = Mode::UNKNOWN;
+        unsigned int name = 0; // GLuint
+        std::uint8_t* mapped = nullptr; // modo persistente: início do buffer
+        std::size_t capacity = 0; // bytes por região (modo órfão: o buffer inteiro)
+        std::size_t used = 0; // bytes escritos na região atual
+        std::size_t peak = 0; // maior quadro pedido (cresce o buffer no próximo quadro)
+        int region = 0;
+        bool isRegionFree = true; // a GPU já leu a região atual
+        void* fences[REGIONS] = {}; // GLsync de cada região
+    };
+
+} // namespace cg
@@ -17,7 +17,7 @@
 #include <imgui/imgui_impl_glut.h>
 #include <imgui_filedialog/ImGuiFileDialog.h>
 
-#include <util.hpp>
+#include <api.hpp>
 
 #include <cg/math.hpp> // Vector3
 
@@ -69,8 +69,14 @@ public:
     inline static void openFileDialog(const char* key, const char* title, const char* filters, std::function<void(std::ifstream&)>&& callback) {
         Gui::instance()._openFileDialog(key, title, filters, std::move(callback));
     }
-    inline static void saveFileDialog(const char* key, const char* title, const char* filters, std::function<void(std::ofstream&)>&& callback) {
-        Gui::instance()._saveFileDialog(key, title, filters, std::move(callback));
+    inline static void saveFileDialog(const char* key, const char* title, const char* filters, std::function<void(std::ofstream&)>&& callback,
+            std::ios::openmode mode = std::ios::out) {
+        Gui::instance()._saveFileDialog(key, title, filters, std::move(callback), mode);
+    }
+
+    // Caminho escolhido no diálogo (válido dentro das callbacks de abrir/salvar).
+    inline static std::string getSelectedFilePath() {
+        return ImGuiFileDialog::Instance()->GetFilePathName();
     }
 
     inline static bool isDialogOpen() {
@@ -223,8 +229,7 @@ private:
                 std::string filePathName = ImGuiFileDialog::Instance()->GetFilePathName();
                 print_info("Arquivo selecionado: %s", filePathName.c_str());
 
-                //std::ofstream file(filePathName, std::ios::binary); // TODO -> Versão binária
-                std::ofstream file(filePathName);
+                std::ofstream file(filePathName, saveFileMode);
                 if (file.is_open()) {
 					cacheLastPath(filePathName);
                     if (saveFileCallback) {
@@ -265,10 +270,12 @@ private:
         openFileCallback = std::move(callback);
     }
 
-    inline void _saveFileDialog(const char* key, const char* title, const char* filters, std::function<void(std::ofstream&)>&& callback) {
+    inline void _saveFileDialog(const char* key, const char* title, const char* filters, std::function<void(std::ofstream&)>&& callback,
+            std::ios::openmode mode) {
         ImGuiFileDialog::Instance()->OpenDialog(key, title, filters, { {}, {}, dialogConfigPath });
         dialogSave = key;
         saveFileCallback = std::move(callback);
+        saveFileMode = mode;
     }
 
     inline bool _isDialogOpen() {
@@ -285,6 +292,7 @@ private:
     const char* dialogSave = nullptr;
     std::function<void(std::ifstream&)> openFileCallback = nullptr;
     std::function<void(std::ofstream&)> saveFileCallback = nullptr;
+    std::ios::openmode saveFileMode = std::ios::out;
     std::string dialogConfigPath{};
 
     Gui() = default;
@@ -446,6 +454,10 @@ public:
      * @param active: Controls a bool to represent the active state.
      * Returns true if active.
      */ 
+    inline bool showInputText(char* buffer, std::size_t size, const char* label = "") const {
+        return ImGui::InputText(label, buffer, size);
+    }
+
     inline bool showCheckBox(bool* active, const char* label = "") const {
         return ImGui::Checkbox(label, active);
     }
@@ -601,7 +613,8 @@ public:
         ImGui::ColorEdit3(label, (float*)&color->r); // Edit 3 floats representing a color
     }
 
-inline void show2ColorEdit(cg::Color* primary, cg::Color* secondary, const char *label = "") {
+// Retorna `true` se a cor primária foi editada.
+inline bool show2ColorEdit(cg::Color* primary, cg::Color* secondary, const char *label = "") {
     ImGuiStyle& style = ImGui::GetStyle();
 
     // largura disponível total
@@ -626,7 +639,7 @@ inline void show2ColorEdit(cg::Color* primary, cg::Color* secondary, const char
 
     // desenha os widgets na mesma linha: ColorEdit1 | ColorEdit2 | Label
     ImGui::PushItemWidth(each_w);
-    ImGui::ColorEdit3("##primary_color", (float*)&primary->r, ImGuiColorEditFlags_NoLabel);
+    bool changed = ImGui::ColorEdit3("##primary_color", (float*)&primary->r, ImGuiColorEditFlags_NoLabel);
     ImGui::SameLine();
 
     ImGui::PushItemWidth(each_w);
@@ -639,6 +652,7 @@ inline void show2ColorEdit(cg::Color* primary, cg::Color* secondary, const char
     // limpar os PushItemWidth (duas pushes => duas pops)
     ImGui::PopItemWidth();
     ImGui::PopItemWidth();
+    return changed;
 }
 
 
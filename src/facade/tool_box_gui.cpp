@@ -0,0 +1,285 @@
+﻿#include "tool_box_gui.hpp"
+
+#include <cg/canvas.hpp>
+#include <cg/image_export.hpp>
+#include <cg/thread_pool.hpp>
+#include <cg/tools/select_tool.hpp>
+
+#include "gui.hpp"
+
+
+namespace cg {
+
+	void ToolBoxGui::render(ToolBox& tool_box)
+	{
+		constexpr float window_margin = 15.0f;
+		// Cada janela deve ser criada num escopo separado para
+		// invocar os construtores/ destrutores necessários
+		{
+			Window settings("Settings", {window_margin, window_margin});
+
+			if (settings.showCheckBox(&tool_box.showGuideLines, "Show Guide Lines")) {}
+			bool useTileCache = tool_box.canvas->isTileCacheEnabled();
+			if (settings.showCheckBox(&useTileCache, "Cache static tiles"))
+				tool_box.canvas->setTileCacheEnabled(useTileCache);
+			bool useStaticLayer = tool_box.canvas->isStaticLayerEnabled();
+			if (settings.showCheckBox(&useStaticLayer, "Cache static layer"))
+				tool_box.canvas->setStaticLayerEnabled(useStaticLayer);
+			bool useParallelPrep = tool_box.canvas->isParallelPrepEnabled();
+			if (settings.showCheckBox(&useParallelPrep, "Parallel preparation"))
+				tool_box.canvas->setParallelPrepEnabled(useParallelPrep);
+
+			settings.showText("Application average %.3f ms/frame (%.1f FPS)", 1000.0f / Gui::getFps(), Gui::getFps());
+
+			// Sistema de jobs (contadores acumulados)
+			const profiler::JobCounters jobs = ThreadPool::shared().getCounters();
+			settings.showText("Jobs %llu | blocks %llu | stolen %llu | helped %llu (%u threads)",
+				(unsigned long long)jobs.jobs, (unsigned long long)jobs.blocks, (unsigned long long)jobs.stolen,
+				(unsigned long long)jobs.helped, ThreadPool::shared().getThreadCount());
+			if (settings.showButton("Reset jobs"))
+				ThreadPool::shared().resetCounters();
+
+			// Latência entrada -> tela (input-to-photon)
+			const profiler::Histogram& latency = tool_box.canvas->latency.getHistogram();
+			settings.showText("Input latency p50 %.2f | p90 %.2f | p99 %.2f | max %.2f ms (%llu events)",
+				latency.percentile(50.0) / 1000.0, latency.percentile(90.0) / 1000.0,
+				latency.percentile(99.0) / 1000.0, latency.max() / 1000.0,
+				(unsigned long long)latency.count());
+			if (settings.showButton("Reset latency"))
+				tool_box.canvas->latency.clear();
+			settings.sameLine();
+			if (settings.showButton("Export latency"))
+				exportLatency(tool_box);
+		}
+
+		enum { NONE, SAVE, LOAD, EXPORT } clicked = NONE;
+		{  // ToolBox Window
+			static int counter = 0;
+			static float f = 0.0f;
+
+			constexpr float estimate_x = 123.0f;
+			Window toolBox("ToolBox", { tool_box.canvas->getWindowSize().x - estimate_x - window_margin, window_margin });
+			// TODO -> Use Icon buttons for each tool
+
+			// toolBox.showCheckBox(&check, "Active
+
+			int _currentTool = tool_box.getCurrentTool();
+			toolBox.showRadioButton(&_currentTool, ToolBox::POINT, "Point [F1]"); // use point
+			toolBox.showRadioButton(&_currentTool, ToolBox::LINE, "Line [F2]"); // use line
+			toolBox.showRadioButton(&_currentTool, ToolBox::POLYGON, "Polygon [F3]"); // use polygon
+			toolBox.showCheckBox(&tool_box.outlinePolygons, "Outline"); // contorno na cor secundária
+			toolBox.showRadioButton(&_currentTool, ToolBox::SELECT, "Select [F4]"); // selection tool
+			if (_currentTool != tool_box.getCurrentTool()) {
+				tool_box.setCurrentTool(_currentTool); // também troca o cursor
+				// Do something on tool change
+			}
+
+			// TODO [Extra] -> Polígono regular
+			// switch (canvas.toolBox._currentTool) {
+			// case cg::ToolBox::Primitives::REGULAR_POLYGON: {
+			//     toolBox.sameLine();
+			//     toolBox.showSliderInt(&canvas.toolBox.polygonEdges, 1, 255, "Edges");
+			//     toolBox.sameLine();
+			//     toolBox.showText("[%d]", canvas.toolBox.polygonEdges);
+			// } break;
+			// default: break;
+			// }
+		}
+
+		{ // Controls Window
+			SelectTool& selection = tool_box.getSelectorTool();
+			constexpr Vector2 estimate_size = {414.0f, 240.0f};
+			Window controls("Controls", {tool_box.canvas->getWindowSize().x - estimate_size.x - window_margin , tool_box.canvas->getWindowSize().y - estimate_size.y - window_margin});
+
+			if (controls.show2ColorEdit(tool_box.getColorPtr(), tool_box.getSecondaryColorPtr(), "[x: toggle]"))
+				tool_box.colorChanged();
+
+			// Update translation
+			{
+				Vector2 translation = selection.getPosition();
+				cg::Vector2 increment = controls.showIncrementalSliderVector2(
+					&translation,
+					tool_box.canvas->getUpperLeft(),
+					tool_box.canvas->getBottomRight(),
+					1.0f,
+					"X", "<", ">",
+					"Y", "V", "^"
+				);
+
+				if (increment) {
+					selection.translate(increment);
+				}
+				else {
+					if (translation != selection.getPosition())
+						selection.setPosition(translation);
+				}
+				//controls.showSliderVector2(&translation, tool_box.canvas->getUpperLeft(), tool_box.canvas->getBottomRight(), "X", "Y");
+
+			}
+			// Update rotation
+			{
+				float rotation_deg = rad_to_deg(selection.getRotation()); // degrees
+				int increment_unit = controls.showIncrementalFloatSlider(
+					&rotation_deg, -180.0f, 180.0f, 1.0f,
+					"Rotation", "-1 deg", "+1 deg", "[", "]");
+
+				if (increment_unit) // Apply negative / positive rotation
+					selection.rotate(deg_to_rad((float)increment_unit));
+				else {
+					float rotation_rad = deg_to_rad(rotation_deg); // radians
+					if (fabsf(rotation_rad - selection.getRotation()) > ZERO_PRECISION_ERROR)
+						selection.setRotation(rotation_rad);
+				}
+			}
+			// Update scale
+			{
+				Vector2 scale = selection.getScale();
+				Vector2 increment = controls.showIncrementalSliderVector2(&scale, 1e-3f, 16.0f, .1f,
+					"Sx", "*.9x", "*1.1x", "Sy [Shift]", "*.9y", "*1.1y");
+				//controls.showSliderVector2(&scale, 1e-3f, 16.0f, "Sx", "Sy");
+
+				if (increment) {
+					if (ToolBox::isScaleInsideBounds(selection.getScale(), increment))
+						selection.scale(Vector2::one() + increment);
+				}
+				else if ((scale - selection.getScale()).abs() > Vector2(ZERO_PRECISION_ERROR))
+					selection.setScale(scale);
+			}
+			// Reflexão
+			{
+				if (controls.showButton("Mirror X"))
+					selection.mirrorX();
+				controls.sameLine();
+				controls.showText("[\\]");
+				controls.sameLine();
+				if (controls.showButton("Mirror Y"))
+					selection.mirrorY();
+				controls.sameLine();
+				controls.showText("[/]");
+				controls.sameLine();
+				if (controls.showButton("Mirror Origin"))
+					selection.mirrorOrigin();
+				controls.sameLine();
+				controls.showText("[']");
+			}
+			// Cisalhamento
+			{
+				if (controls.showButton("ShX+"))
+					selection.shearH(1.0f);
+				controls.sameLine();
+				controls.showText("[<]");
+				controls.sameLine();
+				if (controls.showButton("ShX-"))
+					selection.shearH(-1.0f);
+				controls.sameLine();
+				controls.showText("[>]");
+				controls.sameLine();
+				if (controls.showButton("ShY+"))
+					selection.shearV(1.0f);
+				controls.sameLine();
+				controls.showText("[^]");
+				controls.sameLine();
+				if (controls.showButton("ShY-"))
+					selection.shearV(-1.0f);
+				controls.sameLine();
+				controls.showText("[v]");
+				controls.sameLine();
+				controls.showText("Shear [Ctrl]");
+			}
+
+			// Save / Load / Clear / Delete
+			{
+				if (controls.showButton("Save to file"))
+					clicked = SAVE;
+				controls.sameLine();
+				if (controls.showButton("Export image"))
+					clicked = EXPORT;
+				controls.sameLine();
+				if (controls.showButton("Load from file"))
+					clicked = LOAD;
+				controls.sameLine();
+				if (controls.showButton("Clear screen"))
+					tool_box.clearScreen();
+				if (selection.hasSelection()) {
+					controls.sameLine();
+					if (controls.showButton("Delete"))
+						selection.deleteSelected();
+					controls.sameLine();
+					controls.showText("[del]");
+				}
+				controls.showSliderInt(&exportScale, 1, 64, "Export scale", "%dx");
+			}
+			// Texto
+			{
+				controls.showInputText(textInput, sizeof(textInput), "##text");
+				controls.sameLine();
+				if (controls.showButton("Add text"))
+					tool_box.addText(textInput);
+			}
+		}
+
+		switch (clicked) {
+		case SAVE: {
+			save(tool_box);
+		} break;
+		case LOAD: {
+			load(tool_box);
+		} break;
+		case EXPORT: {
+			exportImage(tool_box);
+		} break;
+		default:
+			break;
+		}
+	}
+
+	bool ToolBoxGui::isUsingKeyboard() const
+	{
+		return Gui::isUsingKeyboardInput();
+	}
+
+	bool ToolBoxGui::isDialogOpen() const
+	{
+		return Gui::isDialogOpen();
+	}
+
+	void ToolBoxGui::save(ToolBox& tool_box)
+	{
+		Gui::saveFileDialog("SaveFile", "Salvando arquivo...", ".tcgp,.cgp", [&tool_box](std::ofstream& ofs) {
+			tool_box.canvas->save(ofs);
+		});
+	}
+
+	void ToolBoxGui::load(ToolBox& tool_box)
+	{
+		Gui::openFileDialog("OpenFile", "Escolha um arquivo...", ".tcgp,.cgp", [&tool_box](std::ifstream& ifs) {
+			if (ifs.eof()) {
+				print_warning("File is empty or not found.");
+				return;
+			}
+
+			tool_box.clearScreen(); // Clear the canvas before loading new items
+			tool_box.canvas->load(ifs);
+		});
+	}
+
+	void ToolBoxGui::exportLatency(ToolBox& tool_box)
+	{
+		Gui::saveFileDialog("SaveLatency", "Exportando latência...", ".csv", [&tool_box](std::ofstream& ofs) {
+			tool_box.canvas->latency.getHistogram().writeCsv(ofs);
+		});
+	}
+
+	void ToolBoxGui::exportImage(ToolBox& tool_box)
+	{
+		Gui::saveFileDialog("ExportImage", "Exportando imagem...", ".png,.ppm", [this, &tool_box](std::ofstream& ofs) {
+			ImageExportOptions options;
+			Vector2 window_size = tool_box.canvas->getWindowSize();
+			options.width = (int)window_size.x * exportScale;
+			options.height = (int)window_size.y * exportScale;
+			options.format = imageFormatFromPath(Gui::getSelectedFilePath());
+			cg::exportImage(*tool_box.canvas, ofs, options);
+		}, std::ios::out | std::ios::binary);
+	}
+
+} // namespace cg
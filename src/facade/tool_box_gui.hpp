@@ -0,0 +1,26 @@
+﻿#pragma once
+// Painéis Dear ImGui e diálogos de arquivo da caixa de ferramentas.
+// Fica na aplicação (não no cgcore), pois depende da GUI e do GLUT.
+
+#include <cg/tool_box.hpp>
+
+
+namespace cg {
+
+    class ToolBoxGui : public ToolBox::Frontend {
+    public:
+        void render(ToolBox& tool_box) override;
+        bool isUsingKeyboard() const override;
+        bool isDialogOpen() const override;
+
+        void save(ToolBox& tool_box) override;
+        void load(ToolBox& tool_box) override;
+
+        void exportLatency(ToolBox& tool_box); // histograma de latência de entrada em CSV
+        void exportImage(ToolBox& tool_box); // imagem ampliada em `exportScale` (PNG/PPM)
+
+        int exportScale = 4; // ampliação da janela na exportação de imagem
+        char textInput[256] = "Texto"; // texto do botão "Add text" (UTF-8)
+    };
+
+} // namespace cg
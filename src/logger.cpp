@@ -0,0 +1,188 @@
+#include "logger.hpp"
+
+#include <atomic>
+#include <thread>
+#include <cstring>
+
+#include "util.hpp" // SET_CLI_* / RESET_CLI
+
+
+namespace logging {
+
+	namespace {
+		// Enquanto falso, os registros são escritos de forma síncrona (antes da criação ou após a destruição do logger).
+		constinit std::atomic<bool> alive{ false };
+
+		struct Record {
+			std::atomic<std::size_t> sequence{ 0 };
+			Level level = Level::INFO;
+			std::uint16_t length = 0;
+			char text[RECORD_TEXT_SIZE];
+		};
+
+		/** Fila circular limitada (múltiplos produtores, um consumidor), baseada no algoritmo de D. Vyukov.
+		 * Cada célula carrega um número de sequência que diz se ela está livre para o produtor da
+		 * posição `pos` (sequence == pos) ou pronta para o consumidor (sequence == pos + 1).
+		 */
+		class Logger {
+		public:
+			Logger() {
+				for (std::size_t i = 0; i < CAPACITY; ++i)
+					cells[i].sequence.store(i, std::memory_order_relaxed);
+				worker = std::thread(&Logger::run, this);
+				alive.store(true, std::memory_order_release);
+			}
+
+			~Logger() {
+				alive.store(false, std::memory_order_release);
+				stopping.store(true, std::memory_order_release);
+				wake();
+				worker.join();
+				drain(); // o que sobrou após a thread encerrar
+			}
+
+			bool push(Level level, const char* text, std::size_t length) {
+				std::size_t pos = enqueuePos.load(std::memory_order_relaxed);
+				Record* cell;
+				for (;;) {
+					cell = &cells[pos & (CAPACITY - 1)];
+					std::size_t sequence = cell->sequence.load(std::memory_order_acquire);
+					auto diff = (std::intptr_t)sequence - (std::intptr_t)pos;
+					if (diff == 0) {
+						if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+							break;
+					}
+					else if (diff < 0) {
+						droppedCount.fetch_add(1, std::memory_order_relaxed);
+						return false; // cheia: descarta em vez de bloquear a thread que chamou
+					}
+					else {
+						pos = enqueuePos.load(std::memory_order_relaxed);
+					}
+				}
+				cell->level = level;
+				cell->length = (std::uint16_t)length;
+				std::memcpy(cell->text, text, length);
+				cell->sequence.store(pos + 1, std::memory_order_release);
+				wake();
+				return true;
+			}
+
+			void flush() {
+				if (std::this_thread::get_id() == worker.get_id())
+					return;
+				std::size_t target = enqueuePos.load(std::memory_order_acquire);
+				wake();
+				std::size_t done = written.load(std::memory_order_acquire);
+				while (done < target && !stopping.load(std::memory_order_acquire)) {
+					written.wait(done, std::memory_order_acquire);
+					done = written.load(std::memory_order_acquire);
+				}
+			}
+
+			std::uint64_t dropped() const {
+				return droppedCount.load(std::memory_order_relaxed);
+			}
+
+		private:
+			inline void wake() {
+				signal.fetch_add(1, std::memory_order_release);
+				signal.notify_one();
+			}
+
+			void run() {
+				while (!stopping.load(std::memory_order_acquire)) {
+					std::uint32_t seen = signal.load(std::memory_order_acquire);
+					drain();
+					if (stopping.load(std::memory_order_acquire))
+						break;
+					signal.wait(seen, std::memory_order_acquire);
+				}
+			}
+
+			// Consome todos os registros prontos (apenas a thread de log ou o destrutor chamam).
+			void drain() {
+				for (;;) {
+					Record& cell = cells[dequeuePos & (CAPACITY - 1)];
+					std::size_t sequence = cell.sequence.load(std::memory_order_acquire);
+					if (sequence != dequeuePos + 1)
+						break; // vazia (ou o produtor ainda está escrevendo nesta célula)
+
+					write_now(cell.level, cell.text, cell.length);
+					cell.sequence.store(dequeuePos + CAPACITY, std::memory_order_release);
+					++dequeuePos;
+					written.store(dequeuePos, std::memory_order_release);
+					written.notify_all();
+				}
+
+				std::uint64_t total = droppedCount.load(std::memory_order_relaxed);
+				if (total != reportedDrops) {
+					char buffer[RECORD_TEXT_SIZE];
+					std::size_t length = format(buffer, "[Log] %llu mensagens descartadas (fila cheia)",
+						(unsigned long long)(total - reportedDrops));
+					write_now(Level::WARN, buffer, length);
+					reportedDrops = total;
+				}
+			}
+
+		private:
+			Record cells[CAPACITY];
+			alignas(64) std::atomic<std::size_t> enqueuePos{ 0 };
+			alignas(64) std::size_t dequeuePos = 0; // somente o consumidor altera
+			std::atomic<std::size_t> written{ 0 };
+			std::atomic<std::uint32_t> signal{ 0 };
+			std::atomic<std::uint64_t> droppedCount{ 0 };
+			std::uint64_t reportedDrops = 0;
+			std::atomic<bool> stopping{ false };
+			std::thread worker;
+		};
+
+		Logger& instance() {
+			static Logger logger;
+			return logger;
+		}
+	}
+
+	void push(Level level, const char* text, std::size_t length) {
+		if (!alive.load(std::memory_order_acquire)) {
+			instance(); // inicia a thread na primeira mensagem
+			if (!alive.load(std::memory_order_acquire)) { // já destruído
+				write_now(level, text, length);
+				return;
+			}
+		}
+		instance().push(level, text, length);
+	}
+
+	void write_now(Level level, const char* text, std::size_t length) {
+		switch (level) {
+		case Level::INFO:
+			SET_CLI_BLUE();
+			break;
+		case Level::SUCCESS:
+			SET_CLI_GREEN();
+			break;
+		case Level::WARN:
+			SET_CLI_YELLOW();
+			break;
+		case Level::ERR:
+			SET_CLI_RED();
+			break;
+		default: // trace/debug sem cor
+			break;
+		}
+		std::fwrite(text, 1, length, stderr);
+		std::fputc('\n', stderr);
+		RESET_CLI();
+	}
+
+	void flush() {
+		if (alive.load(std::memory_order_acquire))
+			instance().flush();
+	}
+
+	std::uint64_t dropped() {
+		return alive.load(std::memory_order_acquire) ? instance().dropped() : 0;
+	}
+
+} // namespace logging
@@ -0,0 +1,161 @@
+#pragma once
+/* Backend assíncrono de log.
+ * As mensagens são formatadas na thread que chama (custo de um snprintf) e enfileiradas num
+ * buffer circular limitado e sem locks. Uma thread de fundo esvazia a fila e escreve no stderr,
+ * então a thread de renderização nunca espera pelo terminal (ou pelo arquivo redirecionado).
+ *
+ * Filtro em tempo de compilação: defina CG_LOG_LEVEL (0: trace ... 5: error, 6: off).
+ * Níveis abaixo do mínimo são descartados por `if constexpr` e não custam nada.
+ */
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <initializer_list>
+#include <type_traits>
+
+
+#ifndef CG_LOG_LEVEL
+	#ifdef NDEBUG
+		#define CG_LOG_LEVEL 2 // info
+	#else
+		#define CG_LOG_LEVEL 0 // trace
+	#endif
+#endif // CG_LOG_LEVEL
+
+#ifndef CG_LOG_CAPACITY
+	#define CG_LOG_CAPACITY 1024 // quantidade de registros na fila (potência de 2)
+#endif // CG_LOG_CAPACITY
+
+
+namespace logging {
+
+	enum class Level : std::uint8_t {
+		TRACE = 0,
+		DBG, // DEBUG e ERROR colidem com macros (-DDEBUG, wingdi.h)
+		INFO,
+		SUCCESS,
+		WARN,
+		ERR,
+		OFF,
+	};
+
+	inline constexpr Level MIN_LEVEL = static_cast<Level>(CG_LOG_LEVEL);
+
+	// Verdadeiro se o nível é compilado. Use com `if constexpr`.
+	template <Level L>
+	inline constexpr bool enabled = L >= MIN_LEVEL && L != Level::OFF;
+
+	// Tamanho máximo do texto de um registro (mensagens maiores são truncadas).
+	inline constexpr std::size_t RECORD_TEXT_SIZE = 256;
+	inline constexpr std::size_t CAPACITY = CG_LOG_CAPACITY;
+	static_assert((CAPACITY & (CAPACITY - 1)) == 0, "CG_LOG_CAPACITY deve ser potência de 2");
+
+
+	/** Campo estruturado `chave=valor` anexado ao final de uma mensagem.
+	 * O valor é formatado na hora da construção, então strings temporárias podem ser passadas.
+	 */
+	struct Field {
+		const char* key;
+		char value[48];
+
+		Field(const char* key, const char* v) : key{ key } { std::snprintf(value, sizeof(value), "%s", v ? v : "null"); }
+		Field(const char* key, const std::string& v) : Field{ key, v.c_str() } {}
+		Field(const char* key, std::string_view v) : key{ key } {
+			std::snprintf(value, sizeof(value), "%.*s", (int)v.size(), v.data());
+		}
+		Field(const char* key, bool v) : Field{ key, v ? "true" : "false" } {}
+
+		template <typename T> requires std::is_integral_v<T>
+		Field(const char* key, T v) : key{ key } {
+			if constexpr (std::is_signed_v<T>)
+				std::snprintf(value, sizeof(value), "%lld", (long long)v);
+			else
+				std::snprintf(value, sizeof(value), "%llu", (unsigned long long)v);
+		}
+
+		template <typename T> requires std::is_floating_point_v<T>
+		Field(const char* key, T v) : key{ key } { std::snprintf(value, sizeof(value), "%g", (double)v); }
+	};
+
+
+	/* Enfileira um registro já formatado. Nunca bloqueia: se a fila estiver cheia o registro é descartado e contado. */
+	void push(Level level, const char* text, std::size_t length);
+
+	/* Escreve diretamente no stderr (sem fila). Usado antes/depois do ciclo de vida da thread de log. */
+	void write_now(Level level, const char* text, std::size_t length);
+
+	/* Espera até que todos os registros enfileirados até aqui sejam escritos. */
+	void flush();
+
+	/* Quantidade de registros descartados por falta de espaço na fila desde o início. */
+	std::uint64_t dropped();
+
+
+	template <typename... Args>
+	inline std::size_t format(char (&buffer)[RECORD_TEXT_SIZE], const char* message, Args... args) {
+		int length;
+		if constexpr (sizeof...(Args) > 0)
+			length = std::snprintf(buffer, RECORD_TEXT_SIZE, message, args...); // segura, tipada
+		else
+			length = std::snprintf(buffer, RECORD_TEXT_SIZE, "%s", message);
+		if (length < 0)
+			return 0;
+		return std::min((std::size_t)length, RECORD_TEXT_SIZE - 1);
+	}
+
+	template <Level L, typename... Args>
+	inline void write(const char* message, Args... args) {
+		if constexpr (enabled<L>) {
+			char buffer[RECORD_TEXT_SIZE];
+			std::size_t length = format(buffer, message, args...);
+			push(L, buffer, length);
+		}
+	}
+
+	/** Escreve uma mensagem com campos estruturados: `mensagem chave=valor chave=valor`.
+	 * Ex.: `logging::write<Level::INFO>("Arquivo aberto", { { "path", path }, { "itens", n } });`
+	 */
+	template <Level L>
+	inline void write(const char* message, std::initializer_list<Field> fields) {
+		if constexpr (enabled<L>) {
+			char buffer[RECORD_TEXT_SIZE];
+			std::size_t length = format(buffer, message);
+			for (const Field& field : fields) {
+				if (length >= RECORD_TEXT_SIZE - 1)
+					break;
+				int written = std::snprintf(buffer + length, RECORD_TEXT_SIZE - length, " %s=%s", field.key, field.value);
+				if (written < 0)
+					break;
+				length = std::min(length + (std::size_t)written, RECORD_TEXT_SIZE - 1);
+			}
+			push(L, buffer, length);
+		}
+	}
+
+	template <typename... Args>
+	inline void trace(const char* message, Args... args) { write<Level::TRACE>(message, args...); }
+	template <typename... Args>
+	inline void debug(const char* message, Args... args) { write<Level::DBG>(message, args...); }
+	template <typename... Args>
+	inline void info(const char* message, Args... args) { write<Level::INFO>(message, args...); }
+	template <typename... Args>
+	inline void warning(const char* message, Args... args) { write<Level::WARN>(message, args...); }
+	template <typename... Args>
+	inline void error(const char* message, Args... args) { write<Level::ERR>(message, args...); }
+
+	inline void trace(const char* message, std::initializer_list<Field> fields) { write<Level::TRACE>(message, fields); }
+	inline void debug(const char* message, std::initializer_list<Field> fields) { write<Level::DBG>(message, fields); }
+	inline void info(const char* message, std::initializer_list<Field> fields) { write<Level::INFO>(message, fields); }
+	inline void warning(const char* message, std::initializer_list<Field> fields) { write<Level::WARN>(message, fields); }
+	inline void error(const char* message, std::initializer_list<Field> fields) { write<Level::ERR>(message, fields); }
+
+} // namespace logging
+
+
+// Macros que também evitam a avaliação dos argumentos quando o nível está desabilitado.
+#define LOG_TRACE(...) do { if constexpr (logging::enabled<logging::Level::TRACE>) logging::trace(__VA_ARGS__); } while (0)
+#define LOG_DEBUG(...) do { if constexpr (logging::enabled<logging::Level::DBG>) logging::debug(__VA_ARGS__); } while (0)
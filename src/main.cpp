@@ -1,9 +1,13 @@
-﻿#include "util.hpp" // Importações do Open GL, FreeGLUT e métodos auxiliares para debug
+﻿#include "api.hpp" // Importações do Open GL, FreeGLUT e métodos auxiliares para debug
 
 #include <cstdlib> // Inclui algumas convenções do C
 #include <cstring> // Manipulação de cadeias de caracteres
+#include <string>
+#include <fstream>
 
 #include "facade/gui.hpp"
+#include "facade/gl_backend.hpp"
+#include "facade/tool_box_gui.hpp"
 
 #include "cg/geometry.hpp"
 #include "cg/canvas.hpp"
@@ -12,7 +16,19 @@
 #include "cg/canvas_itens/line.hpp"
 #include "cg/canvas_itens/polygon.hpp"
 
+#include "profiler.hpp"
+
 static cg::Canvas canvas{ cg::Flag::SIZE * 30 };
+static cg::GLBackend glBackend; // destino dos `_render` do Canvas
+static cg::ToolBoxGui toolBoxGui; // painéis da caixa de ferramentas
+
+// Gravação / reprodução da entrada (--record / --replay) e estatísticas por fase do quadro
+static cg::InputRecorder recorder;
+static cg::InputReplayer replayer;
+static profiler::FrameStats frameStats;
+static profiler::TimePoint replayStart;
+static std::string replayPath;
+static std::string reportPath;
 
 cg::Flag *flag = nullptr;
 
@@ -22,35 +38,89 @@ int init(void)
 {
     //auto _flag_ptr = std::make_unique<cg::Flag>();
 
-    auto half_size = canvas.getWindowSize() / 2.0f;
-    glClearColor(0.1333f, 0.1333f, 0.1333f, 0.0f); // cor de fundo
-    glMatrixMode(GL_PROJECTION);
-    gluOrtho2D(-half_size.x, half_size.x, -half_size.y, half_size.y); // coordenadas limite do viewport normalizadas (em 2D)
+    glClearColor(canvas.background.r, canvas.background.g, canvas.background.b, canvas.background.a); // cor de fundo
+    // A projeção vem da câmera do Canvas, a cada quadro (`RenderBackend::setProjection`)
 
     //flag = _flag_ptr.get();
     //canvas.insert(std::move(_flag_ptr));
 
+    cg::RenderBackend::bind(&glBackend);
+    canvas.toolBox.frontend = &toolBoxGui;
+    // Itens estáticos ficam na GPU como texturas dos blocos; o anel de vértices só leva os alterados,
+    // as guias e o gizmo (desligável nas configurações)
+    canvas.setTileCacheEnabled(true);
+
     return EXIT_SUCCESS;
 }
 
 
+static void reshape(int w, int h);
+
+/* Escreve o relatório da reprodução e encerra o laço principal. */
+static void finishReplay()
+{
+    double wall_ms = std::chrono::duration<double, std::milli>(profiler::Clock::now() - replayStart).count();
+
+    std::ofstream file;
+    if (!reportPath.empty())
+        file.open(reportPath);
+    std::ostream& os = file.is_open() ? (std::ostream&)file : std::cout;
+
+    os << "replay " << replayPath << '\n'
+        << "frames " << replayer.getFrameCount() << " wall_ms " << wall_ms
+        << " recorded_ms " << replayer.getRecordedDuration() << "\n\n";
+    frameStats.writeReport(os);
+    profiler::writeSummary(os, "latency", canvas.latency.getHistogram());
+    os.flush();
+
+    print_success("Replay finished: %zu frames in %.1f ms", replayer.getFrameCount(), wall_ms);
+    canvas.isReplaying = false;
+    glutLeaveMainLoop();
+}
+
+
 /* Loop principal de desenho. */
 void display()
 {
-    Gui::newFrame();
+    using Phase = profiler::FrameStats::Phase;
+    profiler::ScopedTimer frame_timer{ frameStats[Phase::FRAME] };
 
-    GLdebug() {
-        glClear(GL_COLOR_BUFFER_BIT); // Limpa o quadro do buffer de cor
+    // Na reprodução, cada quadro desenhado consome um quadro gravado
+    if (canvas.isReplaying && !replayer.feed(canvas, reshape) && canvas.input.empty()) {
+        finishReplay();
+        return;
+    }
+
+    {
+        profiler::ScopedTimer timer{ frameStats[Phase::INPUT] };
+        // Eventos acumulados desde o último quadro (movimentos já agrupados pela fila)
+        canvas.dispatchInput();
     }
 
-    canvas.updateRender();
+    Gui::newFrame();
+
+    {
+        profiler::ScopedTimer timer{ frameStats[Phase::RENDER] };
+        GLdebug() {
+            glClear(GL_COLOR_BUFFER_BIT); // Limpa o quadro do buffer de cor
+        }
 
-    Gui::render();
-    Gui::endFrame();
+        canvas.updateRender();
+    }
 
-    // Sincroniza comandos de desenho não executados,
-    // em tempo finito [GLUT_DOUBLE buffering]
-    glutSwapBuffers();
+    {
+        profiler::ScopedTimer timer{ frameStats[Phase::GUI] };
+        Gui::render();
+        Gui::endFrame();
+    }
+
+    {
+        profiler::ScopedTimer timer{ frameStats[Phase::PRESENT] };
+        // Sincroniza comandos de desenho não executados,
+        // em tempo finito [GLUT_DOUBLE buffering]
+        glutSwapBuffers();
+    }
+    canvas.latency.markPresented(); // latência dos eventos despachados neste quadro
 
     // Força atualização contínua. Garantindo execução imediata.
     glutPostRedisplay(); // Recomendado para uso com a GUI
@@ -59,23 +129,17 @@ void display()
 
 /* Chamada sempre que a janela for redimensionada */
 static void reshape(int w, int h) {
+    if (canvas.isReplaying && (w != (int)canvas.getWindowSize().x || h != (int)canvas.getWindowSize().y))
+        glutReshapeWindow(w, h); // tamanho vindo da gravação (o GLUT chamará reshape novamente)
+
     // 1. Atualiza o viewport
     GLdebug() {
         glViewport(0, 0, w, h);
     }
 
-    glMatrixMode(GL_PROJECTION);
-	glLoadIdentity(); // Reseta a matriz de projeção
-
     cg::Vector2 window_size( w, h );
-	cg::Vector2 half_size = window_size / 2.0f;
-    gluOrtho2D(-half_size.x, half_size.x, -half_size.y, half_size.y); // coordenadas limite do viewport normalizadas (em 2D)
-
-	// TODO -> Deslocar a origem do mundo usando o botão do meio do mouse
-	//glMatrixMode(GL_MODELVIEW);
-	//glLoadIdentity(); // Reseta a matriz de modelo
 
-    // Envia o novo tamanho da janela para o canvas
+    // Envia o novo tamanho da janela para o canvas (a câmera refaz a projeção no próximo quadro)
     canvas.setWindowSize(window_size);
 
     // Repassa o evento para o ImGui
@@ -154,6 +218,18 @@ static void onMouseButtonEvent(int button, int state, int x, int y)
             break;
         }
         break;
+    case GLUT_MIDDLE_BUTTON: // desloca a câmera
+        switch (state) {
+        case GLUT_DOWN:
+            canvas.sendScreenInput<cg::io::MouseMiddleButtonPressed>(x, y);
+            break;
+        case GLUT_UP:
+            canvas.sendScreenInput<cg::io::MouseMiddleButtonReleased>(x, y);
+            break;
+        default: // ignore
+            break;
+        }
+        break;
     default: // ignore
         break;
     }
@@ -191,25 +267,20 @@ static void onKeyboardKeyPressed(unsigned char key, int x, int y)
 
 	unsigned char ESC = 27;
 
-    std::cout << "[Key]: ";
-    if (mods & GLUT_ACTIVE_CTRL)
-		std::cout << "Ctrl + ";
-	if(mods & GLUT_ACTIVE_SHIFT)
-		std::cout << "Shift + ";
-    if (mods & GLUT_ACTIVE_ALT)
-        std::cout << "Alt + ";
+    // Log assíncrono: não trava o loop do GLUT escrevendo no terminal a cada tecla
+    LOG_DEBUG("[Key]", {
+        { "raw", (int)key },
+        { "key", key == 127 ? std::string("Delete [ASCII]") : normalizedKey == ESC ? std::string("ESC") : std::string(1, (char)normalizedKey) },
+        { "ctrl", (mods & GLUT_ACTIVE_CTRL) != 0 },
+        { "shift", (mods & GLUT_ACTIVE_SHIFT) != 0 },
+        { "alt", (mods & GLUT_ACTIVE_ALT) != 0 },
+    });
 
     if (key == 127) {
-        std::cout << "Delete [ASCII]\n";
         canvas.sendScreenInput<cg::io::SpecialKeyInputEvent>(x, y, GLUT_KEY_DELETE, mods);
         return;
     }
 
-	if (normalizedKey == ESC)
-		std::cout << "ESC\n";
-	else
-		std::cout << "Raw{" << (int)key << "}" << normalizedKey << '\n';
-
 	canvas.sendScreenInput<cg::io::KeyboardInputEvent>(x, y, normalizedKey, mods);
 }
 
@@ -266,9 +337,23 @@ int main(int argc, char** argv)
     _saved_attributes = consoleInfo.wAttributes;
 #endif
 
-    // 1. Inicialização do GLUT
+    // 1. Inicialização do GLUT (remove os argumentos do GLUT de argv)
     glutInit(&argc, argv);
 
+    // Opções da aplicação
+    std::string record_path;
+    for (int i = 1; i < argc; ++i) {
+        bool has_value = i + 1 < argc;
+        if (std::strcmp(argv[i], "--record") == 0 && has_value)
+            record_path = argv[++i];
+        else if (std::strcmp(argv[i], "--replay") == 0 && has_value)
+            replayPath = argv[++i];
+        else if (std::strcmp(argv[i], "--report") == 0 && has_value)
+            reportPath = argv[++i];
+        else
+            print_warning("Unknown option '%s'. Usage: %s [--record <file>] [--replay <file> [--report <file>]]", argv[i], argv[0]);
+    }
+
     // modo de exibição: frame buffer, modelo de cor, e antialias ativado
     glutInitDisplayMode(GLUT_DOUBLE | GLUT_RGB | GLUT_MULTISAMPLE);
     // double buffering é necessário para tratamentos visuais dinâmicos
@@ -303,8 +388,22 @@ int main(int argc, char** argv)
     glutDisplayFunc(display);
     glutReshapeFunc(reshape); // Necessário para tratamento da GUI
 
+    if (!replayPath.empty()) {
+        if (!replayer.load(replayPath))
+            return EXIT_FAILURE;
+        canvas.isReplaying = true;
+        replayStart = profiler::Clock::now();
+        glutSetOption(GLUT_ACTION_ON_WINDOW_CLOSE, GLUT_ACTION_GLUTMAINLOOP_RETURNS);
+    }
+    else if (!record_path.empty() && recorder.open(record_path, canvas.getWindowSize())) {
+        canvas.recorder = &recorder;
+    }
+
     glutMainLoop(); // Mostre tudo, e espere
 
+    canvas.recorder = nullptr;
+    recorder.close();
+
     // Destroy o Singleton
     Gui::shutdown();
 
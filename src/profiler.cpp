@@ -0,0 +1,129 @@
+#include "profiler.hpp"
+
+#include <bit>
+#include <cstdio>
+#include <algorithm>
+
+
+namespace profiler {
+
+	std::size_t Histogram::bucketOf(std::uint64_t microseconds)
+	{
+		if (microseconds < LINEAR_BUCKETS)
+			return (std::size_t)microseconds;
+
+		std::size_t exponent = (std::size_t)std::bit_width(microseconds) - 1; // >= 4
+		if (exponent >= MAX_EXPONENT)
+			return BUCKET_COUNT - 1;
+
+		std::size_t sub = (std::size_t)(microseconds >> (exponent - 3)) & (SUB_BUCKETS - 1);
+		return LINEAR_BUCKETS + (exponent - 4) * SUB_BUCKETS + sub;
+	}
+
+	std::uint64_t Histogram::lowerBound(std::size_t bucket)
+	{
+		if (bucket < LINEAR_BUCKETS)
+			return bucket;
+
+		std::size_t exponent = (bucket - LINEAR_BUCKETS) / SUB_BUCKETS + 4;
+		std::size_t sub = (bucket - LINEAR_BUCKETS) % SUB_BUCKETS;
+		return ((std::uint64_t)1 << exponent) + ((std::uint64_t)sub << (exponent - 3));
+	}
+
+	std::uint64_t Histogram::upperBound(std::size_t bucket)
+	{
+		if (bucket + 1 >= BUCKET_COUNT)
+			return UINT64_MAX;
+		return lowerBound(bucket + 1) - 1;
+	}
+
+	void Histogram::record(std::uint64_t microseconds)
+	{
+		++buckets[bucketOf(microseconds)];
+		++total;
+		sum += microseconds;
+		minimum = std::min(minimum, microseconds);
+		maximum = std::max(maximum, microseconds);
+	}
+
+	std::uint64_t Histogram::percentile(double percent) const
+	{
+		if (total == 0)
+			return 0;
+
+		// Posição (1-based) da amostra que corresponde ao percentil
+		double rank = std::clamp(percent, 0.0, 100.0) / 100.0 * (double)total;
+		std::uint64_t target = std::max<std::uint64_t>(1, (std::uint64_t)(rank + 0.5));
+
+		std::uint64_t seen = 0;
+		for (std::size_t i = 0; i < BUCKET_COUNT; ++i) {
+			seen += buckets[i];
+			if (seen >= target)
+				return std::clamp(upperBound(i), min(), maximum);
+		}
+		return maximum;
+	}
+
+	void Histogram::clear()
+	{
+		buckets.fill(0);
+		total = sum = maximum = 0;
+		minimum = UINT64_MAX;
+	}
+
+	void Histogram::writeCsv(std::ostream& os) const
+	{
+		os << "count," << total << '\n'
+			<< "mean_us," << mean() << '\n'
+			<< "min_us," << min() << '\n'
+			<< "p50_us," << percentile(50.0) << '\n'
+			<< "p90_us," << percentile(90.0) << '\n'
+			<< "p99_us," << percentile(99.0) << '\n'
+			<< "max_us," << max() << '\n'
+			<< '\n'
+			<< "lower_us,upper_us,count\n";
+
+		for (std::size_t i = 0; i < BUCKET_COUNT; ++i)
+			if (buckets[i])
+				os << lowerBound(i) << ',' << upperBound(i) << ',' << buckets[i] << '\n';
+	}
+
+
+	void LatencyTracker::markPresented(TimePoint now)
+	{
+		for (TimePoint stamp : pending)
+			histogram.record(now - stamp);
+		pending.clear();
+	}
+
+
+	void writeSummary(std::ostream& os, const char* name, const Histogram& histogram)
+	{
+		char line[160];
+		std::snprintf(line, sizeof(line), "%-10s %8llu %9.3f %9.3f %9.3f %9.3f %9.3f\n", name,
+			(unsigned long long)histogram.count(), histogram.mean() / 1000.0,
+			histogram.percentile(50.0) / 1000.0, histogram.percentile(90.0) / 1000.0,
+			histogram.percentile(99.0) / 1000.0, histogram.max() / 1000.0);
+		os << line;
+	}
+
+	void FrameStats::writeReport(std::ostream& os) const
+	{
+		char header[160];
+		std::snprintf(header, sizeof(header), "%-10s %8s %9s %9s %9s %9s %9s\n",
+			"phase", "count", "mean_ms", "p50_ms", "p90_ms", "p99_ms", "max_ms");
+		os << header;
+		for (int phase = 0; phase < PHASE_COUNT; ++phase)
+			writeSummary(os, PHASE_NAMES[phase], phases[phase]);
+	}
+
+	void JobCounters::writeReport(std::ostream& os) const
+	{
+		char line[160];
+		std::snprintf(line, sizeof(line), "jobs %llu blocks %llu executed %llu stolen %llu helped %llu\n",
+			(unsigned long long)jobs, (unsigned long long)blocks, (unsigned long long)executed,
+			(unsigned long long)stolen, (unsigned long long)helped);
+		os << line;
+	}
+
+} // namespace profiler
@@ -0,0 +1,153 @@
+#pragma once
+/* Ferramentas de medição de desempenho (sem dependência de OpenGL ou da GUI).
+ * - Histogram: histograma log-linear de durações em microssegundos, com percentis.
+ * - LatencyTracker: mede o tempo entre a chegada de um evento de entrada e a troca de buffers
+ *   que primeiro exibe o resultado desse evento ("input-to-photon").
+ * - FrameStats / ScopedTimer: tempo por quadro e por fase do laço principal.
+ * - JobCounters: tarefas e roubos do sistema de jobs (`cg::ThreadPool`).
+ */
+
+#include <array>
+#include <vector>
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+
+
+namespace profiler {
+
+	using Clock = std::chrono::steady_clock;
+	using TimePoint = Clock::time_point;
+
+	/** Histograma log-linear: valores abaixo de 16 µs têm um balde cada; acima disso, cada potência
+	 * de 2 é dividida em 8 baldes (erro relativo máximo de 12.5%). Memória e custo de registro constantes.
+	 */
+	class Histogram {
+	public:
+		static constexpr std::size_t LINEAR_BUCKETS = 16;
+		static constexpr std::size_t SUB_BUCKETS = 8; // por potência de 2
+		static constexpr std::size_t MAX_EXPONENT = 32; // ~71 minutos em µs
+		static constexpr std::size_t BUCKET_COUNT = LINEAR_BUCKETS + (MAX_EXPONENT - 4) * SUB_BUCKETS;
+
+		void record(std::uint64_t microseconds);
+
+		inline void record(Clock::duration duration) {
+			auto us = std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
+			record((std::uint64_t)(us < 0 ? 0 : us));
+		}
+
+		/* Valor (µs) abaixo do qual estão `percent`% das amostras (limite superior do balde). */
+		std::uint64_t percentile(double percent) const;
+
+		inline std::uint64_t count() const { return total; }
+		inline std::uint64_t min() const { return total ? minimum : 0; }
+		inline std::uint64_t max() const { return maximum; }
+		inline double mean() const { return total ? (double)sum / (double)total : 0.0; }
+
+		void clear();
+
+		/* Escreve um resumo e os baldes não vazios em CSV: `lower_us,upper_us,count`. */
+		void writeCsv(std::ostream& os) const;
+
+		static std::size_t bucketOf(std::uint64_t microseconds);
+		static std::uint64_t lowerBound(std::size_t bucket);
+		static std::uint64_t upperBound(std::size_t bucket);
+
+	private:
+		std::array<std::uint64_t, BUCKET_COUNT> buckets{};
+		std::uint64_t total = 0;
+		std::uint64_t sum = 0;
+		std::uint64_t minimum = UINT64_MAX;
+		std::uint64_t maximum = 0;
+	};
+
+
+	/** Acumula os instantes dos eventos despachados no quadro atual; ao apresentar o quadro,
+	 * registra a latência de cada um no histograma.
+	 */
+	class LatencyTracker {
+	public:
+		// Evento que já foi entregue às ferramentas e será refletido na próxima troca de buffers.
+		inline void markInput(TimePoint timestamp) {
+			pending.push_back(timestamp);
+		}
+
+		// Chamado logo após a troca de buffers.
+		void markPresented(TimePoint now = Clock::now());
+
+		inline const Histogram& getHistogram() const { return histogram; }
+
+		inline void clear() {
+			pending.clear();
+			histogram.clear();
+		}
+
+	private:
+		std::vector<TimePoint> pending;
+		Histogram histogram;
+	};
+
+
+	/* Escreve uma linha de resumo: `nome  n  média  p50  p90  p99  máx` (tempos em ms). */
+	void writeSummary(std::ostream& os, const char* name, const Histogram& histogram);
+
+
+	/** Histogramas das fases do laço principal (um quadro = entrada + desenho + GUI + apresentação). */
+	class FrameStats {
+	public:
+		enum Phase {
+			INPUT = 0, // despacho da fila de entrada
+			RENDER, // itens do Canvas e ferramentas
+			GUI, // Dear ImGui
+			PRESENT, // troca de buffers
+			FRAME, // quadro inteiro
+			PHASE_COUNT,
+		};
+		static constexpr const char* PHASE_NAMES[PHASE_COUNT] = { "input", "render", "gui", "present", "frame" };
+
+		inline Histogram& operator[](Phase phase) { return phases[phase]; }
+		inline const Histogram& operator[](Phase phase) const { return phases[phase]; }
+
+		inline std::uint64_t frameCount() const { return phases[FRAME].count(); }
+
+		/* Tabela com uma linha por fase. */
+		void writeReport(std::ostream& os) const;
+
+		inline void clear() {
+			for (Histogram& phase : phases)
+				phase.clear();
+		}
+
+	private:
+		std::array<Histogram, PHASE_COUNT> phases;
+	};
+
+
+	/** Contadores do sistema de jobs, somados entre as filas (ver `cg::ThreadPool::getCounters`). */
+	struct JobCounters {
+		std::uint64_t jobs = 0; // jobs avulsos criados (`spawn`)
+		std::uint64_t blocks = 0; // blocos de `parallelFor` enfileirados
+		std::uint64_t executed = 0; // tarefas executadas (jobs e blocos)
+		std::uint64_t stolen = 0; // executadas por uma thread que não as enfileirou
+		std::uint64_t helped = 0; // executadas por quem esperava (`parallelFor` e `wait`)
+
+		/* Uma linha: `jobs  blocos  executadas  roubadas  ajudadas`. */
+		void writeReport(std::ostream& os) const;
+	};
+
+
+	/* Registra no histograma o tempo de vida do escopo. */
+	class ScopedTimer {
+	public:
+		inline ScopedTimer(Histogram& target) : target{ target }, start{ Clock::now() } {}
+		inline ~ScopedTimer() { target.record(Clock::now() - start); }
+
+		ScopedTimer(const ScopedTimer&) = delete;
+		ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+	private:
+		Histogram& target;
+		TimePoint start;
+	};
+
+} // namespace profiler
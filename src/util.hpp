@@ -10,10 +10,12 @@
 #include <fstream>
 #include <source_location>
 
-#include "api.hpp" // Includes the Open GL API, so you can include just this utilities header.
+#include "logger.hpp" // Mensagens são escritas de forma assíncrona por uma thread de log.
+// Não inclui o OpenGL: para as chamadas GL (e a macro GLdebug) inclua "api.hpp".
 
 
 #if defined(_WIN32) || defined(_WIN64)
+	#include <windows.h>
 	extern HANDLE _hConsole;
 	extern WORD _saved_attributes;
 	#define SET_CLI_RED() SetConsoleTextAttribute(_hConsole, FOREGROUND_RED | FOREGROUND_INTENSITY)
@@ -39,55 +41,23 @@ using ArrayList = std::vector<T>; // alias the data structure by the name of wha
 
 template <typename... Args>
 inline constexpr void print_warning(const char* message, Args...args) {
-	SET_CLI_YELLOW();
-	if constexpr (sizeof...(Args) > 0) {
-		std::fprintf(stderr, message, std::forward<Args>(args)...); // segura, tipada
-	}
-	else {
-		std::fprintf(stderr, "%s", message); // Mensagem formatada
-	}
-	fputc('\n', stderr);
-	RESET_CLI();
+	logging::write<logging::Level::WARN>(message, args...);
 }
 
 template <typename... Args>
 inline constexpr void print_error(const char* message, Args...args) {
-	SET_CLI_RED();
-	if constexpr (sizeof...(Args) > 0) {
-		std::fprintf(stderr, message, std::forward<Args>(args)...); // segura, tipada
-	}
-	else {
-		std::fprintf(stderr, "%s", message); // Mensagem formatada
-	}
-	fputc('\n', stderr);
-	RESET_CLI();
+	logging::write<logging::Level::ERR>(message, args...);
 }
 
 template <typename... Args>
 inline constexpr void print_success(const char* message, Args...args) {
-	SET_CLI_GREEN();
-	if constexpr (sizeof...(Args) > 0) {
-		std::fprintf(stderr, message, std::forward<Args>(args)...); // segura, tipada
-	}
-	else {
-		std::fprintf(stderr, "%s", message); // Mensagem formatada
-	}
-	fputc('\n', stderr);
-	RESET_CLI();
+	logging::write<logging::Level::SUCCESS>(message, args...);
 }
 
 
 template <typename... Args>
 inline constexpr void print_info(const char* message, Args...args) {
-	SET_CLI_BLUE();
-	if constexpr (sizeof...(Args) > 0) {
-		std::fprintf(stderr, message, std::forward<Args>(args)...); // segura, tipada
-	}
-	else {
-		std::fprintf(stderr, "%s", message); // Mensagem formatada
-	}
-	fputc('\n', stderr);
-	RESET_CLI();
+	logging::write<logging::Level::INFO>(message, args...);
 }
 
 #ifdef _MSC_VER
@@ -116,65 +86,37 @@ inline void print_location_tag(const char* tag,
 		tag, location.file_name(), location.line(), location.function_name());
 }
 
+// Enfileira uma única mensagem no log, prefixada pela localização no código: `[tag] arquivo:linha (função): mensagem`.
+template<logging::Level L, typename... Args>
+inline void print_located(const char* tag, const std::source_location& location, const char* message, Args... args) {
+	if constexpr (logging::enabled<L>) {
+		constexpr std::size_t size = logging::RECORD_TEXT_SIZE;
+		char buffer[size];
+		int written = std::snprintf(buffer, size, "[%s] %s:%d (%s): ",
+			tag, location.file_name(), (int)location.line(), location.function_name());
+		if (written < 0)
+			return;
+		std::size_t length = std::min((std::size_t)written, size - 1);
 
-/* Clear Open GL Error codes stack. */
-inline void GLClearError()
-{
-	while (glGetError() != GL_NO_ERROR);
-}
-
-
-/* Logs every Open GL error code accumulated. */
-inline bool GLLogCall(const std::source_location location = std::source_location::current())
-{
-	bool out = true;
-	while (GLenum error = glGetError()) {
-		SET_CLI_RED();
-
-		print_location_tag("OpenGL Error", location);
-		fprintf(stderr, "Error Code: %d\n", error);
+		if constexpr (sizeof...(Args) > 0)
+			written = std::snprintf(buffer + length, size - length, message, args...); // segura, tipada
+		else
+			written = std::snprintf(buffer + length, size - length, "%s", message);
+		if (written > 0)
+			length = std::min(length + (std::size_t)written, size - 1);
 
-		RESET_CLI();
-		out = false;
+		logging::push(L, buffer, length);
 	}
-	return out;
 }
 
 
 #ifdef _DEBUG
 	constexpr bool IS_DEBUG = true;
 
-	class GLDebugScope {
-	public:
-		GLDebugScope(const std::source_location loc = std::source_location::current())
-			: location(loc) {
-			GLClearError();
-		}
-		~GLDebugScope() {
-			GLLogCall(location);
-		}
-
-		operator bool() { return true; }
-
-	private:
-		std::source_location location;
-	};
-
-	/* Macro de Debug para chamadas OpenGL */
-	#define GLdebug() if (GLDebugScope _gl_debug_scope = GLDebugScope())
-	// Usa o escopo temporário para realizar as chamadas no construtor/destrutor com RAII
-
-	// Prefira a versão escopada acima
-	//#define GLCall(GL) GLClearError(); GL; GLLogCall()
-
 	#define print_var(VAR, ...) std::cerr << #VAR ##__VA_ARGS__ ": " << (VAR) << '\n'
 #else
 	constexpr bool IS_DEBUG = false; // Is debugger available?
 
-	// Macro de Debug para chamadas OpenGL
-	#define GLdebug() if (false); else
-	//#define GLCall(GL) GL
-
 	#define print_var(VAR, ...) std::cerr << #VAR ##__VA_ARGS__ ": " << (VAR) << '\n'
 #endif // _DEBUG
 
@@ -185,17 +127,7 @@ void warn(const char* message, Args... args,
 	const std::source_location location = std::source_location::current()
 ) {
 	if constexpr (IS_DEBUG) {
-		SET_CLI_YELLOW();
-
-		print_location_tag("Warning", location);
-		if constexpr (sizeof...(Args) > 0) {
-			std::fprintf(stderr, message, std::forward<Args>(args)...); // segura, tipada
-		}
-		else {
-			std::fprintf(stderr, "%s", message); // Mensagem formatada
-		}
-
-		RESET_CLI();
+		print_located<logging::Level::WARN>("Warning", location, message, args...);
 	}
 }
 
@@ -218,17 +150,7 @@ void err(const char* message, Args... args,
 	const std::source_location location = std::source_location::current()
 ) {
 	if constexpr (IS_DEBUG) {
-		SET_CLI_YELLOW();
-
-		print_location_tag("Error", location);
-		if constexpr (sizeof...(Args) > 0) {
-			std::fprintf(stderr, message, std::forward<Args>(args)...); // segura, tipada
-		}
-		else {
-			std::fprintf(stderr, "%s", message); // Mensagem formatada
-		}
-
-		RESET_CLI();
+		print_located<logging::Level::ERR>("Error", location, message, args...);
 	}
 }
 
@@ -250,17 +172,7 @@ void suc(const char* message, Args... args,
 	const std::source_location location = std::source_location::current()
 ) {
 	if constexpr (IS_DEBUG) {
-		SET_CLI_YELLOW();
-
-		print_location_tag("Success", location);
-		if constexpr (sizeof...(Args) > 0) {
-			std::fprintf(stderr, message, std::forward<Args>(args)...); // segura, tipada
-		}
-		else {
-			std::fprintf(stderr, "%s", message); // Mensagem formatada
-		}
-
-		RESET_CLI();
+		print_located<logging::Level::SUCCESS>("Success", location, message, args...);
 	}
 }
 
@@ -285,6 +197,7 @@ inline constexpr void _assert_err(bool condition,
 ) {
 	if constexpr (IS_DEBUG) {
 		if (!condition) {
+			logging::flush(); // mensagens pendentes saem antes da asserção
 			SET_CLI_YELLOW();
 
 			print_location_tag("Assertion", location);
@@ -0,0 +1,349 @@
+/* Medição de desempenho do núcleo (cgcore) sem janela nem contexto OpenGL.
+ * Carrega uma cena .cgp, desenha quadros pelo backend nulo (de gravação, ou rasterizando em CPU), faz consultas de seleção
+ * e reproduz gravações de entrada (`--record` da aplicação), imprimindo os mesmos histogramas por fase.
+ *
+ * Uso: cgbench [opções]
+ *   --scene arquivo.cgp    cena carregada antes das medições (tempo de carga incluído no relatório)
+ *   --frames N             quadros desenhados (padrão 100)
+ *   --backend null|record|software
+ *                          destino do desenho: só contagem, cópia dos comandos ou rasterização em CPU (padrão null)
+ *   --threads N            threads do rasterizador em CPU (padrão: as do pool compartilhado, uma por núcleo)
+ *   --picks N              consultas `Canvas::pick` em posições aleatórias (padrão 0)
+ *   --seed S               semente das posições de seleção (padrão 1)
+ *   --replay arquivo       reproduz a entrada gravada, um quadro gravado por quadro desenhado
+ *   --size LxA             tamanho da janela simulada (padrão 600x420)
+ *   --view X,Y,Z           centro da câmera no mundo e zoom (padrão 0,0,1)
+ *   --pan DX,DY            arrasto da câmera por quadro, em pixels de tela (padrão 0,0)
+ *   --tiles 0|1            cache de blocos do conteúdo estático (padrão 0)
+ *   --layer 0|1            camada estática: tudo menos o item selecionado numa imagem (padrão 0)
+ *   --drag DX,DY           seleciona o item no centro da vista (ou o mais acima) e o move por quadro, em unidades do mundo
+ *   --report arquivo       escreve o relatório em arquivo (padrão: saída padrão)
+ *   --tessellate N         só tessela uma estrela côncava de N vértices e falha se a saída não for linear
+ */
+
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+#include <cstdlib>
+#include <string>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <cmath>
+
+#include <cg/canvas.hpp>
+#include <cg/geometry.hpp>
+#include <cg/render_backend.hpp>
+#include <cg/software_backend.hpp>
+#include <cg/thread_pool.hpp>
+#include <cg/input_record.hpp>
+#include <cg/tools/select_tool.hpp>
+#include <profiler.hpp>
+
+using namespace cg;
+
+
+namespace {
+
+	struct Options {
+		std::string scene;
+		std::uint64_t frames = 100;
+		enum Backend { NULL_BACKEND, RECORD, SOFTWARE } backend = NULL_BACKEND;
+		unsigned threads = 0;
+		std::uint64_t picks = 0;
+		std::uint32_t seed = 1;
+		std::string replay;
+		Vector2 size{ 600.0f, 420.0f };
+		Vector2 viewCenter{};
+		float viewZoom = 1.0f;
+		Vector2 pan{};
+		bool tiles = false;
+		bool layer = false;
+		Vector2 drag{};
+		std::string report;
+		std::size_t tessellate = 0;
+	};
+
+	void printUsage(const char* program) {
+		std::fprintf(stderr,
+			"Usage: %s [--scene file.cgp] [--frames N] [--backend null|record|software] [--threads N]\n"
+			"          [--picks N] [--seed S]"
+			" [--replay file] [--size WxH] [--view X,Y,Z] [--pan DX,DY] [--tiles 0|1]\n"
+			"          [--layer 0|1] [--drag DX,DY] [--report file] [--tessellate N]\n",
+			program);
+	}
+
+	bool parseOptions(int argc, char** argv, Options& options) {
+		for (int i = 1; i < argc; ++i) {
+			const char* arg = argv[i];
+			if (i + 1 >= argc) {
+				print_error("Missing value for option '%s'", arg);
+				return false;
+			}
+			const char* value = argv[++i];
+
+			if (std::strcmp(arg, "--scene") == 0)
+				options.scene = value;
+			else if (std::strcmp(arg, "--frames") == 0)
+				options.frames = std::strtoull(value, nullptr, 10);
+			else if (std::strcmp(arg, "--backend") == 0) {
+				if (std::strcmp(value, "null") == 0)
+					options.backend = Options::NULL_BACKEND;
+				else if (std::strcmp(value, "record") == 0)
+					options.backend = Options::RECORD;
+				else if (std::strcmp(value, "software") == 0)
+					options.backend = Options::SOFTWARE;
+				else {
+					print_error("Unknown backend '%s' (expected null, record or software)", value);
+					return false;
+				}
+			}
+			else if (std::strcmp(arg, "--threads") == 0)
+				options.threads = (unsigned)std::strtoul(value, nullptr, 10);
+			else if (std::strcmp(arg, "--picks") == 0)
+				options.picks = std::strtoull(value, nullptr, 10);
+			else if (std::strcmp(arg, "--seed") == 0)
+				options.seed = (std::uint32_t)std::strtoul(value, nullptr, 10);
+			else if (std::strcmp(arg, "--replay") == 0)
+				options.replay = value;
+			else if (std::strcmp(arg, "--size") == 0) {
+				int width = 0, height = 0;
+				if (std::sscanf(value, "%dx%d", &width, &height) != 2 || width <= 0 || height <= 0) {
+					print_error("Invalid size '%s' (expected WxH)", value);
+					return false;
+				}
+				options.size = { (float)width, (float)height };
+			}
+			else if (std::strcmp(arg, "--view") == 0) {
+				if (std::sscanf(value, "%f,%f,%f", &options.viewCenter.x, &options.viewCenter.y, &options.viewZoom) != 3
+						|| !(options.viewZoom > 0.0f)) {
+					print_error("Invalid view '%s' (expected X,Y,ZOOM)", value);
+					return false;
+				}
+			}
+			else if (std::strcmp(arg, "--pan") == 0) {
+				if (std::sscanf(value, "%f,%f", &options.pan.x, &options.pan.y) != 2) {
+					print_error("Invalid pan '%s' (expected DX,DY)", value);
+					return false;
+				}
+			}
+			else if (std::strcmp(arg, "--tiles") == 0)
+				options.tiles = std::strcmp(value, "0") != 0;
+			else if (std::strcmp(arg, "--layer") == 0)
+				options.layer = std::strcmp(value, "0") != 0;
+			else if (std::strcmp(arg, "--drag") == 0) {
+				if (std::sscanf(value, "%f,%f", &options.drag.x, &options.drag.y) != 2) {
+					print_error("Invalid drag '%s' (expected DX,DY)", value);
+					return false;
+				}
+			}
+			else if (std::strcmp(arg, "--report") == 0)
+				options.report = value;
+			else if (std::strcmp(arg, "--tessellate") == 0)
+				options.tessellate = std::strtoull(value, nullptr, 10);
+			else {
+				print_error("Unknown option '%s'", arg);
+				return false;
+			}
+		}
+		return true;
+	}
+
+	double elapsedMs(profiler::TimePoint since) {
+		return std::chrono::duration<double, std::milli>(profiler::Clock::now() - since).count();
+	}
+
+	/* Regressão da tesselagem: uma estrela côncava (raios alternados) não tem cruzamentos, então a saída
+	 * deve ser linear nos vértices (a antiga, por faixas entre todos os vértices, era quadrática). */
+	bool checkTessellation(std::ostream& os, std::size_t count) {
+		std::vector<Vector2> contour(std::max<std::size_t>(count, 4) & ~std::size_t{ 1 });
+		for (std::size_t i = 0; i < contour.size(); ++i) {
+			const float angle = 6.28318531f * (float)i / (float)contour.size();
+			const float radius = i % 2 ? 40.0f : 100.0f;
+			contour[i] = Vector2{ std::cos(angle), std::sin(angle) } * radius;
+		}
+
+		std::vector<Vector2> triangles;
+		auto start = profiler::Clock::now();
+		tessellate(contour, triangles);
+		const double ms = elapsedMs(start);
+
+		const std::size_t limit = 3 * contour.size(); // cerca de um trapézio (dois triângulos) por vértice, com folga
+		const std::size_t produced = triangles.size() / 3;
+		os << "tessellate " << contour.size() << " vertices: " << produced << " triangles (limit " << limit
+			<< ") in " << ms << " ms\n";
+		if (produced > limit) {
+			print_error("Tessellation is not linear: %zu triangles for %zu vertices", produced, contour.size());
+			return false;
+		}
+		return true;
+	}
+
+} // namespace
+
+
+int main(int argc, char** argv)
+{
+	Options options;
+	if (!parseOptions(argc, argv, options)) {
+		printUsage(argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	std::ofstream file;
+	if (!options.report.empty()) {
+		file.open(options.report);
+		if (!file.is_open()) {
+			print_error("Failed to open report file: %s", options.report.c_str());
+			return EXIT_FAILURE;
+		}
+	}
+	std::ostream& os = file.is_open() ? (std::ostream&)file : std::cout;
+
+	if (options.tessellate > 0)
+		return checkTessellation(os, options.tessellate) ? EXIT_SUCCESS : EXIT_FAILURE;
+
+	static Canvas canvas{ options.size };
+
+	NullBackend nullBackend;
+	RecordingBackend recordingBackend;
+	SoftwareBackend softwareBackend{ (int)options.size.x, (int)options.size.y, options.threads };
+	RenderBackend* backends[] = { &nullBackend, &recordingBackend, &softwareBackend };
+	ScopedBackend scope{ *backends[options.backend] };
+
+	// Mesma cor de fundo da aplicação (`glClearColor` em main.cpp)
+	const Color background{ 0.1333f, 0.1333f, 0.1333f, 0.0f };
+
+	if (!options.scene.empty()) {
+		auto start = profiler::Clock::now();
+		std::ifstream ifs(options.scene);
+		if (!ifs.is_open()) {
+			print_error("Failed to open scene: %s", options.scene.c_str());
+			return EXIT_FAILURE;
+		}
+		if (!canvas.load(ifs))
+			return EXIT_FAILURE;
+
+		os << "scene " << options.scene << " load_ms " << elapsedMs(start)
+			<< " items " << canvas.getItens().size()
+			<< " points " << canvas.getTypeCount(CanvasItem::TypeInfo::POINT)
+			<< " lines " << canvas.getTypeCount(CanvasItem::TypeInfo::LINE)
+			<< " polygons " << canvas.getTypeCount(CanvasItem::TypeInfo::POLYGON) << "\n\n";
+	}
+
+	canvas.setView(options.viewCenter, options.viewZoom);
+	{
+		auto start = profiler::Clock::now();
+		canvas.waitOverview();
+		os << "index_ms " << elapsedMs(start) << " (spatial grid + overview pyramid)\n\n";
+	}
+	canvas.setTileCacheEnabled(options.tiles); // a cena carregada já entra nos blocos
+	canvas.setStaticLayerEnabled(options.layer);
+
+	SelectTool& selector = canvas.toolBox.getSelectorTool();
+	const bool isDragging = options.drag.x != 0.0f || options.drag.y != 0.0f;
+	if (isDragging) {
+		CanvasItem* item = canvas.pick(canvas.screenToWorld(options.size / 2.0f));
+		if (item == nullptr && !canvas.getItens().empty())
+			item = canvas.getItens().rbegin()->get();
+		if (item != nullptr)
+			selector.select(item);
+	}
+
+	using Phase = profiler::FrameStats::Phase;
+	profiler::FrameStats frameStats;
+	ThreadPool::shared().resetCounters(); // só os jobs dos quadros
+
+	// Um quadro da aplicação, sem GUI nem troca de buffers.
+	auto frame = [&]() {
+		profiler::ScopedTimer frame_timer{ frameStats[Phase::FRAME] };
+		{
+			profiler::ScopedTimer timer{ frameStats[Phase::INPUT] };
+			canvas.dispatchInput();
+			if (options.pan.x != 0.0f || options.pan.y != 0.0f)
+				canvas.panView(options.pan);
+			if (isDragging)
+				selector.translate(options.drag);
+		}
+		{
+			profiler::ScopedTimer timer{ frameStats[Phase::RENDER] };
+			recordingBackend.clear();
+			softwareBackend.clear(background);
+			canvas.updateRender();
+		}
+		if (options.backend == Options::SOFTWARE) {
+			profiler::ScopedTimer timer{ frameStats[Phase::PRESENT] }; // rasterização
+			softwareBackend.flush();
+		}
+	};
+
+	if (!options.replay.empty()) {
+		InputReplayer replayer;
+		if (!replayer.load(options.replay))
+			return EXIT_FAILURE;
+
+		canvas.isReplaying = true;
+		auto start = profiler::Clock::now();
+		auto resize = [&softwareBackend](int width, int height) {
+			canvas.setWindowSize(width, height);
+			softwareBackend.resize(width, height);
+		};
+		while (replayer.feed(canvas, resize) || !canvas.input.empty())
+			frame();
+		canvas.isReplaying = false;
+
+		os << "replay " << options.replay << '\n'
+			<< "frames " << replayer.getFrameCount() << " wall_ms " << elapsedMs(start)
+			<< " recorded_ms " << replayer.getRecordedDuration() << "\n\n";
+	}
+	else {
+		auto start = profiler::Clock::now();
+		for (std::uint64_t i = 0; i < options.frames; ++i)
+			frame();
+		os << "frames " << options.frames << " wall_ms " << elapsedMs(start) << "\n\n";
+	}
+
+	frameStats.writeReport(os);
+	ThreadPool::shared().getCounters().writeReport(os);
+
+	os << "visible: " << canvas.getVisibleCount() << " / " << canvas.getItens().size() << " items";
+	if (canvas.getAggregateCount() > 0)
+		os << ", " << canvas.getAggregateCount() << " overview nodes";
+	os << '\n';
+	if (options.tiles)
+		os << "tiles: " << canvas.getTileCount() << " cached, " << canvas.getLiveCount() << " live items\n";
+
+	if (options.backend == Options::RECORD)
+		os << "last frame: " << recordingBackend.commands.size() << " commands, "
+			<< recordingBackend.vertices.size() << " vertices\n";
+	else if (options.backend == Options::SOFTWARE)
+		os << "last frame: " << softwareBackend.getTriangleCount() << " triangles rasterized at "
+			<< softwareBackend.getWidth() << 'x' << softwareBackend.getHeight() << "\n";
+	else
+		os << "submitted: " << nullBackend.drawCalls << " draw calls, "
+			<< nullBackend.vertexCount << " vertices, " << nullBackend.imageCount << " images\n";
+
+	if (options.picks > 0) {
+		std::mt19937 engine{ options.seed };
+		Vector2 upperLeft = canvas.getUpperLeft(), bottomRight = canvas.getBottomRight();
+		auto unit = [&engine]() { return (float)(engine() >> 8) * (1.0f / 16777216.0f); };
+
+		profiler::Histogram picks;
+		std::uint64_t hits = 0;
+		for (std::uint64_t i = 0; i < options.picks; ++i) {
+			Vector2 position{
+				upperLeft.x + (bottomRight.x - upperLeft.x) * unit(),
+				upperLeft.y + (bottomRight.y - upperLeft.y) * unit(),
+			};
+			profiler::ScopedTimer timer{ picks };
+			if (canvas.pick(position) != nullptr)
+				++hits;
+		}
+		os << '\n';
+		profiler::writeSummary(os, "pick", picks);
+		os << "pick hits " << hits << " / " << options.picks << '\n';
+	}
+
+	os.flush();
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,141 @@
+/* Exporta uma cena .cgp como imagem (PNG ou PPM) de qualquer tamanho, sem janela nem contexto OpenGL.
+ * A imagem é rasterizada em CPU e gravada em faixas, então a memória não cresce com a resolução.
+ *
+ * Uso: cgexport --scene arquivo.cgp -o imagem.png [opções]
+ *   --scene arquivo.cgp    cena exportada
+ *   -o arquivo             imagem de saída; o formato vem da extensão (.ppm, senão PNG)
+ *   --window LxA           tamanho da janela cuja área visível é exportada (padrão 600x420)
+ *   --size LxA             tamanho da imagem (padrão: o da janela multiplicado por --scale)
+ *   --scale S              ampliação da janela quando --size não é dado (padrão 1)
+ *   --strip N              linhas rasterizadas por vez (padrão 256)
+ *   --threads N            threads de rasterização (padrão: uma por núcleo)
+ */
+
+#include <cstdio>
+#include <cstring>
+#include <cstdlib>
+#include <string>
+#include <fstream>
+#include <chrono>
+
+#include <cg/canvas.hpp>
+#include <cg/image_export.hpp>
+
+using namespace cg;
+
+
+namespace {
+
+	struct Options {
+		std::string scene;
+		std::string output;
+		Vector2 window{ 600.0f, 420.0f };
+		int width = 0, height = 0;
+		float scale = 1.0f;
+		int strip = 256;
+		unsigned threads = 0;
+	};
+
+	void printUsage(const char* program) {
+		std::fprintf(stderr,
+			"Usage: %s --scene file.cgp -o image.png|image.ppm [--window WxH] [--size WxH] [--scale S]\n"
+			"          [--strip N] [--threads N]\n",
+			program);
+	}
+
+	bool parseSize(const char* value, int& width, int& height) {
+		if (std::sscanf(value, "%dx%d", &width, &height) != 2 || width <= 0 || height <= 0) {
+			print_error("Invalid size '%s' (expected WxH)", value);
+			return false;
+		}
+		return true;
+	}
+
+	bool parseOptions(int argc, char** argv, Options& options) {
+		for (int i = 1; i < argc; ++i) {
+			const char* arg = argv[i];
+			if (i + 1 >= argc) {
+				print_error("Missing value for option '%s'", arg);
+				return false;
+			}
+			const char* value = argv[++i];
+
+			if (std::strcmp(arg, "--scene") == 0)
+				options.scene = value;
+			else if (std::strcmp(arg, "-o") == 0)
+				options.output = value;
+			else if (std::strcmp(arg, "--window") == 0) {
+				int width, height;
+				if (!parseSize(value, width, height))
+					return false;
+				options.window = { (float)width, (float)height };
+			}
+			else if (std::strcmp(arg, "--size") == 0) {
+				if (!parseSize(value, options.width, options.height))
+					return false;
+			}
+			else if (std::strcmp(arg, "--scale") == 0)
+				options.scale = std::strtof(value, nullptr);
+			else if (std::strcmp(arg, "--strip") == 0)
+				options.strip = std::atoi(value);
+			else if (std::strcmp(arg, "--threads") == 0)
+				options.threads = (unsigned)std::strtoul(value, nullptr, 10);
+			else {
+				print_error("Unknown option '%s'", arg);
+				return false;
+			}
+		}
+		if (options.scene.empty() || options.output.empty()) {
+			print_error("Both --scene and -o are required");
+			return false;
+		}
+		if (!(options.scale > 0.0f)) {
+			print_error("Invalid scale (expected a positive number)");
+			return false;
+		}
+		return true;
+	}
+
+} // namespace
+
+
+int main(int argc, char** argv)
+{
+	Options options;
+	if (!parseOptions(argc, argv, options)) {
+		printUsage(argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	static Canvas canvas{ options.window };
+	{
+		std::ifstream ifs(options.scene);
+		if (!ifs.is_open()) {
+			print_error("Failed to open scene: %s", options.scene.c_str());
+			return EXIT_FAILURE;
+		}
+		if (!canvas.load(ifs))
+			return EXIT_FAILURE;
+	}
+
+	ImageExportOptions export_options;
+	export_options.width = options.width ? options.width : (int)(options.window.x * options.scale);
+	export_options.height = options.height ? options.height : (int)(options.window.y * options.scale);
+	export_options.format = imageFormatFromPath(options.output);
+	export_options.stripHeight = options.strip;
+	export_options.threads = options.threads;
+
+	std::ofstream ofs(options.output, std::ios::binary);
+	if (!ofs.is_open()) {
+		print_error("Failed to open output: %s", options.output.c_str());
+		return EXIT_FAILURE;
+	}
+
+	auto start = std::chrono::steady_clock::now();
+	if (!exportImage(canvas, ofs, export_options))
+		return EXIT_FAILURE;
+
+	std::printf("%s: %dx%d in %.1f ms\n", options.output.c_str(), export_options.width, export_options.height,
+		std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+	return EXIT_SUCCESS;
+}
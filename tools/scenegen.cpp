@@ -0,0 +1,389 @@
+/* Gerador de cenas sintéticas para medir carga, desenho e seleção do Canvas.
+ * Escreve um arquivo .cgp (mesmo formato texto de `ToolBox::save`) com pontos, linhas e polígonos.
+ *
+ * Uso: scenegen [opções] [-o arquivo.cgp]
+ *   --preset 10k|100k|1m   quantidade de itens padronizada (mesmos valores das demais opções)
+ *   --count N              quantidade de itens (padrão 10000)
+ *   --seed S               semente (padrão 1); a mesma semente gera o mesmo arquivo, em qualquer compilador
+ *   --points W --lines W --polygons W
+ *                          pesos da distribuição de tipos (padrão 1 1 1)
+ *   --convex W --concave W --complex W
+ *                          pesos dos tipos de polígono (padrão 1 1 1); complex = auto-interseção
+ *   --min-vertices N --max-vertices N
+ *                          faixa de vértices por linha/polígono, log-uniforme (2 .. 1000000, padrão 2 .. 64)
+ *   --transforms P         probabilidade [0, 1] de um item receber rotação, escala, cisalhamento e espelhamento
+ *   --extent E             meia largura da área ocupada, em coordenadas de mundo (padrão 400)
+ */
+
+#include <cmath>
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <random>
+#include <numeric>
+#include <bit>
+#include <algorithm>
+
+#include <cg/math.hpp>
+
+using namespace cg;
+
+
+namespace {
+
+	struct Options {
+		std::uint64_t count = 10'000;
+		std::uint32_t seed = 1;
+		double points = 1.0, lines = 1.0, polygons = 1.0;
+		double convex = 1.0, concave = 1.0, complex = 1.0;
+		std::uint32_t minVertices = 2, maxVertices = 64;
+		double transforms = 0.5;
+		float extent = 400.0f;
+		std::string output = "scene.cgp";
+	};
+
+	constexpr std::uint32_t MAX_VERTICES = 1'000'000;
+
+	/** Gerador reprodutível entre compiladores: o `std::mt19937` é padronizado, mas as distribuições
+	 * da biblioteca padrão não são, então os valores são derivados manualmente dos bits brutos.
+	 * Também não usa a libm (exp, log, sin, cos não são arredondados corretamente e variam entre
+	 * bibliotecas): só as operações básicas e a raiz quadrada, exatas pelo IEEE 754.
+	 */
+	class Random {
+	public:
+		explicit Random(std::uint32_t seed) : engine{ seed } {}
+
+		// [0, 1) com 24 bits de mantissa
+		inline float unit() {
+			return (float)(engine() >> 8) * (1.0f / 16777216.0f);
+		}
+
+		inline float range(float min, float max) {
+			return min + (max - min) * unit();
+		}
+
+		// [0, n)
+		inline std::uint32_t below(std::uint32_t n) {
+			return (std::uint32_t)(((std::uint64_t)engine() * n) >> 32);
+		}
+
+		inline bool chance(double probability) {
+			return unit() < (float)probability;
+		}
+
+		// Distribuição log-uniforme em [min, max], por oitavas: muitos itens pequenos e alguns muito grandes.
+		// Sorteia a quantidade de bits e depois o valor dentro da oitava (descartando o que sai da faixa).
+		inline std::uint32_t logUniform(std::uint32_t min, std::uint32_t max) {
+			const int low = std::bit_width(min), high = std::bit_width(max);
+			while (true) {
+				const int bits = low + (int)below((std::uint32_t)(high - low + 1));
+				const std::uint32_t first = bits > 0 ? std::uint32_t{ 1 } << (bits - 1) : 0;
+				const std::uint32_t value = first + (bits > 1 ? below(first) : 0);
+				if (value >= min && value <= max)
+					return value;
+			}
+		}
+
+		// Escolhe um índice com probabilidade proporcional ao peso.
+		template <std::size_t N>
+		inline std::size_t pick(const double (&weights)[N]) {
+			double total = 0.0;
+			for (double w : weights)
+				total += w;
+			double r = unit() * total;
+			for (std::size_t i = 0; i < N; ++i) {
+				if (r < weights[i])
+					return i;
+				r -= weights[i];
+			}
+			return N - 1;
+		}
+
+	private:
+		std::mt19937 engine;
+	};
+
+
+	/** Vetor unitário (cos, sin) do ângulo, sem a libm: redução ao quadrante (Cody–Waite) e séries de Taylor
+	 * em [-π/4, π/4] em double, com erro bem abaixo da precisão de float.
+	 */
+	Vector2 unitVector(double angle) {
+		constexpr double PI_2_HI = 1.57079632673412561417e+00; // π/2 em duas partes: a de cima é exata vezes q
+		constexpr double PI_2_LO = 6.07710050650619224932e-11;
+		const double q = std::nearbyint(angle * (2.0 / 3.14159265358979323846));
+		const double r = (angle - q * PI_2_HI) - q * PI_2_LO;
+		const double r2 = r * r;
+
+		double sine = 0.0, cosine = 0.0, sineTerm = r, cosineTerm = 1.0;
+		for (int k = 1; k <= 9; ++k) {
+			sine += sineTerm;
+			cosine += cosineTerm;
+			sineTerm *= -r2 / (double)((2 * k) * (2 * k + 1));
+			cosineTerm *= -r2 / (double)((2 * k - 1) * (2 * k));
+		}
+
+		switch ((std::int64_t)q & 3) {
+		case 0:
+			return { (float)cosine, (float)sine };
+		case 1:
+			return { (float)-sine, (float)cosine };
+		case 2:
+			return { (float)-cosine, (float)-sine };
+		default:
+			return { (float)sine, (float)-cosine };
+		}
+	}
+
+	Color randomColor(Random& random) {
+		return { random.unit(), random.unit(), random.unit(), 1.0f };
+	}
+
+	// Raio local que mantém a densidade visual parecida para qualquer quantidade de vértices.
+	float radiusFor(Random& random, std::uint32_t vertices, float extent) {
+		float base = random.range(4.0f, 40.0f);
+		return std::min(base * std::sqrt((float)vertices / 8.0f + 1.0f), extent);
+	}
+
+	// Posição + (opcionalmente) rotação, escala não uniforme, cisalhamento e espelhamento.
+	Transform2D randomModel(Random& random, const Options& options) {
+		Transform2D model{ Vector2{ random.range(-options.extent, options.extent), random.range(-options.extent, options.extent) } };
+		if (!random.chance(options.transforms))
+			return model;
+
+		const Vector2 axis = unitVector(random.range(-PI<float>, PI<float>)); // `rotate` usaria a libm
+		model *= Transform2D{ axis, Vector2{ -axis.y, axis.x } };
+		model.shear(random.range(-0.5f, 0.5f), random.range(-0.5f, 0.5f));
+		model.scale({ random.range(0.25f, 2.0f), random.range(0.25f, 2.0f) });
+		switch (random.below(4)) {
+		case 0:
+			model.mirror(Transform2D::MIRROR_X<float>);
+			break;
+		case 1:
+			model.mirror(Transform2D::MIRROR_Y<float>);
+			break;
+		case 2:
+			model.mirror(Transform2D::MIRROR_ORIGIN<float>);
+			break;
+		default: // sem espelhamento
+			break;
+		}
+		return model;
+	}
+
+	void writeVertices(std::ostream& os, const ArrayList<Vector2>& vertices) {
+		os << "vertices[ ";
+		for (std::size_t i = 0; i < vertices.size(); ++i) {
+			if (i)
+				os << ' ';
+			os << vertices[i];
+		}
+		os << " ]";
+	}
+
+	void writePoint(std::ostream& os, Random& random, const Options& options) {
+		Transform2D model = randomModel(random, options);
+		float size = random.range(1.0f, 12.0f);
+		os << "Point " << model << " at: " << model.getOrigin() << " size: " << size << " color: " << randomColor(random) << '\n';
+	}
+
+	// Caminhada aleatória com passo proporcional ao raio.
+	void writeLine(std::ostream& os, Random& random, const Options& options, ArrayList<Vector2>& vertices) {
+		std::uint32_t n = random.logUniform(options.minVertices, options.maxVertices);
+		float step = radiusFor(random, n, options.extent) / std::sqrt((float)n);
+		Vector2 cursor{};
+		Angle heading = random.range(-PI<float>, PI<float>);
+
+		vertices.clear();
+		vertices.reserve(n);
+		for (std::uint32_t i = 0; i < n; ++i) {
+			vertices.push_back(cursor);
+			heading += random.range(-0.8f, 0.8f);
+			cursor = cursor + unitVector(heading) * (step * random.range(0.5f, 1.5f));
+		}
+
+		Transform2D model = randomModel(random, options);
+		os << "Line " << model << " width: " << random.range(1.0f, 6.0f) << " color: " << randomColor(random) << ' ';
+		writeVertices(os, vertices);
+		os << '\n';
+	}
+
+	enum PolygonKind { CONVEX = 0, CONCAVE, COMPLEX };
+
+	void writePolygon(std::ostream& os, Random& random, const Options& options, ArrayList<Vector2>& vertices) {
+		const double kinds[] = { options.convex, options.concave, options.complex };
+		auto kind = (PolygonKind)random.pick(kinds);
+		std::uint32_t n = std::max<std::uint32_t>(random.logUniform(options.minVertices, options.maxVertices), 3);
+		if (kind == COMPLEX)
+			n = std::max<std::uint32_t>(n, 5); // menor polígono estrelado: pentagrama
+		float radius = radiusFor(random, n, options.extent);
+
+		vertices.clear();
+		vertices.reserve(n);
+		switch (kind) {
+		case CONVEX: {
+			// Ângulos crescentes num círculo: sempre convexo
+			std::vector<float> angles(n);
+			for (float& angle : angles)
+				angle = random.range(0.0f, TAU<float>);
+			std::sort(angles.begin(), angles.end());
+			for (float angle : angles)
+				vertices.push_back(unitVector(angle) * radius);
+		} break;
+		case CONCAVE: {
+			// Estrela: raios alternados em torno de ângulos regulares
+			for (std::uint32_t i = 0; i < n; ++i) {
+				float angle = TAU<float> * (float)i / (float)n;
+				float r = (i % 2 ? random.range(0.2f, 0.6f) : random.range(0.8f, 1.0f)) * radius;
+				vertices.push_back(unitVector(angle) * r);
+			}
+		} break;
+		case COMPLEX: {
+			// Polígono estrelado {n/k} (k coprimo com n) com ruído: arestas se cruzam
+			std::uint32_t k = n > 4 ? 2 + random.below((n - 3) / 2) : 2;
+			while (std::gcd(n, k) != 1)
+				++k;
+			for (std::uint32_t i = 0; i < n; ++i) {
+				float angle = TAU<float> * (float)((std::uint64_t)i * k % n) / (float)n;
+				vertices.push_back(unitVector(angle) * (radius * random.range(0.85f, 1.0f)));
+			}
+		} break;
+		}
+
+		Transform2D model = randomModel(random, options);
+		os << "Polygon " << model << " width: " << random.range(1.0f, 4.0f)
+			<< " colors: [inner: " << randomColor(random) << " contour: " << randomColor(random) << " ] ";
+		writeVertices(os, vertices);
+		os << '\n';
+	}
+
+
+	void printUsage(const char* program) {
+		std::fprintf(stderr,
+			"Usage: %s [--preset 10k|100k|1m] [--count N] [--seed S]\n"
+			"          [--points W] [--lines W] [--polygons W] [--convex W] [--concave W] [--complex W]\n"
+			"          [--min-vertices N] [--max-vertices N] [--transforms P] [--extent E] [-o file.cgp]\n",
+			program);
+	}
+
+	bool parseOptions(int argc, char** argv, Options& options) {
+		for (int i = 1; i < argc; ++i) {
+			const char* arg = argv[i];
+			if (i + 1 >= argc) {
+				print_error("Missing value for option '%s'", arg);
+				return false;
+			}
+			const char* value = argv[++i];
+
+			if (std::strcmp(arg, "--preset") == 0) {
+				if (std::strcmp(value, "10k") == 0)
+					options.count = 10'000;
+				else if (std::strcmp(value, "100k") == 0)
+					options.count = 100'000;
+				else if (std::strcmp(value, "1m") == 0)
+					options.count = 1'000'000;
+				else {
+					print_error("Unknown preset '%s' (expected 10k, 100k or 1m)", value);
+					return false;
+				}
+			}
+			else if (std::strcmp(arg, "--count") == 0)
+				options.count = std::strtoull(value, nullptr, 10);
+			else if (std::strcmp(arg, "--seed") == 0)
+				options.seed = (std::uint32_t)std::strtoul(value, nullptr, 10);
+			else if (std::strcmp(arg, "--points") == 0)
+				options.points = std::atof(value);
+			else if (std::strcmp(arg, "--lines") == 0)
+				options.lines = std::atof(value);
+			else if (std::strcmp(arg, "--polygons") == 0)
+				options.polygons = std::atof(value);
+			else if (std::strcmp(arg, "--convex") == 0)
+				options.convex = std::atof(value);
+			else if (std::strcmp(arg, "--concave") == 0)
+				options.concave = std::atof(value);
+			else if (std::strcmp(arg, "--complex") == 0)
+				options.complex = std::atof(value);
+			else if (std::strcmp(arg, "--min-vertices") == 0)
+				options.minVertices = (std::uint32_t)std::strtoul(value, nullptr, 10);
+			else if (std::strcmp(arg, "--max-vertices") == 0)
+				options.maxVertices = (std::uint32_t)std::strtoul(value, nullptr, 10);
+			else if (std::strcmp(arg, "--transforms") == 0)
+				options.transforms = std::atof(value);
+			else if (std::strcmp(arg, "--extent") == 0)
+				options.extent = (float)std::atof(value);
+			else if (std::strcmp(arg, "-o") == 0 || std::strcmp(arg, "--output") == 0)
+				options.output = value;
+			else {
+				print_error("Unknown option '%s'", arg);
+				return false;
+			}
+		}
+
+		options.minVertices = std::clamp<std::uint32_t>(options.minVertices, 2, MAX_VERTICES);
+		options.maxVertices = std::clamp<std::uint32_t>(options.maxVertices, options.minVertices, MAX_VERTICES);
+		if (options.points < 0 || options.lines < 0 || options.polygons < 0 || options.points + options.lines + options.polygons <= 0) {
+			print_error("Item weights must be non-negative and not all zero.");
+			return false;
+		}
+		if (options.convex < 0 || options.concave < 0 || options.complex < 0 || options.convex + options.concave + options.complex <= 0) {
+			print_error("Polygon weights must be non-negative and not all zero.");
+			return false;
+		}
+		return true;
+	}
+
+} // namespace
+
+
+int main(int argc, char** argv)
+{
+	Options options;
+	if (!parseOptions(argc, argv, options)) {
+		printUsage(argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	std::vector<char> buffer(1 << 20); // escrita em blocos grandes (arquivos de centenas de MB)
+	std::ofstream ofs;
+	ofs.rdbuf()->pubsetbuf(buffer.data(), (std::streamsize)buffer.size());
+	ofs.open(options.output);
+	if (!ofs.is_open()) {
+		print_error("Failed to open output file: %s", options.output.c_str());
+		return EXIT_FAILURE;
+	}
+
+	Random random{ options.seed };
+	ArrayList<Vector2> vertices; // reutilizado entre os itens
+	const double weights[] = { options.points, options.lines, options.polygons };
+	std::uint64_t counts[3] = {};
+
+	for (std::uint64_t i = 0; i < options.count; ++i) {
+		std::size_t type = random.pick(weights);
+		++counts[type];
+		switch (type) {
+		case 0:
+			writePoint(ofs, random, options);
+			break;
+		case 1:
+			writeLine(ofs, random, options, vertices);
+			break;
+		default:
+			writePolygon(ofs, random, options, vertices);
+			break;
+		}
+	}
+
+	ofs.close();
+	if (!ofs) {
+		print_error("Failed to write %s", options.output.c_str());
+		return EXIT_FAILURE;
+	}
+	print_success("Wrote %llu items to %s (points: %llu, lines: %llu, polygons: %llu, seed: %u)",
+		(unsigned long long)options.count, options.output.c_str(),
+		(unsigned long long)counts[0], (unsigned long long)counts[1], (unsigned long long)counts[2], options.seed);
+	logging::flush();
+	return EXIT_SUCCESS;
+}